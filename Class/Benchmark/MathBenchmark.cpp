@@ -0,0 +1,1545 @@
+#include "MathBenchmark.h"
+#include "../../Collision.h"
+#include "../MyMath/BallSystem.h"
+#include "../MyMath/Broadphase/DynamicAABBTree.h"
+#include "../MyMath/Broadphase/LooseOctree.h"
+#include "../MyMath/Broadphase/SpatialHashGrid.h"
+#include "../MyMath/Broadphase/SweepAndPrune.h"
+#include "../MyMath/FrustumCulling.h"
+#include "../MyMath/MyCollision.h"
+#include "../MyMath/MyMath.h"
+#include "../MyMath/Narrowphase/ColliderRegistry.h"
+#include "../MyMath/Narrowphase/GJK.h"
+#include "../MyMath/Narrowphase/ParallelNarrowphase.h"
+#include "../MyMath/PreparedTriangle.h"
+#include "../MyMath/ProximityQuery.h"
+#include "../MyMath/ScreenProjector.h"
+#include "../MyMath/SegmentPacket.h"
+#include "../MyMath/SphereWireframe.h"
+#include "../MyMath/ThreadPool.h"
+#include "../MyMath/Transform.h"
+#include "../MyMath/TransformBatch.h"
+#include "../MyMath/TriangleBVH.h"
+#include "../MyMath/Vector/Vector3SoA.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <imgui.h>
+#include <limits>
+#include <numbers>
+#include <random>
+
+#if defined(_MSC_VER)
+#define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+namespace {
+
+// 計測の繰り返し回数
+const int kIterationCount = 200000;
+
+// 最適化で計算が消えないようにするための出力先
+volatile float gSink = 0.0f;
+
+// 計測する回数(最も短い時間を結果とする)
+const int kMeasureCount = 5;
+
+// 実行の前に戻す状態がない場合の reset
+struct NoReset {
+    void operator()() const { }
+};
+
+// 処理時間を計測する(ミリ秒)
+// 1回空回ししてから kMeasureCount 回計測し、最も短い時間を返す
+// reset は毎回の実行の前に呼ぶ(計測に含めない)。状態を書き換える処理を同じ条件で繰り返すのに使う
+template <typename Func, typename Reset = NoReset>
+double MeasureMilliseconds(Func func, Reset reset = {})
+{
+    reset();
+    func();
+
+    double minMilliseconds = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < kMeasureCount; ++i) {
+        reset();
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        auto end = std::chrono::high_resolution_clock::now();
+        minMilliseconds = std::min(minMilliseconds, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return minMilliseconds;
+}
+
+// 2つの行列の要素ごとの最大相対誤差
+float MaxRelativeError(const Matrix4x4& m1, const Matrix4x4& m2)
+{
+    float maxError = 0.0f;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            float scale = std::max(1.0f, std::fabs(m2.m[row][column]));
+            maxError = std::max(maxError, std::fabs(m1.m[row][column] - m2.m[row][column]) / scale);
+        }
+    }
+    return maxError;
+}
+
+// 乱数でアフィン行列を作成(isRigid なら拡縮なし)
+std::vector<Matrix4x4> MakeRandomMatrices(size_t count, bool isRigid)
+{
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    std::vector<Matrix4x4> matrices(count);
+    for (Matrix4x4& matrix : matrices) {
+        Vector3 scale = { 1.0f + distribution(randomEngine) * 0.25f, 1.0f + distribution(randomEngine) * 0.25f, 1.0f + distribution(randomEngine) * 0.25f };
+        if (isRigid) {
+            scale = { 1.0f, 1.0f, 1.0f };
+        }
+        matrix = makeAffineMatrix(
+            scale,
+            { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) },
+            { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) });
+    }
+    return matrices;
+}
+
+// 各成分が [-scale, scale) の乱数のベクトル
+Vector3 RandomVector(std::mt19937& randomEngine, float scale)
+{
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    return Vector3 { distribution(randomEngine) * scale, distribution(randomEngine) * scale, distribution(randomEngine) * scale };
+}
+
+// 行列関数(従来実装と最適化実装)の比較
+template <typename ReferenceFunc, typename OptimizedFunc>
+BenchmarkResult CompareMatrixFunction(const char* name, const std::vector<Matrix4x4>& matrices, ReferenceFunc reference, OptimizedFunc optimized)
+{
+    const size_t count = matrices.size();
+
+    BenchmarkResult result {};
+    result.name = name;
+
+    result.referenceMs = MeasureMilliseconds([&]() {
+        float sum = 0.0f;
+        for (int i = 0; i < kIterationCount; ++i) {
+            sum += reference(matrices[i % count], matrices[(i + 1) % count]).m[3][0];
+        }
+        gSink = sum;
+    });
+
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        float sum = 0.0f;
+        for (int i = 0; i < kIterationCount; ++i) {
+            sum += optimized(matrices[i % count], matrices[(i + 1) % count]).m[3][0];
+        }
+        gSink = sum;
+    });
+
+    for (size_t i = 0; i < count; ++i) {
+        Matrix4x4 expected = reference(matrices[i], matrices[(i + 1) % count]);
+        Matrix4x4 actual = optimized(matrices[i], matrices[(i + 1) % count]);
+        result.maxError = std::max(result.maxError, MaxRelativeError(actual, expected));
+    }
+
+    return result;
+}
+
+// 座標変換(1点ずつと一括)の比較
+BenchmarkResult CompareTransformCoords(const char* name, const Matrix4x4& matrix)
+{
+    const size_t kPointCount = 100000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    std::vector<Vector3> points(kPointCount);
+    for (Vector3& point : points) {
+        point = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) + 5.0f };
+    }
+
+    std::vector<Vector3> expected(kPointCount);
+    std::vector<Vector3> actual(kPointCount);
+
+    BenchmarkResult result {};
+    result.name = name;
+
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kPointCount; ++i) {
+            expected[i] = TransformCoord(points[i], matrix);
+        }
+    });
+
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        TransformCoords(points, actual, matrix);
+    });
+
+    for (size_t i = 0; i < kPointCount; ++i) {
+        result.maxError = std::max(result.maxError, Length(actual[i] - expected[i]));
+    }
+
+    return result;
+}
+
+// ヘッダに移す前と同じく関数呼び出しが残る版
+BENCHMARK_NOINLINE Vector3 SubtractOutOfLine(const Vector3& v1, const Vector3& v2)
+{
+    return Subtract(v1, v2);
+}
+
+BENCHMARK_NOINLINE float DotOutOfLine(const Vector3& v1, const Vector3& v2)
+{
+    return Dot(v1, v2);
+}
+
+// 小さな関数の呼び出し(関数呼び出しとインライン展開)の比較
+BenchmarkResult CompareInlineVectorFunctions()
+{
+    const size_t kPointCount = 100000;
+    const float kRadiusSq = 0.25f;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    std::vector<Vector3> points(kPointCount);
+    for (Vector3& point : points) {
+        point = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+    }
+
+    int referenceHitCount = 0;
+    int optimizedHitCount = 0;
+
+    BenchmarkResult result {};
+    result.name = "Vector Call Overhead";
+
+    // 隣り合う点同士の距離判定
+    result.referenceMs = MeasureMilliseconds([&]() {
+        referenceHitCount = 0;
+        for (size_t i = 0; i + 1 < kPointCount; ++i) {
+            Vector3 diff = SubtractOutOfLine(points[i + 1], points[i]);
+            referenceHitCount += DotOutOfLine(diff, diff) <= kRadiusSq ? 1 : 0;
+        }
+    });
+
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        optimizedHitCount = 0;
+        for (size_t i = 0; i + 1 < kPointCount; ++i) {
+            Vector3 diff = Subtract(points[i + 1], points[i]);
+            optimizedHitCount += Dot(diff, diff) <= kRadiusSq ? 1 : 0;
+        }
+    });
+
+    result.maxError = static_cast<float>(std::abs(referenceHitCount - optimizedHitCount));
+    return result;
+}
+
+// ベクトル配列の一括演算(AoSの1要素ずつとSoA)の比較
+BenchmarkResult CompareVector3SoA()
+{
+    const size_t kPointCount = 100000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    std::vector<Vector3> a(kPointCount);
+    std::vector<Vector3> b(kPointCount);
+    for (size_t i = 0; i < kPointCount; ++i) {
+        a[i] = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+        b[i] = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+    }
+
+    Vector3SoA soaA(a);
+    Vector3SoA soaB(b);
+    Vector3SoA soaOut(kPointCount);
+
+    std::vector<Vector3> expected(kPointCount);
+    std::vector<Vector3> actual(kPointCount);
+
+    BenchmarkResult result {};
+    result.name = "Vector3 SoA";
+
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kPointCount; ++i) {
+            expected[i] = Normalize(Cross(a[i], b[i]));
+        }
+    });
+
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        Cross(soaA, soaB, soaOut);
+        Normalize(soaOut, soaOut);
+    });
+
+    soaOut.ToAoS(actual);
+    for (size_t i = 0; i < kPointCount; ++i) {
+        result.maxError = std::max(result.maxError, Length(actual[i] - expected[i]));
+    }
+
+    return result;
+}
+
+// 球のワイヤーフレームの頂点計算(描画ごとに三角関数を計算する版とキャッシュした単位球を変換する版)の比較
+BenchmarkResult CompareSphereWireframe()
+{
+    const size_t kSphereCount = 1000;
+    const uint32_t kSubDivision = 20;
+    const float kLongEvery = 2.0f * std::numbers::pi_v<float> / static_cast<float>(kSubDivision);
+    const float kLatEvery = std::numbers::pi_v<float> / static_cast<float>(kSubDivision);
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    std::vector<Sphere> spheres(kSphereCount);
+    for (Sphere& sphere : spheres) {
+        sphere = { { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) }, 0.5f };
+    }
+
+    Matrix4x4 viewMatrix = MakeTranslateMatrix({ 0.0f, 0.0f, 10.0f });
+    Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, float(1280) / float(720), 0.1f, 100.0f);
+    ScreenProjector projector(Multiply(viewMatrix, projectionMatrix), MakeViewportMatrix(0, 0, 1280, 720, 0, 1));
+
+    const SphereWireframe& wireframe = GetSphereWireframe(kSubDivision);
+
+    std::vector<Vector3> expected(kSubDivision * kSubDivision * 3);
+    std::vector<Vector3> actual(wireframe.vertices.size());
+
+    BenchmarkResult result {};
+    result.name = "Sphere Wireframe";
+
+    // 1セルにつき a, b, c の3頂点を計算して射影する
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (const Sphere& sphere : spheres) {
+            for (uint32_t latIndex = 0; latIndex < kSubDivision; ++latIndex) {
+                float lat = -std::numbers::pi_v<float> / 2.0f + kLatEvery * latIndex;
+                for (uint32_t lonIndex = 0; lonIndex < kSubDivision; ++lonIndex) {
+                    float lon = kLongEvery * lonIndex;
+                    Vector3* cell = &expected[(latIndex * kSubDivision + lonIndex) * 3];
+                    cell[0] = { std::cos(lat) * std::cos(lon), std::sin(lat), std::cos(lat) * std::sin(lon) };
+                    cell[1] = { std::cos(lat + kLatEvery) * std::cos(lon), std::sin(lat + kLatEvery), std::cos(lat + kLatEvery) * std::sin(lon) };
+                    cell[2] = { std::cos(lat) * std::cos(lon + kLongEvery), std::sin(lat), std::cos(lat) * std::sin(lon + kLongEvery) };
+                    for (int i = 0; i < 3; ++i) {
+                        cell[i] = Add(Multiply(sphere.radius, cell[i]), sphere.center);
+                    }
+                }
+            }
+            projector.ProjectPoints(expected, expected);
+        }
+    });
+
+    // 共有頂点を拡大・平行移動・射影をまとめた行列で1回ずつ変換する
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (const Sphere& sphere : spheres) {
+            Matrix4x4 sphereMatrix = MakeScaleMatrix({ sphere.radius, sphere.radius, sphere.radius });
+            sphereMatrix.m[3][0] = sphere.center.x;
+            sphereMatrix.m[3][1] = sphere.center.y;
+            sphereMatrix.m[3][2] = sphere.center.z;
+            TransformCoords(wireframe.vertices, actual, Multiply(sphereMatrix, projector.worldToScreenMatrix));
+        }
+    });
+
+    // 最後の球のリング上の頂点(セルの頂点a)を比較する
+    for (uint32_t latIndex = 1; latIndex < kSubDivision; ++latIndex) {
+        for (uint32_t lonIndex = 0; lonIndex < kSubDivision; ++lonIndex) {
+            const Vector3& a = expected[(latIndex * kSubDivision + lonIndex) * 3];
+            const Vector3& b = actual[1 + (latIndex - 1) * kSubDivision + lonIndex];
+            result.maxError = std::max(result.maxError, Length(a - b));
+        }
+    }
+
+    return result;
+}
+
+// 親子関係の合成(オイラー角から4x4行列を作って掛ける版とクォータニオンで合成する版)の比較
+BenchmarkResult CompareTransformCompose()
+{
+    const size_t kNodeCount = 100000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    // 回転は毎フレーム変わるアニメーションを想定し、オイラー角とクォータニオンの両方で持つ
+    std::vector<Vector3> rotates(kNodeCount);
+    std::vector<Vector3> translates(kNodeCount);
+    std::vector<Transform> locals(kNodeCount);
+    for (size_t i = 0; i < kNodeCount; ++i) {
+        rotates[i] = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+        translates[i] = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+        locals[i] = MakeTransform({ 1.0f, 1.0f, 1.0f }, rotates[i], translates[i]);
+    }
+
+    const Vector3 kParentScale = { 2.0f, 2.0f, 2.0f };
+    const Vector3 kParentRotate = { 0.3f, 0.5f, 0.1f };
+    const Vector3 kParentTranslate = { 1.0f, 0.0f, 3.0f };
+    Matrix4x4 parentMatrix = makeAffineMatrix(kParentScale, kParentRotate, kParentTranslate);
+    Transform parent = MakeTransform(kParentScale, kParentRotate, kParentTranslate);
+
+    std::vector<Matrix4x4> expected(kNodeCount);
+    std::vector<Transform> actual(kNodeCount);
+
+    BenchmarkResult result {};
+    result.name = "Transform Compose";
+
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kNodeCount; ++i) {
+            expected[i] = Multiply(makeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotates[i], translates[i]), parentMatrix);
+        }
+    });
+
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kNodeCount; ++i) {
+            actual[i] = Multiply(locals[i], parent);
+        }
+    });
+
+    for (size_t i = 0; i < kNodeCount; ++i) {
+        result.maxError = std::max(result.maxError, MaxRelativeError(expected[i], MakeAffineMatrix(actual[i])));
+    }
+
+    return result;
+}
+
+// 大量の球の描画前処理(全部射影する版と視錐台カリングしてから射影する版)の比較
+BenchmarkResult CompareFrustumCulling()
+{
+    const size_t kSphereCount = 100000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> positionDistribution(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> radiusDistribution(0.1f, 2.0f);
+
+    std::vector<Sphere> spheres(kSphereCount);
+    for (Sphere& sphere : spheres) {
+        sphere = { { positionDistribution(randomEngine), positionDistribution(randomEngine) * 0.2f, positionDistribution(randomEngine) }, radiusDistribution(randomEngine) };
+    }
+
+    Matrix4x4 viewMatrix = Inverse(makeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.26f, 0.0f, 0.0f }, { 0.0f, 1.9f, -6.49f }), MatrixType::Rigid);
+    Matrix4x4 viewProjectionMatrix = Multiply(viewMatrix, MakePerspectiveFovMatrix(0.45f, float(1280) / float(720), 0.1f, 100.0f));
+    ScreenProjector projector(viewProjectionMatrix, MakeViewportMatrix(0, 0, 1280, 720, 0, 1));
+    Frustum frustum = MakeFrustum(viewProjectionMatrix);
+
+    std::vector<Vector3> screenPoints(GetSphereWireframe(20).vertices.size());
+    std::vector<uint8_t> visibleMask(kSphereCount);
+
+    // DrawSphere の線を引く前までの処理(LODの選択と頂点の射影)
+    auto projectSphere = [&](const Sphere& sphere) {
+        uint32_t subdivision = projector.SelectCircleSegmentCount(projector.ScreenRadius(sphere), 4, 20);
+        const SphereWireframe& wireframe = GetSphereWireframe(subdivision);
+
+        Matrix4x4 sphereMatrix = MakeScaleMatrix({ sphere.radius, sphere.radius, sphere.radius });
+        sphereMatrix.m[3][0] = sphere.center.x;
+        sphereMatrix.m[3][1] = sphere.center.y;
+        sphereMatrix.m[3][2] = sphere.center.z;
+        TransformCoords(wireframe.vertices, screenPoints, Multiply(sphereMatrix, projector.worldToScreenMatrix));
+    };
+
+    BenchmarkResult result {};
+    result.name = "Frustum Culling";
+
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (const Sphere& sphere : spheres) {
+            projectSphere(sphere);
+        }
+    });
+
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        CullSpheres(spheres, frustum, visibleMask);
+        for (size_t i = 0; i < kSphereCount; ++i) {
+            if (visibleMask[i]) {
+                projectSphere(spheres[i]);
+            }
+        }
+    });
+
+    // 1つずつ判定した結果との食い違いの数
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < kSphereCount; ++i) {
+        mismatchCount += (visibleMask[i] != 0) != IsCollision(spheres[i], frustum) ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// 衝突する球の組の検出(総当たりと空間ハッシュ)の比較
+BenchmarkResult CompareSpatialHash()
+{
+    const size_t kSphereCount = 3000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> positionDistribution(-12.0f, 12.0f);
+    std::uniform_real_distribution<float> radiusDistribution(0.1f, 0.5f);
+
+    std::vector<Sphere> spheres(kSphereCount);
+    for (Sphere& sphere : spheres) {
+        sphere = { { positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine) }, radiusDistribution(randomEngine) };
+    }
+
+    // 前のフレームの位置で登録しておき、少し動かす
+    SpatialHashGrid grid;
+    grid.Build(spheres);
+    const SpatialHashGrid initialGrid = grid;
+    for (Sphere& sphere : spheres) {
+        sphere.center.x += 0.05f;
+    }
+    std::vector<CollisionPair> pairs;
+
+    BenchmarkResult result {};
+    result.name = "Spatial Hash";
+
+    // 総当たり
+    size_t referenceHitCount = 0;
+    result.referenceMs = MeasureMilliseconds([&]() {
+        referenceHitCount = 0;
+        for (size_t i = 0; i < kSphereCount; ++i) {
+            for (size_t j = i + 1; j < kSphereCount; ++j) {
+                referenceHitCount += isCollision(spheres[i], spheres[j]) ? 1 : 0;
+            }
+        }
+    });
+
+    // 登録を更新してから候補の組だけを判定する
+    size_t optimizedHitCount = 0;
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        grid.Update(spheres);
+        grid.FindPairs(pairs);
+        optimizedHitCount = 0;
+        for (const CollisionPair& pair : pairs) {
+            optimizedHitCount += isCollision(spheres[pair.first], spheres[pair.second]) ? 1 : 0;
+        }
+    }, [&]() { grid = initialGrid; });
+
+    // 総当たりとの衝突数の差
+    result.maxError = static_cast<float>(referenceHitCount > optimizedHitCount ? referenceHitCount - optimizedHitCount : optimizedHitCount - referenceHitCount);
+
+    return result;
+}
+
+// 一部だけ動く AABB の組の検出(総当たりと動的 AABB 木)の比較
+BenchmarkResult CompareDynamicAABBTree()
+{
+    const size_t kBoxCount = 5000;
+    // 1フレームに動くのは100個に1個
+    const size_t kMoveInterval = 100;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> positionDistribution(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.1f, 1.0f);
+
+    std::vector<AABB> boxes(kBoxCount);
+    for (AABB& box : boxes) {
+        Vector3 center = { positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine) };
+        float size = sizeDistribution(randomEngine);
+        box = { { center.x - size, center.y - size, center.z - size }, { center.x + size, center.y + size, center.z + size } };
+    }
+
+    DynamicAABBTree tree;
+    std::vector<int32_t> proxyIds(kBoxCount);
+    for (uint32_t i = 0; i < kBoxCount; ++i) {
+        proxyIds[i] = tree.CreateProxy(boxes[i], i);
+    }
+    std::vector<CollisionPair> pairs;
+    tree.FindMovedPairs(pairs);
+    const DynamicAABBTree initialTree = tree;
+
+    // 一部だけ動かす
+    Vector3 displacement = { 0.3f, 0.0f, 0.0f };
+    for (size_t i = 0; i < kBoxCount; i += kMoveInterval) {
+        boxes[i].min = boxes[i].min + displacement;
+        boxes[i].max = boxes[i].max + displacement;
+    }
+
+    BenchmarkResult result {};
+    result.name = "Dynamic AABB Tree";
+
+    // 総当たり
+    size_t hitCount = 0;
+    result.referenceMs = MeasureMilliseconds([&]() {
+        hitCount = 0;
+        for (size_t i = 0; i < kBoxCount; ++i) {
+            for (size_t j = i + 1; j < kBoxCount; ++j) {
+                hitCount += IsCollision(boxes[i], boxes[j]) ? 1 : 0;
+            }
+        }
+    });
+
+    // 動いたものだけ木を更新し、それが関わる組だけを調べる
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kBoxCount; i += kMoveInterval) {
+            tree.MoveProxy(proxyIds[i], boxes[i], displacement);
+        }
+        tree.FindMovedPairs(pairs);
+    }, [&]() { tree = initialTree; });
+
+    // 総当たりで重なった組のうち、木の候補から漏れた数
+    auto pairLess = [](const CollisionPair& pair1, const CollisionPair& pair2) {
+        return pair1.first != pair2.first ? pair1.first < pair2.first : pair1.second < pair2.second;
+    };
+    tree.FindPairs(pairs);
+    std::sort(pairs.begin(), pairs.end(), pairLess);
+    size_t missCount = 0;
+    for (uint32_t i = 0; i < kBoxCount; ++i) {
+        for (uint32_t j = i + 1; j < kBoxCount; ++j) {
+            if (IsCollision(boxes[i], boxes[j]) && !std::binary_search(pairs.begin(), pairs.end(), CollisionPair { i, j }, pairLess)) {
+                ++missCount;
+            }
+        }
+    }
+    result.maxError = static_cast<float>(missCount);
+
+    return result;
+}
+
+// 全部が少しずつ動く AABB の組の検出(総当たりとスイープ&プルーン)の比較
+BenchmarkResult CompareSweepAndPrune()
+{
+    const size_t kBoxCount = 3000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> positionDistribution(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.1f, 1.0f);
+    std::uniform_real_distribution<float> moveDistribution(-0.05f, 0.05f);
+
+    std::vector<AABB> boxes(kBoxCount);
+    for (AABB& box : boxes) {
+        Vector3 center = { positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine) };
+        float size = sizeDistribution(randomEngine);
+        box = { { center.x - size, center.y - size, center.z - size }, { center.x + size, center.y + size, center.z + size } };
+    }
+
+    SweepAndPrune sweepAndPrune;
+    sweepAndPrune.Build(boxes);
+    const SweepAndPrune initialSweepAndPrune = sweepAndPrune;
+
+    // すべて少しずつ動かす
+    for (AABB& box : boxes) {
+        Vector3 displacement = { moveDistribution(randomEngine), moveDistribution(randomEngine), moveDistribution(randomEngine) };
+        box.min = box.min + displacement;
+        box.max = box.max + displacement;
+    }
+
+    BenchmarkResult result {};
+    result.name = "Sweep And Prune";
+
+    // 総当たり
+    size_t hitCount = 0;
+    result.referenceMs = MeasureMilliseconds([&]() {
+        hitCount = 0;
+        for (size_t i = 0; i < kBoxCount; ++i) {
+            for (size_t j = i + 1; j < kBoxCount; ++j) {
+                hitCount += IsCollision(boxes[i], boxes[j]) ? 1 : 0;
+            }
+        }
+    });
+
+    // 端点の並べ直しと、変化した組の検出
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        sweepAndPrune.Update(boxes);
+    }, [&]() { sweepAndPrune = initialSweepAndPrune; });
+
+    // 総当たりとの重なっている組の数の差
+    size_t pairCount = sweepAndPrune.GetPairCount();
+    result.maxError = static_cast<float>(hitCount > pairCount ? hitCount - pairCount : pairCount - hitCount);
+
+    return result;
+}
+
+// 地形と線分の判定(全三角形と調べる版と BVH で絞り込む版)の比較
+BenchmarkResult CompareTriangleBVH()
+{
+    // 起伏のある地形(128 x 128 マス、1マスに三角形2つ)
+    const int kGridSize = 128;
+    const size_t kSegmentCount = 64;
+
+    auto height = [](int x, int z) {
+        return std::sin(static_cast<float>(x) * 0.05f) * 3.0f + std::cos(static_cast<float>(z) * 0.07f) * 2.0f;
+    };
+
+    std::vector<Triangle> triangles;
+    triangles.reserve(kGridSize * kGridSize * 2);
+    for (int z = 0; z < kGridSize; ++z) {
+        for (int x = 0; x < kGridSize; ++x) {
+            Vector3 p00 = { static_cast<float>(x), height(x, z), static_cast<float>(z) };
+            Vector3 p10 = { static_cast<float>(x + 1), height(x + 1, z), static_cast<float>(z) };
+            Vector3 p01 = { static_cast<float>(x), height(x, z + 1), static_cast<float>(z + 1) };
+            Vector3 p11 = { static_cast<float>(x + 1), height(x + 1, z + 1), static_cast<float>(z + 1) };
+            triangles.push_back({ { p00, p01, p10 } });
+            triangles.push_back({ { p10, p01, p11 } });
+        }
+    }
+
+    TriangleBVH bvh;
+    bvh.Build(triangles);
+
+    // 地形の上から斜め下に向かう線分
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> positionDistribution(0.0f, static_cast<float>(kGridSize));
+    std::uniform_real_distribution<float> directionDistribution(-20.0f, 20.0f);
+    std::vector<Segment> segments(kSegmentCount);
+    for (Segment& segment : segments) {
+        segment.origin = { positionDistribution(randomEngine), 8.0f, positionDistribution(randomEngine) };
+        segment.diff = { directionDistribution(randomEngine), -16.0f, directionDistribution(randomEngine) };
+    }
+
+    BenchmarkResult result {};
+    result.name = "Triangle BVH";
+
+    // 全三角形との判定
+    std::vector<uint8_t> referenceHits(kSegmentCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSegmentCount; ++i) {
+            referenceHits[i] = 0;
+            for (const Triangle& triangle : triangles) {
+                if (IsCollision(triangle, segments[i])) {
+                    referenceHits[i] = 1;
+                }
+            }
+        }
+    });
+
+    std::vector<uint8_t> optimizedHits(kSegmentCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSegmentCount; ++i) {
+            TriangleHit hit;
+            optimizedHits[i] = bvh.FindFirstHit(segments[i], hit) ? 1 : 0;
+        }
+    });
+
+    // 当たり判定の食い違いの数
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < kSegmentCount; ++i) {
+        mismatchCount += referenceHits[i] != optimizedHits[i] ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// 三角形と線分の判定(毎回法線を求める版と前計算した三角形を使う版)の比較
+BenchmarkResult ComparePreparedTriangle()
+{
+    const size_t kTriangleCount = 100000;
+    const size_t kSegmentCount = 8;
+
+    std::mt19937 randomEngine(12345);
+
+    std::vector<Triangle> triangles(kTriangleCount);
+    for (Triangle& triangle : triangles) {
+        Vector3 center = RandomVector(randomEngine, 4.0f);
+        triangle = { { center + RandomVector(randomEngine, 1.0f), center + RandomVector(randomEngine, 1.0f), center + RandomVector(randomEngine, 1.0f) } };
+    }
+    std::vector<PreparedTriangle> preparedTriangles(kTriangleCount);
+    MakePreparedTriangles(triangles, preparedTriangles);
+
+    std::vector<Segment> segments(kSegmentCount);
+    for (Segment& segment : segments) {
+        segment = { RandomVector(randomEngine, 4.0f), RandomVector(randomEngine, 8.0f) };
+    }
+
+    BenchmarkResult result {};
+    result.name = "Triangle Segment";
+
+    std::vector<uint8_t> referenceHits(kTriangleCount * kSegmentCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSegmentCount; ++i) {
+            for (size_t j = 0; j < kTriangleCount; ++j) {
+                referenceHits[i * kTriangleCount + j] = IsCollision(triangles[j], segments[i]) ? 1 : 0;
+            }
+        }
+    });
+
+    std::vector<uint8_t> optimizedHits(kTriangleCount * kSegmentCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSegmentCount; ++i) {
+            IntersectSegment(preparedTriangles, segments[i], std::span<uint8_t>(optimizedHits).subspan(i * kTriangleCount, kTriangleCount));
+        }
+    });
+
+    // 当たり判定の食い違いの数
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < referenceHits.size(); ++i) {
+        mismatchCount += referenceHits[i] != optimizedHits[i] ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// AABB と線分の判定(1つずつと AABB をパケットにまとめる版)の比較
+BenchmarkResult CompareSegmentPacket()
+{
+    const size_t kAABBCount = 100000;
+    const size_t kSegmentCount = 8;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 0.5 刻みに揃える(線分の始点が AABB の面の上に乗るケースを作る)
+    auto snap = [](const Vector3& v) {
+        return Vector3 { std::round(v.x * 2.0f) * 0.5f, std::round(v.y * 2.0f) * 0.5f, std::round(v.z * 2.0f) * 0.5f };
+    };
+
+    std::vector<AABB> aabbs(kAABBCount);
+    for (size_t i = 0; i < kAABBCount; ++i) {
+        Vector3 center = RandomVector(randomEngine, 8.0f);
+        Vector3 extent = { std::fabs(distribution(randomEngine)), std::fabs(distribution(randomEngine)), std::fabs(distribution(randomEngine)) };
+        aabbs[i] = { center - extent, center + extent };
+        if (i % 2 == 0) {
+            aabbs[i] = { snap(aabbs[i].min), snap(aabbs[i].max) };
+        }
+    }
+    aabbs[0] = { { -2.0f, -2.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+    // AABB はあらかじめパケットにまとめておく
+    std::vector<AABBPacket> packets;
+    for (size_t i = 0; i < kAABBCount; i += kPacketWidth) {
+        packets.push_back(MakeAABBPacket(std::span<const AABB>(aabbs).subspan(i)));
+    }
+
+    std::vector<Segment> segments(kSegmentCount);
+    for (Segment& segment : segments) {
+        segment = { RandomVector(randomEngine, 8.0f), RandomVector(randomEngine, 16.0f) };
+    }
+
+    // 方向の成分が0で、始点が面の上にある線分(その軸では t を制限しない)
+    segments[0] = { { -0.5f, 1.0f, 2.0f }, { -0.5f, 0.0f, -1.0f } };
+    for (size_t i = 1; i < kSegmentCount / 2; ++i) {
+        segments[i].origin = snap(segments[i].origin);
+        segments[i].diff = snap(segments[i].diff);
+        float* components[] = { &segments[i].diff.x, &segments[i].diff.y, &segments[i].diff.z };
+        *components[i % 3] = 0.0f;
+    }
+
+    BenchmarkResult result {};
+    result.name = "Segment Packet";
+
+    std::vector<uint8_t> referenceHits(kAABBCount * kSegmentCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSegmentCount; ++i) {
+            for (size_t j = 0; j < kAABBCount; ++j) {
+                referenceHits[i * kAABBCount + j] = IsCollision(aabbs[j], segments[i]) ? 1 : 0;
+            }
+        }
+    });
+
+    std::vector<uint8_t> optimizedHits(kAABBCount * kSegmentCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        float entryT[kPacketWidth];
+        for (size_t i = 0; i < kSegmentCount; ++i) {
+            PreparedSegment segment = MakePreparedSegment(segments[i]);
+            for (size_t j = 0; j < packets.size(); ++j) {
+                unsigned int hitBits = IntersectAABBPacket(segment, packets[j], entryT);
+                for (size_t lane = 0; lane < packets[j].count; ++lane) {
+                    optimizedHits[i * kAABBCount + j * kPacketWidth + lane] = static_cast<uint8_t>((hitBits >> lane) & 1u);
+                }
+            }
+        }
+    });
+
+    // 当たり判定の食い違いの数
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < referenceHits.size(); ++i) {
+        mismatchCount += referenceHits[i] != optimizedHits[i] ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// 球と平面の跳ね返り(判定後に法線を求め直す版と接触情報を使う版)の比較
+BenchmarkResult CompareSphereContact()
+{
+    const size_t kSphereCount = 100000;
+    const float kRestitution = 0.8f;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 球ごとに別の平面(地形の面など)と判定する
+    std::vector<Sphere> spheres(kSphereCount);
+    std::vector<Plane> planes(kSphereCount);
+    std::vector<Vector3> velocities(kSphereCount);
+    for (size_t i = 0; i < kSphereCount; ++i) {
+        spheres[i] = { RandomVector(randomEngine, 1.0f), 0.5f };
+        planes[i] = { Normalize(RandomVector(randomEngine, 1.0f)), distribution(randomEngine) * 0.5f };
+        velocities[i] = RandomVector(randomEngine, 3.0f);
+    }
+
+    BenchmarkResult result {};
+    result.name = "Sphere Contact";
+
+    // 判定のあとで反射ベクトルと法線への射影を求め直す(main.cpp の以前の処理)
+    std::vector<Vector3> referenceVelocities(kSphereCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSphereCount; ++i) {
+            referenceVelocities[i] = velocities[i];
+            if (IsCollision(spheres[i], planes[i])) {
+                Vector3 normal = Normalize(planes[i].normal);
+                Vector3 reflected = velocities[i] - normal * (2.0f * Dot(velocities[i], normal));
+                Vector3 projectToNormal = Project(reflected, planes[i].normal);
+                referenceVelocities[i] = projectToNormal * kRestitution + (reflected - projectToNormal);
+            }
+        }
+    });
+
+    // 接触法線をそのまま使う
+    std::vector<Vector3> optimizedVelocities(kSphereCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSphereCount; ++i) {
+            optimizedVelocities[i] = velocities[i];
+            Contact contact;
+            if (Collide(spheres[i], planes[i], contact)) {
+                Vector3 normalVelocity = contact.normal * Dot(velocities[i], contact.normal);
+                optimizedVelocities[i] = normalVelocity * -kRestitution + (velocities[i] - normalVelocity);
+            }
+        }
+    });
+
+    for (size_t i = 0; i < kSphereCount; ++i) {
+        Vector3 diff = referenceVelocities[i] - optimizedVelocities[i];
+        result.maxError = std::max(result.maxError, std::max(std::fabs(diff.x), std::max(std::fabs(diff.y), std::fabs(diff.z))));
+    }
+
+    return result;
+}
+
+// 動く球と AABB の接触時刻(移動を分割して判定する版と連続判定)の比較
+BenchmarkResult CompareSweptSphere()
+{
+    const size_t kSphereCount = 20000;
+    // 移動後の位置だけで判定する場合に、すり抜けないよう分割する数(移動量 / 分割数 が半径程度)
+    const int kSubstepCount = 32;
+    // 当たった区間をさらに二分探索する回数
+    const int kBisectionCount = 16;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 小さくて速い球と、球ごとに別の AABB
+    std::vector<Sphere> spheres(kSphereCount);
+    std::vector<Vector3> displacements(kSphereCount);
+    std::vector<AABB> boxes(kSphereCount);
+    for (size_t i = 0; i < kSphereCount; ++i) {
+        spheres[i] = { RandomVector(randomEngine, 2.0f), 0.05f };
+        displacements[i] = RandomVector(randomEngine, 2.0f);
+        Vector3 center = RandomVector(randomEngine, 0.5f);
+        Vector3 halfSize = { 0.1f + std::fabs(distribution(randomEngine)) * 0.4f, 0.1f + std::fabs(distribution(randomEngine)) * 0.4f, 0.1f + std::fabs(distribution(randomEngine)) * 0.4f };
+        boxes[i] = { center - halfSize, center + halfSize };
+    }
+
+    BenchmarkResult result {};
+    result.name = "Swept Sphere";
+
+    // 移動を分割して各位置で判定し、最初に当たった区間を二分探索する
+    std::vector<float> referenceTimes(kSphereCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSphereCount; ++i) {
+            referenceTimes[i] = -1.0f;
+            for (int step = 0; step <= kSubstepCount; ++step) {
+                float t = static_cast<float>(step) / kSubstepCount;
+                if (!IsCollision(Sphere { spheres[i].center + displacements[i] * t, spheres[i].radius }, boxes[i])) {
+                    continue;
+                }
+
+                float low = std::max(0.0f, static_cast<float>(step - 1) / kSubstepCount);
+                float high = t;
+                if (step > 0) {
+                    for (int j = 0; j < kBisectionCount; ++j) {
+                        float middle = (low + high) * 0.5f;
+                        if (IsCollision(Sphere { spheres[i].center + displacements[i] * middle, spheres[i].radius }, boxes[i])) {
+                            high = middle;
+                        } else {
+                            low = middle;
+                        }
+                    }
+                }
+                referenceTimes[i] = high;
+                break;
+            }
+        }
+    });
+
+    std::vector<float> optimizedTimes(kSphereCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kSphereCount; ++i) {
+            Contact contact;
+            optimizedTimes[i] = SweepSphere(spheres[i], displacements[i], boxes[i], contact) ? contact.t : -1.0f;
+        }
+    });
+
+    // 分割した判定は角を掠める衝突を見逃すことがあるので、両方で当たったものの時刻の差を誤差とする
+    for (size_t i = 0; i < kSphereCount; ++i) {
+        if (referenceTimes[i] >= 0.0f && optimizedTimes[i] >= 0.0f) {
+            result.maxError = std::max(result.maxError, std::fabs(referenceTimes[i] - optimizedTimes[i]));
+        }
+    }
+
+    return result;
+}
+
+// OBB 同士の判定(頂点を射影する版と半径を射影する版)の比較
+BenchmarkResult CompareOBBCollision()
+{
+    const size_t kPairCount = 50000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 回転した箱同士(半分程度が衝突する配置)
+    std::vector<OBB> obbs(kPairCount * 2);
+    for (OBB& obb : obbs) {
+        AABB localAABB = { { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } };
+        Vector3 scale = { 0.5f + std::fabs(distribution(randomEngine)), 0.5f + std::fabs(distribution(randomEngine)), 0.5f + std::fabs(distribution(randomEngine)) };
+        obb = MakeOBB(localAABB, makeAffineMatrix(scale, RandomVector(randomEngine, 3.14f), RandomVector(randomEngine, 1.2f)));
+    }
+
+    BenchmarkResult result {};
+    result.name = "OBB Collision";
+
+    // 8頂点を15軸すべてに射影して区間を比べる
+    std::vector<uint8_t> referenceResults(kPairCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kPairCount; ++i) {
+            const OBB* pair[2] = { &obbs[i * 2], &obbs[i * 2 + 1] };
+            Vector3 vertices[2][8];
+            for (int k = 0; k < 2; ++k) {
+                const OBB& obb = *pair[k];
+                for (int v = 0; v < 8; ++v) {
+                    vertices[k][v] = obb.center
+                        + obb.orientations[0] * ((v & 1) ? obb.size.x : -obb.size.x)
+                        + obb.orientations[1] * ((v & 2) ? obb.size.y : -obb.size.y)
+                        + obb.orientations[2] * ((v & 4) ? obb.size.z : -obb.size.z);
+                }
+            }
+
+            Vector3 axes[15];
+            for (int a = 0; a < 3; ++a) {
+                axes[a] = pair[0]->orientations[a];
+                axes[3 + a] = pair[1]->orientations[a];
+                for (int b = 0; b < 3; ++b) {
+                    axes[6 + a * 3 + b] = Cross(pair[0]->orientations[a], pair[1]->orientations[b]);
+                }
+            }
+
+            bool isCollision = true;
+            for (const Vector3& axis : axes) {
+                float min[2] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+                float max[2] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+                for (int k = 0; k < 2; ++k) {
+                    for (const Vector3& vertex : vertices[k]) {
+                        float projection = Dot(vertex, axis);
+                        min[k] = std::min(min[k], projection);
+                        max[k] = std::max(max[k], projection);
+                    }
+                }
+                if (max[0] < min[1] || max[1] < min[0]) {
+                    isCollision = false;
+                    break;
+                }
+            }
+            referenceResults[i] = isCollision ? 1 : 0;
+        }
+    });
+
+    std::vector<uint8_t> optimizedResults(kPairCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kPairCount; ++i) {
+            optimizedResults[i] = IsCollision(obbs[i * 2], obbs[i * 2 + 1]) ? 1 : 0;
+        }
+    });
+
+    // 食い違いの数
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < kPairCount; ++i) {
+        mismatchCount += referenceResults[i] != optimizedResults[i] ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// 種類の混ざった形状の組の判定(1組ずつ関数を引く版と種類ごとにまとめる版)の比較
+BenchmarkResult CompareColliderDispatch()
+{
+    const size_t kColliderCount = 4000;
+    const size_t kPairCount = 200000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 6種類の形状が混ざった場面
+    ColliderRegistry registry;
+    for (size_t i = 0; i < kColliderCount; ++i) {
+        Vector3 center = RandomVector(randomEngine, 3.0f);
+        switch (static_cast<ShapeType>(i % kShapeTypeCount)) {
+        case ShapeType::Sphere:
+            registry.Add(Sphere { center, 0.5f });
+            break;
+        case ShapeType::AABB:
+            registry.Add(AABB { center - Vector3 { 0.4f, 0.4f, 0.4f }, center + Vector3 { 0.4f, 0.4f, 0.4f } });
+            break;
+        case ShapeType::OBB:
+            registry.Add(MakeOBB({ { -0.4f, -0.4f, -0.4f }, { 0.4f, 0.4f, 0.4f } }, makeAffineMatrix({ 1.0f, 1.0f, 1.0f }, RandomVector(randomEngine, 3.14f), center)));
+            break;
+        case ShapeType::Plane:
+            registry.Add(Plane { Normalize(RandomVector(randomEngine, 1.0f)), distribution(randomEngine) * 3.0f });
+            break;
+        case ShapeType::Triangle:
+            registry.Add(Triangle { { center + RandomVector(randomEngine, 0.5f), center + RandomVector(randomEngine, 0.5f), center + RandomVector(randomEngine, 0.5f) } });
+            break;
+        case ShapeType::Segment:
+            registry.Add(Segment { center, RandomVector(randomEngine, 1.0f) });
+            break;
+        }
+    }
+
+    // 候補の組はブロードフェーズの出力のように種類が混ざった順で並ぶ
+    std::uniform_int_distribution<uint32_t> indexDistribution(0, static_cast<uint32_t>(kColliderCount - 1));
+    std::vector<CollisionPair> pairs(kPairCount);
+    for (CollisionPair& pair : pairs) {
+        uint32_t first = indexDistribution(randomEngine);
+        uint32_t second = indexDistribution(randomEngine);
+        pair = { std::min(first, second), std::max(first, second) };
+    }
+
+    BenchmarkResult result {};
+    result.name = "Collider Dispatch";
+
+    // 組ごとに判定関数を引いて呼ぶ
+    std::vector<uint8_t> referenceResults(kPairCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kPairCount; ++i) {
+            referenceResults[i] = registry.Test(pairs[i].first, pairs[i].second) ? 1 : 0;
+        }
+    });
+
+    // 種類の組み合わせごとにまとめてから判定する
+    std::vector<uint8_t> optimizedResults(kPairCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        registry.TestPairs(pairs, optimizedResults);
+    });
+
+    // 食い違いの数
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < kPairCount; ++i) {
+        mismatchCount += referenceResults[i] != optimizedResults[i] ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// 候補の組の判定(ワーカー1つとスレッドプールで分担する版)の比較
+BenchmarkResult CompareParallelNarrowphase()
+{
+    const size_t kColliderCount = 30000;
+    const size_t kPairCount = 1000000;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 球・AABB・平面の場面
+    ColliderRegistry registry;
+    for (size_t i = 0; i < kColliderCount; ++i) {
+        Vector3 center = RandomVector(randomEngine, 3.0f);
+        switch (i % 3) {
+        case 0:
+            registry.Add(Sphere { center, 0.5f });
+            break;
+        case 1:
+            registry.Add(AABB { center - Vector3 { 0.4f, 0.4f, 0.4f }, center + Vector3 { 0.4f, 0.4f, 0.4f } });
+            break;
+        default:
+            registry.Add(Plane { Normalize(RandomVector(randomEngine, 1.0f)), distribution(randomEngine) * 3.0f });
+            break;
+        }
+    }
+
+    std::uniform_int_distribution<uint32_t> indexDistribution(0, static_cast<uint32_t>(kColliderCount - 1));
+    std::vector<CollisionPair> candidates(kPairCount);
+    for (CollisionPair& pair : candidates) {
+        uint32_t first = indexDistribution(randomEngine);
+        uint32_t second = indexDistribution(randomEngine);
+        pair = { std::min(first, second), std::max(first, second) };
+    }
+
+    // スレッドの起動は計測に含めない(プールはアプリケーションで1つ作って使い回す想定)
+    static ThreadPool threadPool;
+    static ThreadPool serialThreadPool(1);
+    ParallelNarrowphase narrowphase(threadPool);
+    ParallelNarrowphase serialNarrowphase(serialThreadPool);
+
+    BenchmarkResult result {};
+    result.name = "Parallel Narrowphase";
+    result.workerCount = threadPool.GetWorkerCount();
+
+    // 同じ処理をワーカー1つ(メインスレッドだけ)で行い、スレッドを増やした分の差だけを比べる
+    std::vector<CollisionPair> referencePairs;
+    result.referenceMs = MeasureMilliseconds([&]() {
+        serialNarrowphase.FindCollidingPairs(registry, candidates, referencePairs);
+    });
+
+    std::vector<CollisionPair> optimizedPairs;
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        narrowphase.FindCollidingPairs(registry, candidates, optimizedPairs);
+    });
+
+    // 並びまで一致するか(食い違いの数)
+    size_t mismatchCount = referencePairs.size() > optimizedPairs.size() ? referencePairs.size() - optimizedPairs.size() : optimizedPairs.size() - referencePairs.size();
+    for (size_t i = 0; i < std::min(referencePairs.size(), optimizedPairs.size()); ++i) {
+        mismatchCount += referencePairs[i].first != optimizedPairs[i].first || referencePairs[i].second != optimizedPairs[i].second ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// 球と静的オブジェクトの重なり(全部調べる版とルーズ八分木)の比較
+BenchmarkResult CompareLooseOctree()
+{
+    const size_t kObjectCount = 200000;
+    const size_t kQueryCount = 200;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 地形に散らばった静的オブジェクト(ほとんどは小さく、一部が大きい)
+    std::vector<AABB> bounds(kObjectCount);
+    for (AABB& aabb : bounds) {
+        Vector3 center = { distribution(randomEngine) * 100.0f, distribution(randomEngine) * 10.0f, distribution(randomEngine) * 100.0f };
+        float size = std::pow(std::fabs(distribution(randomEngine)), 4.0f) * 5.0f + 0.05f;
+        Vector3 halfSize = { size * std::fabs(distribution(randomEngine)), size * std::fabs(distribution(randomEngine)), size };
+        aabb = { center - halfSize, center + halfSize };
+    }
+
+    std::vector<Sphere> queries(kQueryCount);
+    for (Sphere& sphere : queries) {
+        sphere = { { distribution(randomEngine) * 100.0f, distribution(randomEngine) * 10.0f, distribution(randomEngine) * 100.0f }, 2.0f };
+    }
+
+    // 構築は起動時に1度だけなので計測に含めない
+    LooseOctree octree;
+    octree.Build(bounds);
+
+    BenchmarkResult result {};
+    result.name = "Loose Octree";
+
+    // すべてのオブジェクトを調べる
+    std::vector<uint32_t> referenceCounts(kQueryCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kQueryCount; ++i) {
+            uint32_t count = 0;
+            for (const AABB& aabb : bounds) {
+                count += IsCollision(queries[i], aabb) ? 1 : 0;
+            }
+            referenceCounts[i] = count;
+        }
+    });
+
+    std::vector<uint32_t> optimizedCounts(kQueryCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kQueryCount; ++i) {
+            uint32_t count = 0;
+            octree.Query(queries[i], [&](uint32_t) {
+                ++count;
+                return true;
+            });
+            optimizedCounts[i] = count;
+        }
+    });
+
+    // 重なった数の食い違い
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < kQueryCount; ++i) {
+        mismatchCount += referenceCounts[i] != optimizedCounts[i] ? 1 : 0;
+    }
+    result.maxError = static_cast<float>(mismatchCount);
+
+    return result;
+}
+
+// GJK の距離計算(毎フレーム1点から始める版と前フレームの単体から始める版)の比較
+BenchmarkResult CompareGJKWarmStart()
+{
+    const size_t kPairCount = 1000;
+    const size_t kFrameCount = 60;
+    const size_t kPointCount = 32;
+
+    std::mt19937 randomEngine(12345);
+
+    // 静止した点群(岩のような凸形状)の近くを、OBB が少しずつ動きながら回る場面
+    std::vector<Vector3> points(kPairCount * kPointCount);
+    std::vector<Vector3> pointCenters(kPairCount);
+    for (size_t i = 0; i < kPairCount; ++i) {
+        pointCenters[i] = RandomVector(randomEngine, 50.0f);
+        for (size_t j = 0; j < kPointCount; ++j) {
+            points[i * kPointCount + j] = pointCenters[i] + Normalize(RandomVector(randomEngine, 1.0f)) * 0.6f;
+        }
+    }
+    std::vector<OBB> boxes(kPairCount * kFrameCount);
+    for (size_t i = 0; i < kPairCount; ++i) {
+        Vector3 offset = RandomVector(randomEngine, 1.0f);
+        Vector3 velocity = RandomVector(randomEngine, 0.01f);
+        Vector3 rotate = RandomVector(randomEngine, 3.14f);
+        Vector3 angularVelocity = RandomVector(randomEngine, 0.02f);
+        for (size_t frame = 0; frame < kFrameCount; ++frame) {
+            float time = static_cast<float>(frame);
+            boxes[frame * kPairCount + i] = MakeOBB({ { -0.4f, -0.3f, -0.5f }, { 0.4f, 0.3f, 0.5f } }, makeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate + angularVelocity * time, pointCenters[i] + offset + velocity * time));
+        }
+    }
+
+    BenchmarkResult result {};
+    result.name = "GJK Warm Start";
+
+    // 毎フレーム1点から始める
+    std::vector<float> referenceDistances(kPairCount * kFrameCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t frame = 0; frame < kFrameCount; ++frame) {
+            for (size_t i = 0; i < kPairCount; ++i) {
+                ConvexShape pointCloud(std::span<const Vector3>(points.data() + i * kPointCount, kPointCount));
+                referenceDistances[frame * kPairCount + i] = GJKDistance(boxes[frame * kPairCount + i], pointCloud).distance;
+            }
+        }
+    });
+
+    // 組ごとに前フレームの単体から始める
+    std::vector<float> optimizedDistances(kPairCount * kFrameCount);
+    std::vector<GJKCache> caches(kPairCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (size_t frame = 0; frame < kFrameCount; ++frame) {
+            for (size_t i = 0; i < kPairCount; ++i) {
+                ConvexShape pointCloud(std::span<const Vector3>(points.data() + i * kPointCount, kPointCount));
+                optimizedDistances[frame * kPairCount + i] = GJKDistance(boxes[frame * kPairCount + i], pointCloud, &caches[i]).distance;
+            }
+        }
+    }, [&]() { caches.assign(kPairCount, GJKCache {}); });
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < referenceDistances.size(); ++i) {
+        maxError = std::max(maxError, std::fabs(referenceDistances[i] - optimizedDistances[i]));
+    }
+    result.maxError = maxError;
+
+    return result;
+}
+
+// 点ごとに最も近い線分の検索(1点ずつとレーンにまとめる版)の比較
+BenchmarkResult CompareNearestSegment()
+{
+    const size_t kPointCount = 1000000;
+    const size_t kSegmentCount = 16;
+
+    std::mt19937 randomEngine(12345);
+
+    // 道路やワイヤーのような線分に、サンプル点ごとに最も近いものを求める場面
+    std::vector<Vector3> points(kPointCount);
+    for (Vector3& point : points) {
+        point = RandomVector(randomEngine, 20.0f);
+    }
+    std::vector<Segment> segments(kSegmentCount);
+    std::vector<ProximitySegment> proximitySegments(kSegmentCount);
+    for (size_t i = 0; i < kSegmentCount; ++i) {
+        segments[i] = { RandomVector(randomEngine, 20.0f), RandomVector(randomEngine, 10.0f) };
+        proximitySegments[i] = MakeProximitySegment(segments[i]);
+    }
+    Vector3SoA pointsSoA(points);
+
+    BenchmarkResult result {};
+    result.name = "Nearest Segment";
+
+    // 1点ずつ ClosestPoint で調べる
+    std::vector<uint32_t> referenceIndices(kPointCount);
+    std::vector<float> referenceDistancesSq(kPointCount);
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (size_t i = 0; i < kPointCount; ++i) {
+            float nearestDistanceSq = std::numeric_limits<float>::infinity();
+            uint32_t nearestIndex = 0;
+            for (uint32_t j = 0; j < kSegmentCount; ++j) {
+                Vector3 diff = ClosestPoint(points[i], segments[j]) - points[i];
+                float distanceSq = Dot(diff, diff);
+                if (distanceSq < nearestDistanceSq) {
+                    nearestDistanceSq = distanceSq;
+                    nearestIndex = j;
+                }
+            }
+            referenceIndices[i] = nearestIndex;
+            referenceDistancesSq[i] = nearestDistanceSq;
+        }
+    });
+
+    // 点をレーンに並べてまとめて調べる
+    std::vector<uint32_t> optimizedIndices(kPointCount);
+    std::vector<float> optimizedDistancesSq(kPointCount);
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        FindNearest(pointsSoA, proximitySegments, optimizedIndices, optimizedDistancesSq);
+    });
+
+    // 最も近い線分までの距離の2乗の相対誤差(ほぼ同じ距離の線分は、どちらを選んでも良い)
+    float maxError = 0.0f;
+    for (size_t i = 0; i < kPointCount; ++i) {
+        maxError = std::max(maxError, std::fabs(referenceDistancesSq[i] - optimizedDistancesSq[i]) / std::max(1.0f, referenceDistancesSq[i]));
+    }
+    result.maxError = maxError;
+
+    return result;
+}
+
+// 多数のボールの移動と跳ね返り(1個ずつとレーンにまとめる版)の比較
+BenchmarkResult CompareBallSystem()
+{
+    const size_t kBallCount = 1000000;
+    const int kFrameCount = 4;
+    const int kMaxBounceCount = 4;
+    const float kDeltaTime = 1.0f / 60.0f;
+    const float kRestitution = 0.8f;
+
+    std::mt19937 randomEngine(12345);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // 傾いた床の近くで、多数のボールが跳ね返る場面
+    Plane plane = { Normalize({ -0.2f, 0.9f, -0.3f }), 0.0f };
+    std::vector<Ball> balls(kBallCount);
+    for (Ball& ball : balls) {
+        ball.position = RandomVector(randomEngine, 20.0f);
+        ball.position += plane.normal * (0.5f - Dot(plane.normal, ball.position) + distribution(randomEngine) * 0.4f);
+        ball.velocity = RandomVector(randomEngine, 10.0f);
+        ball.acceleration = { 0.0f, -9.8f, 0.0f };
+        ball.mass = 1.0f;
+        ball.radius = 0.05f + (distribution(randomEngine) + 1.0f) * 0.05f;
+        ball.color = 0xFFFFFFFF;
+    }
+    BallSystem ballSystem;
+    ballSystem.Reserve(kBallCount);
+    for (const Ball& ball : balls) {
+        ballSystem.Add(ball);
+    }
+    const std::vector<Ball> initialBalls = balls;
+    const BallSystem initialBallSystem = ballSystem;
+
+    BenchmarkResult result {};
+    result.name = "Ball System";
+
+    // 1個ずつ SweepSphere で接触する時刻を求めて Reflect で跳ね返す
+    result.referenceMs = MeasureMilliseconds([&]() {
+        for (int frame = 0; frame < kFrameCount; ++frame) {
+            for (Ball& ball : balls) {
+                ball.velocity += ball.acceleration * kDeltaTime;
+                float remainingTime = kDeltaTime;
+                for (int bounce = 0; bounce < kMaxBounceCount; ++bounce) {
+                    Vector3 displacement = ball.velocity * remainingTime;
+                    Contact contact;
+                    if (!SweepSphere(Sphere { ball.position, ball.radius }, displacement, plane, contact) || Dot(ball.velocity, contact.normal) >= 0.0f) {
+                        ball.position += displacement;
+                        break;
+                    }
+                    ball.position += displacement * contact.t;
+                    remainingTime *= 1.0f - contact.t;
+                    ball.velocity = Reflect(ball.velocity, contact.normal, kRestitution);
+                }
+            }
+        }
+    }, [&]() { balls = initialBalls; });
+
+    // ボールをレーンに並べてまとめて動かす
+    result.optimizedMs = MeasureMilliseconds([&]() {
+        for (int frame = 0; frame < kFrameCount; ++frame) {
+            ballSystem.Integrate(kDeltaTime, plane, kRestitution, kMaxBounceCount);
+        }
+    }, [&]() { ballSystem = initialBallSystem; });
+
+    // 位置の最大誤差
+    float maxError = 0.0f;
+    const Vector3SoA& positions = ballSystem.GetPositions();
+    for (size_t i = 0; i < kBallCount; ++i) {
+        maxError = std::max(maxError, Length(positions.Get(i) - balls[i].position));
+    }
+    result.maxError = maxError;
+
+    return result;
+}
+
+} // namespace
+
+std::vector<BenchmarkResult> RunMathBenchmark()
+{
+    std::vector<Matrix4x4> matrices = MakeRandomMatrices(1024, false);
+    std::vector<Matrix4x4> rigidMatrices = MakeRandomMatrices(1024, true);
+    std::vector<BenchmarkResult> results;
+
+    results.push_back(CompareMatrixFunction(
+        "Matrix Multiply", matrices,
+        [](const Matrix4x4& m1, const Matrix4x4& m2) { return MultiplyScalar(m1, m2); },
+        [](const Matrix4x4& m1, const Matrix4x4& m2) { return Multiply(m1, m2); }));
+
+    results.push_back(CompareMatrixFunction(
+        "Matrix Transpose", matrices,
+        [](const Matrix4x4& m1, const Matrix4x4&) { return TransposeScalar(m1); },
+        [](const Matrix4x4& m1, const Matrix4x4&) { return Transpose(m1); }));
+
+    results.push_back(CompareMatrixFunction(
+        "Matrix Inverse", matrices,
+        [](const Matrix4x4& m1, const Matrix4x4&) { return InverseScalar(m1); },
+        [](const Matrix4x4& m1, const Matrix4x4&) { return InverseGeneral(m1); }));
+
+    results.push_back(CompareMatrixFunction(
+        "Inverse Affine", matrices,
+        [](const Matrix4x4& m1, const Matrix4x4&) { return InverseScalar(m1); },
+        [](const Matrix4x4& m1, const Matrix4x4&) { return Inverse(m1); }));
+
+    results.push_back(CompareMatrixFunction(
+        "Inverse Rigid", rigidMatrices,
+        [](const Matrix4x4& m1, const Matrix4x4&) { return InverseScalar(m1); },
+        [](const Matrix4x4& m1, const Matrix4x4&) { return Inverse(m1, MatrixType::Rigid); }));
+
+    Matrix4x4 worldMatrix = makeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+    Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, float(1280) / float(720), 0.1f, 100.0f);
+
+    results.push_back(CompareTransformCoords("TransformCoord Affine", worldMatrix));
+    results.push_back(CompareTransformCoords("TransformCoord Proj", Multiply(worldMatrix, projectionMatrix)));
+
+    results.push_back(CompareInlineVectorFunctions());
+    results.push_back(CompareVector3SoA());
+    results.push_back(CompareSphereWireframe());
+    results.push_back(CompareTransformCompose());
+    results.push_back(CompareFrustumCulling());
+    results.push_back(CompareSpatialHash());
+    results.push_back(CompareDynamicAABBTree());
+    results.push_back(CompareSweepAndPrune());
+    results.push_back(CompareTriangleBVH());
+    results.push_back(ComparePreparedTriangle());
+    results.push_back(CompareSegmentPacket());
+    results.push_back(CompareSphereContact());
+    results.push_back(CompareSweptSphere());
+    results.push_back(CompareOBBCollision());
+    results.push_back(CompareColliderDispatch());
+    results.push_back(CompareParallelNarrowphase());
+    results.push_back(CompareLooseOctree());
+    results.push_back(CompareGJKWarmStart());
+    results.push_back(CompareNearestSegment());
+    results.push_back(CompareBallSystem());
+
+    return results;
+}
+
+void DrawMathBenchmarkWindow()
+{
+    static std::vector<BenchmarkResult> results;
+
+    ImGui::Begin("Math Benchmark");
+    ImGui::Text("SIMD Level: %d", MYMATH_SIMD_LEVEL);
+
+    if (ImGui::Button("Run Benchmark")) {
+        results = RunMathBenchmark();
+    }
+
+    for (const BenchmarkResult& result : results) {
+        ImGui::Text("%-20s ref %8.3fms  opt %8.3fms  x%.2f  err %.2e",
+            result.name, result.referenceMs, result.optimizedMs,
+            result.optimizedMs > 0.0 ? result.referenceMs / result.optimizedMs : 0.0,
+            result.maxError);
+        if (result.workerCount > 0) {
+            ImGui::SameLine();
+            ImGui::Text("(%u threads)", result.workerCount);
+        }
+    }
+
+    ImGui::End();
+}
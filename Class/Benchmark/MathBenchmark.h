@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// ベンチマーク結果
+/// </summary>
+struct BenchmarkResult {
+    const char* name; //!< 計測項目
+    double referenceMs; //!< 従来実装の計測時間(ミリ秒)
+    double optimizedMs; //!< 最適化実装の計測時間(ミリ秒)
+    float maxError; //!< 従来実装との最大誤差
+    uint32_t workerCount; //!< 最適化実装が使ったスレッドの数(0ならスレッドを使わない項目)
+};
+
+/// <summary>
+/// 数学ライブラリのベンチマークを実行
+/// </summary>
+/// <returns>各項目の計測結果</returns>
+std::vector<BenchmarkResult> RunMathBenchmark();
+
+/// <summary>
+/// ベンチマーク用ImGuiウィンドウの描画
+/// </summary>
+void DrawMathBenchmarkWindow();
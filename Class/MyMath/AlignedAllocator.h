@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// SIMD用の配列の先頭アドレスの揃え(AVXの1レジスタ分)
+constexpr size_t kSimdAlignment = 32;
+
+/// <summary>
+/// 先頭アドレスを揃えて確保するアロケータ
+/// </summary>
+template <typename T, size_t kAlignment = kSimdAlignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, kAlignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, kAlignment>&) { }
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(kAlignment)));
+    }
+
+    void deallocate(T* pointer, size_t)
+    {
+        ::operator delete(pointer, std::align_val_t(kAlignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, kAlignment>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, kAlignment>&) const { return false; }
+};
+
+// 先頭アドレスを揃えた可変長配列
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
@@ -0,0 +1,236 @@
+#include "BallSystem.h"
+#include "LaneVector.h"
+#include "MyCollision.h"
+#include "ThreadPool.h"
+#include <assert.h>
+#include <cfloat>
+
+namespace {
+
+// レーン数分のボール(更新に使うメンバーだけ)
+struct BallLanes {
+    LaneVector position;
+    LaneVector velocity;
+    LaneVector acceleration;
+    FloatLane radius;
+};
+
+// ボールの配列の先頭(成分ごと)
+struct BallArrays {
+    float* position[3];
+    float* velocity[3];
+    const float* acceleration[3];
+    const float* radius;
+};
+
+template <class Float>
+inline LaneVector LoadVector(Float* const (&components)[3], size_t index)
+{
+    return { LaneLoad(components[0] + index), LaneLoad(components[1] + index), LaneLoad(components[2] + index) };
+}
+
+inline void StoreVector(float* const (&components)[3], size_t index, const LaneVector& v)
+{
+    LaneStore(components[0] + index, v.x);
+    LaneStore(components[1] + index, v.y);
+    LaneStore(components[2] + index, v.z);
+}
+
+/// <summary>
+/// [begin, end) のボールをレーン数ずつ更新する(位置と速度を書き戻す)
+/// 端数は scalarKernel で1個ずつ更新する
+/// </summary>
+template <class LaneKernel, class ScalarKernel>
+void UpdateBalls(const BallArrays& arrays, size_t begin, size_t end, const LaneKernel& laneKernel, const ScalarKernel& scalarKernel)
+{
+    size_t i = begin;
+    for (; i + kFloatLaneWidth <= end; i += kFloatLaneWidth) {
+        BallLanes balls = {
+            LoadVector(arrays.position, i),
+            LoadVector(arrays.velocity, i),
+            LoadVector(arrays.acceleration, i),
+            LaneLoad(arrays.radius + i),
+        };
+        laneKernel(balls);
+        StoreVector(arrays.position, i, balls.position);
+        StoreVector(arrays.velocity, i, balls.velocity);
+    }
+
+    // 端数
+    for (; i < end; ++i) {
+        Vector3 position = { arrays.position[0][i], arrays.position[1][i], arrays.position[2][i] };
+        Vector3 velocity = { arrays.velocity[0][i], arrays.velocity[1][i], arrays.velocity[2][i] };
+        Vector3 acceleration = { arrays.acceleration[0][i], arrays.acceleration[1][i], arrays.acceleration[2][i] };
+        scalarKernel(position, velocity, acceleration, arrays.radius[i]);
+        arrays.position[0][i] = position.x;
+        arrays.position[1][i] = position.y;
+        arrays.position[2][i] = position.z;
+        arrays.velocity[0][i] = velocity.x;
+        arrays.velocity[1][i] = velocity.y;
+        arrays.velocity[2][i] = velocity.z;
+    }
+}
+
+} // namespace
+
+size_t BallSystem::Add(const Ball& ball)
+{
+    positions_.PushBack(ball.position);
+    velocities_.PushBack(ball.velocity);
+    accelerations_.PushBack(ball.acceleration);
+    masses_.push_back(ball.mass);
+    radii_.push_back(ball.radius);
+    colors_.push_back(ball.color);
+    return Size() - 1;
+}
+
+Ball BallSystem::Get(size_t index) const
+{
+    assert(index < Size());
+    return { positions_.Get(index), velocities_.Get(index), accelerations_.Get(index), masses_[index], radii_[index], colors_[index] };
+}
+
+void BallSystem::Set(size_t index, const Ball& ball)
+{
+    assert(index < Size());
+    positions_.Set(index, ball.position);
+    velocities_.Set(index, ball.velocity);
+    accelerations_.Set(index, ball.acceleration);
+    masses_[index] = ball.mass;
+    radii_[index] = ball.radius;
+    colors_[index] = ball.color;
+}
+
+void BallSystem::Reserve(size_t count)
+{
+    positions_.Reserve(count);
+    velocities_.Reserve(count);
+    accelerations_.Reserve(count);
+    masses_.reserve(count);
+    radii_.reserve(count);
+    colors_.reserve(count);
+}
+
+void BallSystem::Clear()
+{
+    positions_.Clear();
+    velocities_.Clear();
+    accelerations_.Clear();
+    masses_.clear();
+    radii_.clear();
+    colors_.clear();
+}
+
+template <class Kernel>
+void BallSystem::ForEachChunk(ThreadPool* threadPool, const Kernel& kernel)
+{
+    size_t count = Size();
+    if (threadPool == nullptr || count <= kChunkSize) {
+        kernel(size_t(0), count);
+        return;
+    }
+
+    // チャンクごとに別の要素を書き換えるので、ワーカー間の同期はいらない
+    threadPool->ParallelFor(count, kChunkSize, [&](size_t, size_t begin, size_t end, uint32_t) {
+        kernel(begin, end);
+    });
+}
+
+// 位置と速度の更新
+void BallSystem::Integrate(float deltaTime, ThreadPool* threadPool)
+{
+    BallArrays arrays = {
+        { positions_.x.data(), positions_.y.data(), positions_.z.data() },
+        { velocities_.x.data(), velocities_.y.data(), velocities_.z.data() },
+        { accelerations_.x.data(), accelerations_.y.data(), accelerations_.z.data() },
+        radii_.data(),
+    };
+    FloatLane time = LaneSet(deltaTime);
+
+    ForEachChunk(threadPool, [&](size_t begin, size_t end) {
+        UpdateBalls(
+            arrays, begin, end,
+            [&](BallLanes& balls) {
+                balls.velocity = LaneMultiplyAdd(balls.velocity, balls.acceleration, time);
+                balls.position = LaneMultiplyAdd(balls.position, balls.velocity, time);
+            },
+            [&](Vector3& position, Vector3& velocity, const Vector3& acceleration, float) {
+                velocity += acceleration * deltaTime;
+                position += velocity * deltaTime;
+            });
+    });
+}
+
+// 平面で跳ね返りながらの位置と速度の更新
+void BallSystem::Integrate(float deltaTime, const Plane& plane, float restitution, int maxBounceCount, ThreadPool* threadPool)
+{
+    BallArrays arrays = {
+        { positions_.x.data(), positions_.y.data(), positions_.z.data() },
+        { velocities_.x.data(), velocities_.y.data(), velocities_.z.data() },
+        { accelerations_.x.data(), accelerations_.y.data(), accelerations_.z.data() },
+        radii_.data(),
+    };
+    FloatLane time = LaneSet(deltaTime);
+    LaneVector normal = LaneBroadcast(plane.normal);
+    FloatLane planeDistance = LaneSet(plane.distance);
+    // Reflect(velocity, normal, restitution) = velocity + normal * (Dot(velocity, normal) * responseScale)
+    FloatLane responseScale = LaneSet(-(1.0f + restitution) / Dot(plane.normal, plane.normal));
+    FloatLane zero = LaneSet(0.0f);
+    FloatLane one = LaneSet(1.0f);
+
+    ForEachChunk(threadPool, [&](size_t begin, size_t end) {
+        UpdateBalls(
+            arrays, begin, end,
+            [&](BallLanes& balls) {
+                balls.velocity = LaneMultiplyAdd(balls.velocity, balls.acceleration, time);
+
+                // レーンごとに SweepSphere と同じ判定をして、接触したレーンだけ接触する時刻まで進めて跳ね返す
+                FloatLane remainingTime = time;
+                LaneMask isMoving = LaneLessEqual(zero, zero); // まだ残りの時間を進めていないレーン(最初は全レーン)
+                for (int bounce = 0; bounce < maxBounceCount; ++bounce) {
+                    LaneVector displacement = LaneScale(balls.velocity, remainingTime);
+
+                    // 平面までの隙間を、移動で平面に近づく量で割る(中心がある側の法線で測る)
+                    FloatLane distance = LaneSub(LaneDot(normal, balls.position), planeDistance);
+                    FloatLane side = LaneSelect(LaneLess(distance, zero), LaneSet(-1.0f), one);
+                    FloatLane gap = LaneSub(LaneAbs(distance), balls.radius);
+                    FloatLane approach = LaneMul(LaneSub(zero, LaneDot(normal, displacement)), side);
+                    FloatLane normalSpeed = LaneMul(LaneDot(balls.velocity, normal), side);
+
+                    // 既に接しているか移動中に届き、平面に向かって動いているレーンを跳ね返す
+                    LaneMask isHit = LaneOr(LaneLessEqual(gap, zero), LaneLessEqual(gap, approach));
+                    LaneMask isBounce = LaneAnd(isMoving, LaneAnd(isHit, LaneLess(normalSpeed, zero)));
+                    FloatLane t = LaneDiv(LaneMax(gap, zero), LaneMax(approach, LaneSet(FLT_MIN)));
+
+                    // 跳ね返るレーンは接触する時刻まで、届かないレーンは最後まで進める
+                    FloatLane step = LaneSelect(isBounce, t, LaneSelect(isMoving, one, zero));
+                    balls.position = LaneMultiplyAdd(balls.position, displacement, step);
+                    remainingTime = LaneSelect(isBounce, LaneMul(remainingTime, LaneSub(one, t)), remainingTime);
+
+                    LaneVector reflected = LaneMultiplyAdd(balls.velocity, normal, LaneMul(LaneDot(balls.velocity, normal), responseScale));
+                    balls.velocity = LaneSelectVector(isBounce, reflected, balls.velocity);
+
+                    isMoving = isBounce;
+                    if (LaneMaskBits(isMoving) == 0) {
+                        break;
+                    }
+                }
+            },
+            [&](Vector3& position, Vector3& velocity, const Vector3& acceleration, float radius) {
+                // 1個ずつ SweepSphere で接触する時刻を求めて Reflect で跳ね返す
+                velocity += acceleration * deltaTime;
+                float remainingTime = deltaTime;
+                for (int bounce = 0; bounce < maxBounceCount; ++bounce) {
+                    Vector3 displacement = velocity * remainingTime;
+                    Contact contact;
+                    if (!SweepSphere(Sphere { position, radius }, displacement, plane, contact) || Dot(velocity, contact.normal) >= 0.0f) {
+                        position += displacement;
+                        break;
+                    }
+                    position += displacement * contact.t;
+                    remainingTime *= 1.0f - contact.t;
+                    velocity = Reflect(velocity, contact.normal, restitution);
+                }
+            });
+    });
+}
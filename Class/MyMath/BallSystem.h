@@ -0,0 +1,84 @@
+#pragma once
+
+#include "AlignedAllocator.h"
+#include "MyMath.h"
+#include "Vector/Vector3SoA.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+class ThreadPool;
+
+/// <summary>
+/// ボール構造体
+/// </summary>
+struct Ball {
+    Vector3 position; // 位置
+    Vector3 velocity; // 速度
+    Vector3 acceleration; // 加速度
+    float mass; // 質量
+    float radius; // 半径
+    unsigned int color; // 色
+};
+
+/// <summary>
+/// 多数のボールをまとめて動かすシステム
+/// Ball の各メンバーを成分ごとの配列(SoA形式)で持ち、ボールをSIMDのレーンに並べて一度に更新する
+/// 1フレームの更新に必要な位置・速度・加速度・半径だけを読むので、質量や色はキャッシュに載せない
+/// </summary>
+class BallSystem {
+public:
+    // 1チャンクのボールの数(スレッドプールのワーカー間の受け渡しの単位。レーン幅の倍数)
+    static constexpr size_t kChunkSize = 16384;
+
+    // ボールの追加(戻り値は追加したボールの番号)
+    size_t Add(const Ball& ball);
+
+    // ボールの取得・設定
+    Ball Get(size_t index) const;
+    void Set(size_t index, const Ball& ball);
+
+    // 容量の確保
+    void Reserve(size_t count);
+    void Clear();
+
+    // ボールの数
+    size_t Size() const { return positions_.Size(); }
+
+    /// <summary>
+    /// 位置と速度を deltaTime だけ進める(速度を先に更新する半陰的オイラー法)
+    /// </summary>
+    /// <param name="deltaTime">経過時間</param>
+    /// <param name="threadPool">スレッドプール(nullptr なら呼び出したスレッドだけで処理する)</param>
+    void Integrate(float deltaTime, ThreadPool* threadPool = nullptr);
+
+    /// <summary>
+    /// 位置と速度を deltaTime だけ進め、移動中に平面と接触したボールを跳ね返す
+    /// 1個のボールを SweepSphere で接触する時刻まで進め、Reflect で跳ね返して残りの時間を進めるのと同じ結果になる
+    /// (跳ね返りが maxBounceCount 回を超えたら、残りの時間は進めない)
+    /// </summary>
+    /// <param name="deltaTime">経過時間</param>
+    /// <param name="plane">平面(法線は正規化済み)</param>
+    /// <param name="restitution">反発係数</param>
+    /// <param name="maxBounceCount">1回の更新で跳ね返りを処理する最大回数</param>
+    /// <param name="threadPool">スレッドプール(nullptr なら呼び出したスレッドだけで処理する)</param>
+    void Integrate(float deltaTime, const Plane& plane, float restitution, int maxBounceCount, ThreadPool* threadPool = nullptr);
+
+    const Vector3SoA& GetPositions() const { return positions_; }
+    const Vector3SoA& GetVelocities() const { return velocities_; }
+    std::span<const float> GetMasses() const { return masses_; }
+    std::span<const float> GetRadii() const { return radii_; }
+    std::span<const uint32_t> GetColors() const { return colors_; }
+
+private:
+    // [0, Size()) をチャンクに分けて処理する(kernel は void(size_t begin, size_t end))
+    template <class Kernel>
+    void ForEachChunk(ThreadPool* threadPool, const Kernel& kernel);
+
+    Vector3SoA positions_;
+    Vector3SoA velocities_;
+    Vector3SoA accelerations_;
+    AlignedVector<float> masses_;
+    AlignedVector<float> radii_;
+    AlignedVector<uint32_t> colors_;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+/// <summary>
+/// ブロードフェーズが出力する衝突候補の組(入力配列の添字。first < second)
+/// </summary>
+struct CollisionPair {
+    uint32_t first;
+    uint32_t second;
+};
+
+// 2つの添字を小さい順に並べた組
+inline CollisionPair MakePair(uint32_t index1, uint32_t index2)
+{
+    return index1 < index2 ? CollisionPair { index1, index2 } : CollisionPair { index2, index1 };
+}
@@ -0,0 +1,386 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// 移動量に掛けて AABB を移動方向に広げる倍率(数フレーム先まで木を更新しなくて済むようにする)
+const float kDisplacementMultiplier = 4.0f;
+
+// outer が inner を完全に含むか
+bool Contains(const AABB& outer, const AABB& inner)
+{
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+        && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+// 各軸に margin だけ広げる
+AABB Expand(const AABB& aabb, float margin)
+{
+    return {
+        { aabb.min.x - margin, aabb.min.y - margin, aabb.min.z - margin },
+        { aabb.max.x + margin, aabb.max.y + margin, aabb.max.z + margin },
+    };
+}
+
+} // namespace
+
+DynamicAABBTree::DynamicAABBTree(float margin)
+    : margin_(margin)
+{
+}
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& aabb, uint32_t userData)
+{
+    int32_t proxyId = AllocateNode();
+    Node& node = nodes_[proxyId];
+    node.aabb = Expand(aabb, margin_);
+    node.userData = userData;
+    node.height = 0;
+    node.moved = true;
+
+    InsertLeaf(proxyId);
+    moveBuffer_.push_back(proxyId);
+    ++proxyCount_;
+
+    return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyId)
+{
+    assert(nodes_[proxyId].IsLeaf());
+
+    if (nodes_[proxyId].moved) {
+        std::replace(moveBuffer_.begin(), moveBuffer_.end(), proxyId, kNullNode);
+    }
+
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    --proxyCount_;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& aabb, const Vector3& displacement)
+{
+    assert(nodes_[proxyId].IsLeaf());
+
+    // 太らせ、さらに移動方向へ広げた AABB
+    AABB fatAABB = Expand(aabb, margin_);
+    Vector3 extension = displacement * kDisplacementMultiplier;
+    (extension.x < 0.0f ? fatAABB.min.x : fatAABB.max.x) += extension.x;
+    (extension.y < 0.0f ? fatAABB.min.y : fatAABB.max.y) += extension.y;
+    (extension.z < 0.0f ? fatAABB.min.z : fatAABB.max.z) += extension.z;
+
+    const AABB& treeAABB = nodes_[proxyId].aabb;
+    if (Contains(treeAABB, aabb)) {
+        // まだ木の AABB の中にある。ただし止まった後などで大きすぎる場合は縮める
+        if (Contains(Expand(fatAABB, margin_ * kDisplacementMultiplier), treeAABB)) {
+            return false;
+        }
+    }
+
+    RemoveLeaf(proxyId);
+    nodes_[proxyId].aabb = fatAABB;
+    InsertLeaf(proxyId);
+
+    if (!nodes_[proxyId].moved) {
+        nodes_[proxyId].moved = true;
+        moveBuffer_.push_back(proxyId);
+    }
+
+    return true;
+}
+
+void DynamicAABBTree::FindMovedPairs(std::vector<CollisionPair>& pairs)
+{
+    pairs.clear();
+
+    for (int32_t queryProxyId : moveBuffer_) {
+        if (queryProxyId == kNullNode) {
+            continue;
+        }
+
+        const Node& queryNode = nodes_[queryProxyId];
+        Query(queryNode.aabb, [&](int32_t proxyId) {
+            if (proxyId == queryProxyId) {
+                return true;
+            }
+            // 両方動いた組は番号の大きい方からだけ出力する
+            if (nodes_[proxyId].moved && proxyId > queryProxyId) {
+                return true;
+            }
+            pairs.push_back(MakePair(queryNode.userData, nodes_[proxyId].userData));
+            return true;
+        });
+    }
+
+    for (int32_t proxyId : moveBuffer_) {
+        if (proxyId != kNullNode) {
+            nodes_[proxyId].moved = false;
+        }
+    }
+    moveBuffer_.clear();
+}
+
+void DynamicAABBTree::FindPairs(std::vector<CollisionPair>& pairs) const
+{
+    pairs.clear();
+
+    for (int32_t queryProxyId = 0; queryProxyId < static_cast<int32_t>(nodes_.size()); ++queryProxyId) {
+        const Node& queryNode = nodes_[queryProxyId];
+        if (queryNode.height != 0) {
+            continue;
+        }
+
+        Query(queryNode.aabb, [&](int32_t proxyId) {
+            if (proxyId > queryProxyId) {
+                pairs.push_back(MakePair(queryNode.userData, nodes_[proxyId].userData));
+            }
+            return true;
+        });
+    }
+}
+
+int32_t DynamicAABBTree::AllocateNode()
+{
+    int32_t nodeId;
+    if (freeList_ != kNullNode) {
+        nodeId = freeList_;
+        freeList_ = nodes_[nodeId].parent;
+    } else {
+        nodeId = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[nodeId];
+    node.parent = kNullNode;
+    node.child1 = kNullNode;
+    node.child2 = kNullNode;
+    node.height = 0;
+    node.userData = 0;
+    node.moved = false;
+    return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int32_t nodeId)
+{
+    nodes_[nodeId].parent = freeList_;
+    nodes_[nodeId].height = -1;
+    freeList_ = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf)
+{
+    if (root_ == kNullNode) {
+        root_ = leaf;
+        nodes_[leaf].parent = kNullNode;
+        return;
+    }
+
+    // 表面積の増加が最小になる兄弟を探す
+    AABB leafAABB = nodes_[leaf].aabb;
+    int32_t index = root_;
+    while (!nodes_[index].IsLeaf()) {
+        const Node& node = nodes_[index];
+
+        float area = HalfSurfaceArea(node.aabb);
+        float combinedArea = HalfSurfaceArea(Combine(node.aabb, leafAABB));
+
+        // ここに新しい親を作る場合のコスト
+        float cost = 2.0f * combinedArea;
+        // 子孫に下ろす場合に、このノードが大きくなる分のコスト
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        // 子に下ろす場合のコスト
+        auto descendCost = [&](int32_t child) {
+            const Node& childNode = nodes_[child];
+            float newArea = HalfSurfaceArea(Combine(leafAABB, childNode.aabb));
+            if (childNode.IsLeaf()) {
+                return newArea + inheritanceCost;
+            }
+            return newArea - HalfSurfaceArea(childNode.aabb) + inheritanceCost;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    // 兄弟と葉をまとめる親を作る(AllocateNode で配列が伸びるので参照は持たない)
+    int32_t sibling = index;
+    int32_t oldParent = nodes_[sibling].parent;
+    int32_t newParent = AllocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].aabb = Combine(leafAABB, nodes_[sibling].aabb);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent != kNullNode) {
+        if (nodes_[oldParent].child1 == sibling) {
+            nodes_[oldParent].child1 = newParent;
+        } else {
+            nodes_[oldParent].child2 = newParent;
+        }
+    } else {
+        root_ = newParent;
+    }
+
+    Refit(oldParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+{
+    if (leaf == root_) {
+        root_ = kNullNode;
+        return;
+    }
+
+    int32_t parent = nodes_[leaf].parent;
+    int32_t grandParent = nodes_[parent].parent;
+    int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    // 親を消して兄弟を繰り上げる
+    nodes_[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    if (grandParent != kNullNode) {
+        if (nodes_[grandParent].child1 == parent) {
+            nodes_[grandParent].child1 = sibling;
+        } else {
+            nodes_[grandParent].child2 = sibling;
+        }
+        Refit(grandParent);
+    } else {
+        root_ = sibling;
+    }
+}
+
+void DynamicAABBTree::Refit(int32_t nodeId)
+{
+    // 根までたどって、回転しながら AABB と高さを直す
+    while (nodeId != kNullNode) {
+        nodeId = Balance(nodeId);
+
+        Node& node = nodes_[nodeId];
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.aabb = Combine(child1.aabb, child2.aabb);
+
+        nodeId = node.parent;
+    }
+}
+
+int32_t DynamicAABBTree::Balance(int32_t iA)
+{
+    Node& a = nodes_[iA];
+    if (a.IsLeaf() || a.height < 2) {
+        return iA;
+    }
+
+    int32_t iB = a.child1;
+    int32_t iC = a.child2;
+    Node& b = nodes_[iB];
+    Node& c = nodes_[iC];
+
+    int32_t balance = c.height - b.height;
+
+    // C を持ち上げる(C が A の位置に来て、A は C の子になる)
+    if (balance > 1) {
+        int32_t iF = c.child1;
+        int32_t iG = c.child2;
+        Node& f = nodes_[iF];
+        Node& g = nodes_[iG];
+
+        c.child1 = iA;
+        c.parent = a.parent;
+        a.parent = iC;
+
+        if (c.parent != kNullNode) {
+            if (nodes_[c.parent].child1 == iA) {
+                nodes_[c.parent].child1 = iC;
+            } else {
+                nodes_[c.parent].child2 = iC;
+            }
+        } else {
+            root_ = iC;
+        }
+
+        // 高い方の孫を C の子に残す
+        if (f.height > g.height) {
+            c.child2 = iF;
+            a.child2 = iG;
+            g.parent = iA;
+            a.aabb = Combine(b.aabb, g.aabb);
+            c.aabb = Combine(a.aabb, f.aabb);
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        } else {
+            c.child2 = iG;
+            a.child2 = iF;
+            f.parent = iA;
+            a.aabb = Combine(b.aabb, f.aabb);
+            c.aabb = Combine(a.aabb, g.aabb);
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+
+        return iC;
+    }
+
+    // B を持ち上げる(上と左右対称)
+    if (balance < -1) {
+        int32_t iD = b.child1;
+        int32_t iE = b.child2;
+        Node& d = nodes_[iD];
+        Node& e = nodes_[iE];
+
+        b.child1 = iA;
+        b.parent = a.parent;
+        a.parent = iB;
+
+        if (b.parent != kNullNode) {
+            if (nodes_[b.parent].child1 == iA) {
+                nodes_[b.parent].child1 = iB;
+            } else {
+                nodes_[b.parent].child2 = iB;
+            }
+        } else {
+            root_ = iB;
+        }
+
+        if (d.height > e.height) {
+            b.child2 = iD;
+            a.child1 = iE;
+            e.parent = iA;
+            a.aabb = Combine(c.aabb, e.aabb);
+            b.aabb = Combine(a.aabb, d.aabb);
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        } else {
+            b.child2 = iE;
+            a.child1 = iD;
+            d.parent = iA;
+            a.aabb = Combine(c.aabb, d.aabb);
+            b.aabb = Combine(a.aabb, e.aabb);
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+bool DynamicAABBTree::IntersectSegment(const AABB& aabb, const PreparedSegment& segment, float maxT)
+{
+    // スラブ法(IsCollision(const AABB&, const Segment&) と同じ。t の上限だけ maxT にする)
+    return SegmentEnterT(segment, aabb.min, aabb.max, maxT) <= maxT;
+}
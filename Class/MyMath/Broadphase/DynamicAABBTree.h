@@ -0,0 +1,217 @@
+#pragma once
+
+#include "../MyCollision.h"
+#include "../MyMath.h"
+#include "../SegmentPacket.h"
+#include "CollisionPair.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 動的AABB木(ブロードフェーズ)
+/// 葉には少し太らせた AABB を持たせ、その中で動いている間は木を更新しない
+/// 挿入位置は表面積の増加が最小になるように選び、回転で高さの偏りを直す
+/// 追加・削除・移動は O(log n)。毎フレーム動くオブジェクトが一部だけなら、その分の処理しかかからない
+/// </summary>
+class DynamicAABBTree {
+public:
+    // 無効なノード
+    static constexpr int32_t kNullNode = -1;
+
+    /// <summary>
+    /// 作成
+    /// </summary>
+    /// <param name="margin">葉の AABB を太らせる幅</param>
+    explicit DynamicAABBTree(float margin = 0.1f);
+
+    /// <summary>
+    /// オブジェクトを追加する
+    /// </summary>
+    /// <param name="aabb">オブジェクトの AABB</param>
+    /// <param name="userData">オブジェクトの番号(FindPairs などで出力される値)</param>
+    /// <returns>プロキシ(葉ノード)の番号</returns>
+    int32_t CreateProxy(const AABB& aabb, uint32_t userData);
+
+    /// <summary>
+    /// オブジェクトを削除する
+    /// </summary>
+    void DestroyProxy(int32_t proxyId);
+
+    /// <summary>
+    /// オブジェクトを移動する。太らせた AABB からはみ出した場合だけ木を更新する
+    /// </summary>
+    /// <param name="proxyId">プロキシの番号</param>
+    /// <param name="aabb">移動後の AABB</param>
+    /// <param name="displacement">このフレームの移動量(移動方向に AABB を広げておく)</param>
+    /// <returns>木を更新した場合は true</returns>
+    bool MoveProxy(int32_t proxyId, const AABB& aabb, const Vector3& displacement);
+
+    // オブジェクトの番号
+    uint32_t GetUserData(int32_t proxyId) const { return nodes_[proxyId].userData; }
+
+    // 太らせた AABB
+    const AABB& GetFatAABB(int32_t proxyId) const { return nodes_[proxyId].aabb; }
+
+    // 木の高さ(空なら0)
+    int32_t GetHeight() const { return root_ == kNullNode ? 0 : nodes_[root_].height; }
+
+    // オブジェクトの数
+    int32_t GetProxyCount() const { return proxyCount_; }
+
+    /// <summary>
+    /// AABB と重なるプロキシを列挙する(太らせた AABB で判定する)
+    /// </summary>
+    /// <param name="callback">bool(int32_t proxyId)。false を返すと終了する</param>
+    template <typename Callback>
+    void Query(const AABB& aabb, Callback&& callback) const;
+
+    /// <summary>
+    /// 線分と交わるプロキシを列挙する(太らせた AABB で判定する)
+    /// </summary>
+    /// <param name="callback">
+    /// float(int32_t proxyId, const Segment& segment)。
+    /// 衝突した位置の t(0 ~ 1)を返すとそれより先の判定を省く。0 を返すと終了し、負の値なら無視して続ける
+    /// </param>
+    template <typename Callback>
+    void RayCast(const Segment& segment, Callback&& callback) const;
+
+    /// <summary>
+    /// 前回の呼び出しから追加・移動(木を更新)したプロキシが関わる衝突候補を列挙する
+    /// 動いていないプロキシ同士の組は出力しないので、前回までに見つけた組は呼び出し側で保持する
+    /// (その組は太らせた AABB が離れたかどうかで削除する)
+    /// </summary>
+    /// <param name="pairs">出力先(クリアしてから追加する)。値は userData</param>
+    void FindMovedPairs(std::vector<CollisionPair>& pairs);
+
+    /// <summary>
+    /// 太らせた AABB が重なるすべての組を列挙する
+    /// </summary>
+    /// <param name="pairs">出力先(クリアしてから追加する)。値は userData</param>
+    void FindPairs(std::vector<CollisionPair>& pairs) const;
+
+private:
+    struct Node {
+        AABB aabb;
+        int32_t parent; //!< 親(空きノードでは次の空きノード)
+        int32_t child1;
+        int32_t child2;
+        int32_t height; //!< 葉は0、空きノードは-1
+        uint32_t userData;
+        bool moved; //!< FindMovedPairs で処理していない移動があるか
+
+        bool IsLeaf() const { return child1 == kNullNode; }
+    };
+
+    // 走査用のスタック(ほとんどの場合は固定長の配列で足りる)
+    class NodeStack {
+    public:
+        void Push(int32_t nodeId)
+        {
+            if (count_ < kFixedCapacity) {
+                fixed_[count_] = nodeId;
+            } else {
+                overflow_.push_back(nodeId);
+            }
+            ++count_;
+        }
+
+        int32_t Pop()
+        {
+            --count_;
+            if (count_ < kFixedCapacity) {
+                return fixed_[count_];
+            }
+            int32_t nodeId = overflow_.back();
+            overflow_.pop_back();
+            return nodeId;
+        }
+
+        bool Empty() const { return count_ == 0; }
+
+    private:
+        static constexpr size_t kFixedCapacity = 128;
+        int32_t fixed_[kFixedCapacity];
+        size_t count_ = 0;
+        std::vector<int32_t> overflow_;
+    };
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t nodeId);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    int32_t Balance(int32_t nodeId);
+    void Refit(int32_t nodeId);
+
+    // 線分(t が 0 ~ maxT の範囲)と AABB が交わるか
+    static bool IntersectSegment(const AABB& aabb, const PreparedSegment& segment, float maxT);
+
+    std::vector<Node> nodes_;
+    int32_t root_ = kNullNode;
+    int32_t freeList_ = kNullNode;
+    int32_t proxyCount_ = 0;
+    float margin_;
+    std::vector<int32_t> moveBuffer_; //!< FindMovedPairs で処理するプロキシ
+};
+
+template <typename Callback>
+void DynamicAABBTree::Query(const AABB& aabb, Callback&& callback) const
+{
+    NodeStack stack;
+    stack.Push(root_);
+
+    while (!stack.Empty()) {
+        int32_t nodeId = stack.Pop();
+        if (nodeId == kNullNode) {
+            continue;
+        }
+
+        const Node& node = nodes_[nodeId];
+        if (!IsCollision(node.aabb, aabb)) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            if (!callback(nodeId)) {
+                return;
+            }
+        } else {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+template <typename Callback>
+void DynamicAABBTree::RayCast(const Segment& segment, Callback&& callback) const
+{
+    float maxT = 1.0f;
+    PreparedSegment preparedSegment = MakePreparedSegment(segment);
+
+    NodeStack stack;
+    stack.Push(root_);
+
+    while (!stack.Empty()) {
+        int32_t nodeId = stack.Pop();
+        if (nodeId == kNullNode) {
+            continue;
+        }
+
+        const Node& node = nodes_[nodeId];
+        if (!IntersectSegment(node.aabb, preparedSegment, maxT)) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            float t = callback(nodeId, segment);
+            if (t == 0.0f) {
+                return;
+            }
+            if (t > 0.0f && t < maxT) {
+                maxT = t;
+            }
+        } else {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
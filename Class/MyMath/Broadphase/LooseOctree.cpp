@@ -0,0 +1,143 @@
+#include "LooseOctree.h"
+#include <array>
+
+void LooseOctree::Build(std::span<const AABB> bounds)
+{
+    nodes_.clear();
+    objectBounds_.clear();
+    objectIndices_.clear();
+    if (bounds.empty()) {
+        return;
+    }
+
+    // 根のセルはオブジェクトの中心をすべて含む立方体
+    AABB centerBounds = { (bounds[0].min + bounds[0].max) * 0.5f, (bounds[0].min + bounds[0].max) * 0.5f };
+    std::vector<BuildObject> objects(bounds.size());
+    for (uint32_t i = 0; i < bounds.size(); ++i) {
+        Vector3 center = (bounds[i].min + bounds[i].max) * 0.5f;
+        centerBounds = Combine(centerBounds, center);
+        objects[i].center = center;
+        objects[i].index = i;
+    }
+    Vector3 centerExtent = centerBounds.max - centerBounds.min;
+    float rootHalfSize = std::max(std::max(centerExtent.x, centerExtent.y), centerExtent.z) * 0.5f;
+
+    // 根に置く大きなオブジェクトも根のルーズ境界に収まるようにする
+    for (BuildObject& object : objects) {
+        const AABB& aabb = bounds[object.index];
+        float halfSize = std::max(std::max(aabb.max.x - aabb.min.x, aabb.max.y - aabb.min.y), aabb.max.z - aabb.min.z) * 0.5f;
+        rootHalfSize = std::max(rootHalfSize, halfSize);
+    }
+    rootHalfSize = std::max(rootHalfSize, 1e-4f);
+
+    // 置く階層は、大きさ(一辺の半分)がセルの一辺の半分以下になる最も深い階層
+    // 中心がセル内にあれば、セルの2倍のルーズ境界からはみ出さない
+    for (BuildObject& object : objects) {
+        const AABB& aabb = bounds[object.index];
+        float halfSize = std::max(std::max(aabb.max.x - aabb.min.x, aabb.max.y - aabb.min.y), aabb.max.z - aabb.min.z) * 0.5f;
+        int level = 0;
+        float cellHalfSize = rootHalfSize;
+        while (level < kMaxDepth && cellHalfSize * 0.5f >= halfSize) {
+            cellHalfSize *= 0.5f;
+            ++level;
+        }
+        object.level = level;
+    }
+
+    nodes_.reserve(bounds.size() / kMaxLeafObjectCount * 2 + 1);
+    objectBounds_.reserve(bounds.size());
+    objectIndices_.reserve(bounds.size());
+
+    Node root {};
+    root.center = (centerBounds.min + centerBounds.max) * 0.5f;
+    root.looseHalfSize = rootHalfSize * 2.0f;
+    nodes_.push_back(root);
+    BuildNode(0, 0, objects, bounds);
+}
+
+void LooseOctree::Build(std::span<const Sphere> spheres)
+{
+    std::vector<AABB> bounds(spheres.size());
+    for (size_t i = 0; i < spheres.size(); ++i) {
+        Vector3 extent = { spheres[i].radius, spheres[i].radius, spheres[i].radius };
+        bounds[i] = { spheres[i].center - extent, spheres[i].center + extent };
+    }
+    Build(bounds);
+}
+
+void LooseOctree::Build(std::span<const Triangle> triangles)
+{
+    std::vector<AABB> bounds(triangles.size());
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const Vector3* v = triangles[i].vertices;
+        bounds[i] = {
+            { std::min({ v[0].x, v[1].x, v[2].x }), std::min({ v[0].y, v[1].y, v[2].y }), std::min({ v[0].z, v[1].z, v[2].z }) },
+            { std::max({ v[0].x, v[1].x, v[2].x }), std::max({ v[0].y, v[1].y, v[2].y }), std::max({ v[0].z, v[1].z, v[2].z }) }
+        };
+    }
+    Build(bounds);
+}
+
+void LooseOctree::BuildNode(uint32_t nodeIndex, int level, std::span<BuildObject> objects, std::span<const AABB> bounds)
+{
+    Vector3 center = nodes_[nodeIndex].center;
+    float childHalfSize = nodes_[nodeIndex].looseHalfSize * 0.25f;
+
+    // この階層に置くものを前に集める(少なければ分割せずにすべて置く)
+    auto stayEnd = objects.end();
+    if (objects.size() > kMaxLeafObjectCount && level < kMaxDepth) {
+        stayEnd = std::partition(objects.begin(), objects.end(), [&](const BuildObject& object) { return object.level <= level; });
+    }
+
+    Node& node = nodes_[nodeIndex];
+    node.firstObject = static_cast<uint32_t>(objectIndices_.size());
+    node.objectCount = static_cast<uint32_t>(stayEnd - objects.begin());
+    for (auto it = objects.begin(); it != stayEnd; ++it) {
+        objectBounds_.push_back(bounds[it->index]);
+        objectIndices_.push_back(it->index);
+    }
+
+    // 残りを中心のある八分領域の順に並べる(x, y, z が中心以上なら 1, 2, 4 のビット)
+    // z, y, x のビットの順に2つに分けていく
+    std::span<BuildObject> rest(stayEnd, objects.end());
+    std::array<size_t, 9> octantBegins = {};
+    octantBegins[8] = rest.size();
+    for (int bit = 4; bit >= 1; bit /= 2) {
+        for (int octant = 0; octant < 8; octant += bit * 2) {
+            auto begin = rest.begin() + octantBegins[octant];
+            auto end = rest.begin() + octantBegins[octant + bit * 2];
+            auto middle = std::partition(begin, end, [&](const BuildObject& object) {
+                float value = bit == 1 ? object.center.x : (bit == 2 ? object.center.y : object.center.z);
+                float centerValue = bit == 1 ? center.x : (bit == 2 ? center.y : center.z);
+                return value < centerValue;
+            });
+            octantBegins[octant + bit] = static_cast<size_t>(middle - rest.begin());
+        }
+    }
+
+    // 空でない子を連続して確保してから、それぞれを分割する
+    uint32_t firstChild = static_cast<uint32_t>(nodes_.size());
+    uint32_t childCount = 0;
+    int childOctants[8];
+    for (int octant = 0; octant < 8; ++octant) {
+        if (octantBegins[octant + 1] == octantBegins[octant]) {
+            continue;
+        }
+        Node child {};
+        child.center = {
+            center.x + ((octant & 1) ? childHalfSize : -childHalfSize),
+            center.y + ((octant & 2) ? childHalfSize : -childHalfSize),
+            center.z + ((octant & 4) ? childHalfSize : -childHalfSize)
+        };
+        child.looseHalfSize = childHalfSize * 2.0f;
+        nodes_.push_back(child);
+        childOctants[childCount++] = octant;
+    }
+    nodes_[nodeIndex].firstChild = firstChild;
+    nodes_[nodeIndex].childCount = childCount;
+
+    for (uint32_t i = 0; i < childCount; ++i) {
+        int octant = childOctants[i];
+        BuildNode(firstChild + i, level + 1, rest.subspan(octantBegins[octant], octantBegins[octant + 1] - octantBegins[octant]), bounds);
+    }
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "../MyCollision.h"
+#include "../MyMath.h"
+#include "../SegmentPacket.h"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 静的なオブジェクト用のルーズ八分木
+/// 各ノードの判定範囲を、セルの2倍の大きさ(ルーズ境界)にする
+/// オブジェクトは、大きさがセルの半分の大きさ以下になる最も深い階層で、中心を含むセルに置く
+/// (セルの境界をまたぐオブジェクトも必ず1つのノードに収まり、分割し直す必要がない)
+/// 構築は配列からの一括構築のみで、ノードは子を連続して並べた1つの配列に、オブジェクトはノードの順に並べ替えて持つ
+/// </summary>
+class LooseOctree {
+public:
+    // 最大の深さ
+    static constexpr int kMaxDepth = 16;
+    // これ以下のオブジェクトしかない部分は分割しない
+    static constexpr uint32_t kMaxLeafObjectCount = 8;
+
+    /// <summary>
+    /// オブジェクトの AABB の配列から構築する
+    /// </summary>
+    /// <param name="bounds">オブジェクトの AABB(Query などで渡される番号はこの配列の添字)</param>
+    void Build(std::span<const AABB> bounds);
+
+    // 球の配列から構築する
+    void Build(std::span<const Sphere> spheres);
+
+    // 三角形の配列から構築する
+    void Build(std::span<const Triangle> triangles);
+
+    /// <summary>
+    /// AABB と重なるオブジェクトを列挙する(オブジェクトの AABB で判定する)
+    /// </summary>
+    /// <param name="callback">bool(uint32_t objectIndex)。false を返すと終了する</param>
+    template <typename Callback>
+    void Query(const AABB& aabb, Callback&& callback) const;
+
+    /// <summary>
+    /// 球と重なるオブジェクトを列挙する(オブジェクトの AABB で判定する)
+    /// </summary>
+    /// <param name="callback">bool(uint32_t objectIndex)。false を返すと終了する</param>
+    template <typename Callback>
+    void Query(const Sphere& sphere, Callback&& callback) const;
+
+    /// <summary>
+    /// 線分と交わるオブジェクトを、近いノードから順に列挙する(オブジェクトの AABB で判定する)
+    /// </summary>
+    /// <param name="callback">
+    /// float(uint32_t objectIndex, const Segment& segment)。
+    /// 衝突した位置の t(0 ~ 1)を返すとそれより先の判定を省く。0 を返すと終了し、負の値なら無視して続ける
+    /// </param>
+    template <typename Callback>
+    void RayCast(const Segment& segment, Callback&& callback) const;
+
+    // オブジェクトの数
+    size_t GetObjectCount() const { return objectIndices_.size(); }
+
+    // ノードの数
+    size_t GetNodeCount() const { return nodes_.size(); }
+
+private:
+    // 32バイトのノード。子は firstChild から childCount 個並ぶ
+    struct Node {
+        Vector3 center; //!< セルの中心
+        float looseHalfSize; //!< ルーズ境界の一辺の半分(セルの一辺と同じ)
+        uint32_t firstChild;
+        uint32_t childCount;
+        uint32_t firstObject; //!< このノードに置いたオブジェクトの最初の添字
+        uint32_t objectCount;
+
+        AABB GetLooseBounds() const
+        {
+            Vector3 extent = { looseHalfSize, looseHalfSize, looseHalfSize };
+            return { center - extent, center + extent };
+        }
+    };
+
+    // オブジェクトの並べ替え用
+    struct BuildObject {
+        Vector3 center;
+        int level; //!< 置く階層
+        uint32_t index;
+    };
+
+    void BuildNode(uint32_t nodeIndex, int level, std::span<BuildObject> objects, std::span<const AABB> bounds);
+
+    // 走査用のスタック(ノードを1つ取り出すと最大8つ積むので、深さ x 7 + 1 で足りる)
+    static constexpr size_t kStackCapacity = kMaxDepth * 7 + 8;
+
+    std::vector<Node> nodes_;
+    std::vector<AABB> objectBounds_; //!< ノードの順に並べ替えたオブジェクトの AABB
+    std::vector<uint32_t> objectIndices_; //!< 並べ替え後のオブジェクトの元の添字
+};
+
+template <typename Callback>
+void LooseOctree::Query(const AABB& aabb, Callback&& callback) const
+{
+    if (nodes_.empty()) {
+        return;
+    }
+
+    uint32_t stack[kStackCapacity];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = nodes_[stack[--stackSize]];
+
+        for (uint32_t i = node.firstObject; i < node.firstObject + node.objectCount; ++i) {
+            if (IsCollision(objectBounds_[i], aabb) && !callback(objectIndices_[i])) {
+                return;
+            }
+        }
+
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child) {
+            if (IsCollision(nodes_[child].GetLooseBounds(), aabb)) {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+}
+
+template <typename Callback>
+void LooseOctree::Query(const Sphere& sphere, Callback&& callback) const
+{
+    if (nodes_.empty()) {
+        return;
+    }
+
+    uint32_t stack[kStackCapacity];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = nodes_[stack[--stackSize]];
+
+        for (uint32_t i = node.firstObject; i < node.firstObject + node.objectCount; ++i) {
+            if (IsCollision(sphere, objectBounds_[i]) && !callback(objectIndices_[i])) {
+                return;
+            }
+        }
+
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child) {
+            if (IsCollision(sphere, nodes_[child].GetLooseBounds())) {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+}
+
+template <typename Callback>
+void LooseOctree::RayCast(const Segment& segment, Callback&& callback) const
+{
+    if (nodes_.empty()) {
+        return;
+    }
+
+    PreparedSegment preparedSegment = MakePreparedSegment(segment);
+    float maxT = 1.0f;
+    AABB rootBounds = nodes_[0].GetLooseBounds();
+    if (SegmentEnterT(preparedSegment, rootBounds.min, rootBounds.max, maxT) > maxT) {
+        return;
+    }
+
+    // ノードと、そこに入る t
+    struct Entry {
+        uint32_t nodeIndex;
+        float t;
+    };
+    Entry stack[kStackCapacity];
+    size_t stackSize = 0;
+    stack[stackSize++] = { 0, 0.0f };
+
+    while (stackSize > 0) {
+        Entry entry = stack[--stackSize];
+        // 積んだあとで、より近い衝突が見つかったノードは調べない
+        if (entry.t > maxT) {
+            continue;
+        }
+        const Node& node = nodes_[entry.nodeIndex];
+
+        for (uint32_t i = node.firstObject; i < node.firstObject + node.objectCount; ++i) {
+            if (SegmentEnterT(preparedSegment, objectBounds_[i].min, objectBounds_[i].max, maxT) > maxT) {
+                continue;
+            }
+            float t = callback(objectIndices_[i], segment);
+            if (t == 0.0f) {
+                return;
+            }
+            if (t > 0.0f) {
+                maxT = std::min(maxT, t);
+            }
+        }
+
+        // 遠い子から積んで、近い子から取り出す
+        size_t childBegin = stackSize;
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child) {
+            AABB childBounds = nodes_[child].GetLooseBounds();
+            float t = SegmentEnterT(preparedSegment, childBounds.min, childBounds.max, maxT);
+            if (t <= maxT) {
+                stack[stackSize++] = { child, t };
+            }
+        }
+        std::sort(stack + childBegin, stack + stackSize, [](const Entry& e1, const Entry& e2) { return e1.t > e2.t; });
+    }
+}
@@ -0,0 +1,237 @@
+#include "SpatialHashGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// セルの大きさを決める半径の分位(これより大きい球だけを別に判定する)
+const float kCellSizeRadiusQuantile = 0.99f;
+
+// 挿入ソートで動かす量がこの数(球1つあたり)を超えたら通常のソートに切り替える
+const size_t kMaxInsertionMovesPerSphere = 8;
+
+// キーの各軸のビット数と、負の座標を扱うためのオフセット
+const int kKeyAxisBits = 21;
+const int32_t kKeyAxisBias = 1 << (kKeyAxisBits - 1);
+const int32_t kKeyAxisLimit = kKeyAxisBias - 2; // 隣接セル(±1)のキーも桁あふれしない範囲
+
+// 1セル分のキーの差
+const uint64_t kKeyStepX = 1;
+const uint64_t kKeyStepY = uint64_t(1) << kKeyAxisBits;
+const uint64_t kKeyStepZ = uint64_t(1) << (kKeyAxisBits * 2);
+
+// 重複しないように選んだ前方の隣接行(y, z が異なる行。x は -1 ~ +1 のセルを含む)
+// 残りの行と、同じ行の -x 側のセルは相手側から見つかる
+const uint64_t kForwardRowOffsets[4] = {
+    kKeyStepY,
+    kKeyStepZ - kKeyStepY,
+    kKeyStepZ,
+    kKeyStepZ + kKeyStepY,
+};
+
+// 2つの球の AABB が重なるか
+bool IsOverlapAABB(const Sphere& s1, const Sphere& s2)
+{
+    float radius = s1.radius + s2.radius;
+    return fabsf(s1.center.x - s2.center.x) <= radius
+        && fabsf(s1.center.y - s2.center.y) <= radius
+        && fabsf(s1.center.z - s2.center.z) <= radius;
+}
+
+// 軸1つ分のセル座標
+uint64_t ComputeAxisKey(float value, float invCellSize)
+{
+    float cell = std::floor(value * invCellSize);
+    cell = std::clamp(cell, static_cast<float>(-kKeyAxisLimit), static_cast<float>(kKeyAxisLimit));
+    return static_cast<uint64_t>(static_cast<int32_t>(cell) + kKeyAxisBias);
+}
+
+} // namespace
+
+void SpatialHashGrid::Build(std::span<const Sphere> spheres, float cellSize)
+{
+    // 半径の分布からセルの大きさを決める(ほとんどの球の直径以上にする)
+    if (cellSize <= 0.0f) {
+        cellSize = 1.0f;
+        if (!spheres.empty()) {
+            std::vector<float> radii(spheres.size());
+            for (size_t i = 0; i < spheres.size(); ++i) {
+                radii[i] = spheres[i].radius;
+            }
+            size_t quantileIndex = static_cast<size_t>(static_cast<float>(radii.size() - 1) * kCellSizeRadiusQuantile);
+            std::nth_element(radii.begin(), radii.begin() + quantileIndex, radii.end());
+            if (radii[quantileIndex] > 0.0f) {
+                cellSize = radii[quantileIndex] * 2.0f;
+            }
+        }
+    }
+
+    cellSize_ = cellSize;
+    invCellSize_ = 1.0f / cellSize;
+    maxGridRadius_ = cellSize * 0.5f;
+
+    entries_.resize(spheres.size());
+    for (uint32_t i = 0; i < spheres.size(); ++i) {
+        entries_[i] = { ComputeKey(spheres[i].center), i, spheres[i] };
+    }
+
+    std::sort(entries_.begin(), entries_.end(), [](const Entry& e1, const Entry& e2) { return e1.key < e2.key; });
+}
+
+void SpatialHashGrid::Update(std::span<const Sphere> spheres)
+{
+    if (spheres.size() != entries_.size()) {
+        Build(spheres);
+        return;
+    }
+
+    for (Entry& entry : entries_) {
+        entry.sphere = spheres[entry.index];
+        entry.key = ComputeKey(entry.sphere.center);
+    }
+
+    // 1フレームでセルをまたぐ球は少ないので、ほぼ整列済みの配列を挿入ソートで並べ直す
+    size_t moveCount = 0;
+    size_t maxMoveCount = entries_.size() * kMaxInsertionMovesPerSphere;
+    for (size_t i = 1; i < entries_.size(); ++i) {
+        if (entries_[i - 1].key <= entries_[i].key) {
+            continue;
+        }
+
+        Entry entry = entries_[i];
+        size_t j = i;
+        for (; j > 0 && entry.key < entries_[j - 1].key; --j) {
+            entries_[j] = entries_[j - 1];
+        }
+        entries_[j] = entry;
+
+        // 大きく動いた場合(ワープなど)は通常のソートの方が速い
+        moveCount += i - j;
+        if (moveCount > maxMoveCount) {
+            std::sort(entries_.begin(), entries_.end(), [](const Entry& e1, const Entry& e2) { return e1.key < e2.key; });
+            break;
+        }
+    }
+}
+
+void SpatialHashGrid::FindPairs(std::vector<CollisionPair>& pairs) const
+{
+    pairs.clear();
+
+    size_t count = entries_.size();
+
+    // 前方の各行の走査位置(セルをキー順にたどると、対応する行の位置も前にしか進まない)
+    size_t rowCursors[4] = { 0, 0, 0, 0 };
+
+    size_t cellBegin = 0;
+    while (cellBegin < count) {
+        uint64_t key = entries_[cellBegin].key;
+
+        size_t cellEnd = cellBegin + 1;
+        while (cellEnd < count && entries_[cellEnd].key == key) {
+            ++cellEnd;
+        }
+
+        // 同じ行の +x 側のセルはキー順で直後に並んでいる
+        size_t rowEnd = cellEnd;
+        while (rowEnd < count && entries_[rowEnd].key == key + kKeyStepX) {
+            ++rowEnd;
+        }
+
+        // 前方の行の x-1 ~ x+1 のセルの範囲
+        size_t rowBegins[4];
+        size_t rowEnds[4];
+        for (int row = 0; row < 4; ++row) {
+            uint64_t rowKey = key + kForwardRowOffsets[row];
+            size_t& cursor = rowCursors[row];
+            while (cursor < count && entries_[cursor].key < rowKey - kKeyStepX) {
+                ++cursor;
+            }
+            size_t end = cursor;
+            while (end < count && entries_[end].key <= rowKey + kKeyStepX) {
+                ++end;
+            }
+            rowBegins[row] = cursor;
+            rowEnds[row] = end;
+        }
+
+        for (size_t i = cellBegin; i < cellEnd; ++i) {
+            const Entry& entry1 = entries_[i];
+            if (entry1.sphere.radius > maxGridRadius_) {
+                continue;
+            }
+
+            // 同じセルの後ろ側と +x 側のセル
+            for (size_t j = i + 1; j < rowEnd; ++j) {
+                const Entry& entry2 = entries_[j];
+                if (entry2.sphere.radius <= maxGridRadius_ && IsOverlapAABB(entry1.sphere, entry2.sphere)) {
+                    pairs.push_back(MakePair(entry1.index, entry2.index));
+                }
+            }
+
+            // 前方の行
+            for (int row = 0; row < 4; ++row) {
+                for (size_t j = rowBegins[row]; j < rowEnds[row]; ++j) {
+                    const Entry& entry2 = entries_[j];
+                    if (entry2.sphere.radius <= maxGridRadius_ && IsOverlapAABB(entry1.sphere, entry2.sphere)) {
+                        pairs.push_back(MakePair(entry1.index, entry2.index));
+                    }
+                }
+            }
+        }
+
+        cellBegin = cellEnd;
+    }
+
+    // セルより大きい球(全体の1%程度)
+    std::vector<const Entry*> largeEntries;
+    for (const Entry& entry : entries_) {
+        if (entry.sphere.radius > maxGridRadius_) {
+            FindLargeSpherePairs(entry, pairs);
+            largeEntries.push_back(&entry);
+        }
+    }
+
+    // 大きい球同士は総当たり
+    for (size_t i = 0; i < largeEntries.size(); ++i) {
+        for (size_t j = i + 1; j < largeEntries.size(); ++j) {
+            if (IsOverlapAABB(largeEntries[i]->sphere, largeEntries[j]->sphere)) {
+                pairs.push_back(MakePair(largeEntries[i]->index, largeEntries[j]->index));
+            }
+        }
+    }
+}
+
+uint64_t SpatialHashGrid::ComputeKey(const Vector3& position) const
+{
+    return ComputeAxisKey(position.z, invCellSize_) * kKeyStepZ
+        + ComputeAxisKey(position.y, invCellSize_) * kKeyStepY
+        + ComputeAxisKey(position.x, invCellSize_);
+}
+
+void SpatialHashGrid::FindLargeSpherePairs(const Entry& large, std::vector<CollisionPair>& pairs) const
+{
+    // 相手(半径は maxGridRadius_ 以下)の中心が入りうるセルの範囲
+    float reach = large.sphere.radius + maxGridRadius_;
+    uint64_t minX = ComputeAxisKey(large.sphere.center.x - reach, invCellSize_);
+    uint64_t maxX = ComputeAxisKey(large.sphere.center.x + reach, invCellSize_);
+    uint64_t minY = ComputeAxisKey(large.sphere.center.y - reach, invCellSize_);
+    uint64_t maxY = ComputeAxisKey(large.sphere.center.y + reach, invCellSize_);
+    uint64_t minZ = ComputeAxisKey(large.sphere.center.z - reach, invCellSize_);
+    uint64_t maxZ = ComputeAxisKey(large.sphere.center.z + reach, invCellSize_);
+
+    for (uint64_t z = minZ; z <= maxZ; ++z) {
+        for (uint64_t y = minY; y <= maxY; ++y) {
+            // 1行分(x が minX ~ maxX)はキー順で連続している
+            uint64_t rowKey = z * kKeyStepZ + y * kKeyStepY;
+            auto it = std::lower_bound(entries_.begin(), entries_.end(), rowKey + minX,
+                [](const Entry& entry, uint64_t key) { return entry.key < key; });
+
+            for (; it != entries_.end() && it->key <= rowKey + maxX; ++it) {
+                if (it->sphere.radius <= maxGridRadius_ && IsOverlapAABB(large.sphere, it->sphere)) {
+                    pairs.push_back(MakePair(large.index, it->index));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../MyMath.h"
+#include "CollisionPair.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 一様グリッドによる球のブロードフェーズ
+/// 各球を中心のあるセルに割り当て、セル座標のキー順に並べた配列で隣接セルの球同士を衝突候補とする
+/// (ハッシュ表を引かずに配列を前から順に走査するだけで隣接セルがたどれる)
+/// セルの大きさはほとんどの球の直径以上に自動調整し、それより大きい球だけ別に扱う
+/// 移動後は Update でキーを更新し、ほぼ整列済みの配列を挿入ソートで並べ直す
+/// </summary>
+class SpatialHashGrid {
+public:
+    /// <summary>
+    /// すべての球を登録し直す
+    /// </summary>
+    /// <param name="spheres">球の配列(以降の Update, FindPairs でも同じ並びで渡す)</param>
+    /// <param name="cellSize">セルの一辺の長さ(0以下なら半径の分布から自動で決める)</param>
+    void Build(std::span<const Sphere> spheres, float cellSize = 0.0f);
+
+    /// <summary>
+    /// 移動した球の登録を更新する(セルが変わった球だけが並び替えで移動する)
+    /// 球の数が変わった場合は Build し直す。半径の分布が大きく変わった場合も Build し直すと良い
+    /// </summary>
+    void Update(std::span<const Sphere> spheres);
+
+    /// <summary>
+    /// 衝突候補(AABB が重なる組)を列挙する。各組は1回だけ出力される
+    /// Build, Update のあとに球を動かした場合、その移動は反映されない
+    /// </summary>
+    /// <param name="pairs">出力先(クリアしてから追加する)</param>
+    void FindPairs(std::vector<CollisionPair>& pairs) const;
+
+    // セルの一辺の長さ
+    float GetCellSize() const { return cellSize_; }
+
+private:
+    // セル座標のキー順に並べる要素
+    struct Entry {
+        uint64_t key; //!< セル座標を z, y, x の順に詰めたもの
+        uint32_t index; //!< 入力配列での添字
+        Sphere sphere;
+    };
+
+    uint64_t ComputeKey(const Vector3& position) const;
+    void FindLargeSpherePairs(const Entry& large, std::vector<CollisionPair>& pairs) const;
+
+    float cellSize_ = 1.0f;
+    float invCellSize_ = 1.0f;
+    float maxGridRadius_ = 0.5f; //!< 隣接セルだけで判定できる半径の上限(セルの半分)
+    std::vector<Entry> entries_; //!< キー順に並べた球
+};
@@ -0,0 +1,150 @@
+#include "SweepAndPrune.h"
+#include "../MyCollision.h"
+#include <algorithm>
+
+namespace {
+
+// 組のキー(小さい番号が上位)
+uint64_t MakePairKey(uint32_t index1, uint32_t index2)
+{
+    uint32_t first = std::min(index1, index2);
+    uint32_t second = std::max(index1, index2);
+    return (static_cast<uint64_t>(first) << 32) | second;
+}
+
+CollisionPair MakePair(uint64_t key)
+{
+    return { static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key) };
+}
+
+} // namespace
+
+void SweepAndPrune::Build(std::span<const AABB> boxes)
+{
+    addedPairs_.clear();
+    removedPairs_.clear();
+    for (uint64_t key : pairs_) {
+        removedPairs_.push_back(MakePair(key));
+    }
+    pairs_.clear();
+
+    boxes_.assign(boxes.begin(), boxes.end());
+
+    for (int axis = 0; axis < 3; ++axis) {
+        std::vector<Endpoint>& endpoints = endpoints_[axis];
+        endpoints.resize(boxes_.size() * 2);
+        for (uint32_t i = 0; i < boxes_.size(); ++i) {
+            endpoints[i * 2] = { AxisValue(boxes_[i].min, axis), i << 1 };
+            endpoints[i * 2 + 1] = { AxisValue(boxes_[i].max, axis), (i << 1) | 1 };
+        }
+        std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint& e1, const Endpoint& e2) { return e1.Precedes(e2); });
+    }
+
+    // x 軸を掃引して、区間が重なっている AABB 同士を調べる
+    std::vector<uint32_t> activeBoxes;
+    for (const Endpoint& endpoint : endpoints_[0]) {
+        uint32_t boxIndex = endpoint.BoxIndex();
+        if (endpoint.IsMax()) {
+            activeBoxes.erase(std::find(activeBoxes.begin(), activeBoxes.end(), boxIndex));
+            continue;
+        }
+
+        for (uint32_t activeIndex : activeBoxes) {
+            if (IsCollision(boxes_[boxIndex], boxes_[activeIndex])) {
+                uint64_t key = MakePairKey(boxIndex, activeIndex);
+                pairs_.insert(key);
+                addedPairs_.push_back(MakePair(key));
+            }
+        }
+        activeBoxes.push_back(boxIndex);
+    }
+}
+
+void SweepAndPrune::Update(std::span<const AABB> boxes)
+{
+    if (boxes.size() != boxes_.size()) {
+        Build(boxes);
+        return;
+    }
+
+    addedPairs_.clear();
+    removedPairs_.clear();
+    touchedPairs_.clear();
+
+    boxes_.swap(previousBoxes_);
+    boxes_.assign(boxes.begin(), boxes.end());
+
+    for (int axis = 0; axis < 3; ++axis) {
+        std::vector<Endpoint>& endpoints = endpoints_[axis];
+
+        for (Endpoint& endpoint : endpoints) {
+            const AABB& box = boxes_[endpoint.BoxIndex()];
+            endpoint.value = AxisValue(endpoint.IsMax() ? box.max : box.min, axis);
+        }
+
+        // 挿入ソート。左へ動く端点が追い越した端点との関係だけが変わる
+        for (size_t i = 1; i < endpoints.size(); ++i) {
+            Endpoint endpoint = endpoints[i];
+            size_t j = i;
+            while (j > 0) {
+                const Endpoint& other = endpoints[j - 1];
+                if (!endpoint.Precedes(other)) {
+                    break;
+                }
+
+                if (!endpoint.IsMax() && other.IsMax()) {
+                    // 最小点が相手の最大点を追い越した(この軸で重なり始めた)。全軸で重なっていれば組を作る
+                    if (IsCollision(boxes_[endpoint.BoxIndex()], boxes_[other.BoxIndex()])) {
+                        AddPair(endpoint.BoxIndex(), other.BoxIndex());
+                    }
+                } else if (endpoint.IsMax() && !other.IsMax()) {
+                    // 最大点が相手の最小点を追い越した(この軸で離れた)
+                    // 組があるのは前のフレームで重なっていた場合だけなので、それ以外は組の表を引かない
+                    if (IsCollision(previousBoxes_[endpoint.BoxIndex()], previousBoxes_[other.BoxIndex()])) {
+                        RemovePair(endpoint.BoxIndex(), other.BoxIndex());
+                    }
+                }
+
+                endpoints[j] = other;
+                --j;
+            }
+            endpoints[j] = endpoint;
+        }
+    }
+
+    // 最初と最後で状態が変わった組だけをイベントにする(別の軸で重なって離れた組などを除く)
+    for (const auto& [key, wasOverlapping] : touchedPairs_) {
+        bool isOverlapping = pairs_.contains(key);
+        if (isOverlapping && !wasOverlapping) {
+            addedPairs_.push_back(MakePair(key));
+        } else if (!isOverlapping && wasOverlapping) {
+            removedPairs_.push_back(MakePair(key));
+        }
+    }
+}
+
+bool SweepAndPrune::IsOverlapping(uint32_t index1, uint32_t index2) const
+{
+    return pairs_.contains(MakePairKey(index1, index2));
+}
+
+void SweepAndPrune::AddPair(uint32_t index1, uint32_t index2)
+{
+    uint64_t key = MakePairKey(index1, index2);
+    TouchPair(key);
+    pairs_.insert(key);
+}
+
+void SweepAndPrune::RemovePair(uint32_t index1, uint32_t index2)
+{
+    uint64_t key = MakePairKey(index1, index2);
+    TouchPair(key);
+    pairs_.erase(key);
+}
+
+void SweepAndPrune::TouchPair(uint64_t key)
+{
+    if (!touchedPairs_.contains(key)) {
+        touchedPairs_.emplace(key, pairs_.contains(key));
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../MyMath.h"
+#include "CollisionPair.h"
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// <summary>
+/// Sweep and Prune(ブロードフェーズ)
+/// 各軸の AABB の端点を整列したまま保持し、フレーム間で少しずつ動く場合は挿入ソートで並べ直す
+/// 並べ直しで端点が入れ替わった組だけを調べ、重なり始めた組と離れた組をイベントとして出力する
+/// 動きが小さければ1フレームあたりほぼ O(n)
+/// </summary>
+class SweepAndPrune {
+public:
+    /// <summary>
+    /// すべての AABB を登録し直す
+    /// 以前の組はすべて GetRemovedPairs に、新しい組はすべて GetAddedPairs に入る
+    /// </summary>
+    /// <param name="boxes">AABB の配列(以降の Update でも同じ並びで渡す)</param>
+    void Build(std::span<const AABB> boxes);
+
+    /// <summary>
+    /// 移動した AABB で端点を並べ直し、前回から変化した組を求める
+    /// AABB の数が変わった場合は Build し直す
+    /// </summary>
+    void Update(std::span<const AABB> boxes);
+
+    // 直前の Build, Update で重なり始めた組
+    const std::vector<CollisionPair>& GetAddedPairs() const { return addedPairs_; }
+
+    // 直前の Build, Update で離れた組
+    const std::vector<CollisionPair>& GetRemovedPairs() const { return removedPairs_; }
+
+    // 重なっている組の数
+    size_t GetPairCount() const { return pairs_.size(); }
+
+    // 2つの AABB が重なっているか(登録済みの組を引くだけ)
+    bool IsOverlapping(uint32_t index1, uint32_t index2) const;
+
+private:
+    // 軸上の端点
+    struct Endpoint {
+        float value;
+        uint32_t data; //!< AABB の番号 << 1 | 最大点なら1
+
+        uint32_t BoxIndex() const { return data >> 1; }
+        bool IsMax() const { return (data & 1) != 0; }
+
+        // 整列順で前にあるか(同じ値なら最小点を先にして、接しているだけの場合も IsCollision と同じく重なりとみなす)
+        bool Precedes(const Endpoint& other) const
+        {
+            return value < other.value || (value == other.value && !IsMax() && other.IsMax());
+        }
+    };
+
+    void AddPair(uint32_t index1, uint32_t index2);
+    void RemovePair(uint32_t index1, uint32_t index2);
+    // 変化した組の最初の状態を覚えておく
+    void TouchPair(uint64_t key);
+
+    std::vector<AABB> boxes_;
+    std::vector<AABB> previousBoxes_; //!< Update 前の AABB(離れた組の候補を絞るのに使う)
+    std::vector<Endpoint> endpoints_[3]; //!< 軸ごとに整列した端点
+    std::unordered_set<uint64_t> pairs_; //!< 重なっている組(小さい番号 << 32 | 大きい番号)
+    std::unordered_map<uint64_t, bool> touchedPairs_; //!< Update 中に変化した組と、変化前に重なっていたか
+    std::vector<CollisionPair> addedPairs_;
+    std::vector<CollisionPair> removedPairs_;
+};
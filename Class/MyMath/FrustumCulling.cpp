@@ -0,0 +1,155 @@
+#include "FrustumCulling.h"
+#include "MyCollision.h"
+#include "SimdLane.h"
+#include <assert.h>
+#include <bit>
+#include <cmath>
+
+namespace {
+
+// 1つの平面の成分を全レーンに配ったもの
+struct PlaneLanes {
+    FloatLane normalX;
+    FloatLane normalY;
+    FloatLane normalZ;
+    FloatLane absNormalX;
+    FloatLane absNormalY;
+    FloatLane absNormalZ;
+    FloatLane distance;
+};
+
+// 視錐台の6平面を全レーンに配る
+struct FrustumLanes {
+    PlaneLanes planes[6];
+
+    explicit FrustumLanes(const Frustum& frustum)
+    {
+        for (size_t i = 0; i < 6; ++i) {
+            const Plane& plane = frustum.planes[i];
+            planes[i] = {
+                LaneSet(plane.normal.x),
+                LaneSet(plane.normal.y),
+                LaneSet(plane.normal.z),
+                LaneSet(std::fabs(plane.normal.x)),
+                LaneSet(std::fabs(plane.normal.y)),
+                LaneSet(std::fabs(plane.normal.z)),
+                LaneSet(plane.distance),
+            };
+        }
+    }
+};
+
+// レーン数分の物体(中心と広がりを成分ごとに並べたもの)
+struct ObjectLanes {
+    float centerX[kFloatLaneWidth];
+    float centerY[kFloatLaneWidth];
+    float centerZ[kFloatLaneWidth];
+    float extentX[kFloatLaneWidth]; //!< 球なら半径
+    float extentY[kFloatLaneWidth];
+    float extentZ[kFloatLaneWidth];
+};
+
+// レーンごとに1つの物体を6平面と判定し、見えるレーンのビットを返す
+// 射影半径は、球なら半径、AABB なら法線の絶対値と extent の内積
+template <bool kIsSphere>
+inline unsigned int VisibleLaneBits(const FrustumLanes& frustum, const ObjectLanes& objects)
+{
+    FloatLane centerX = LaneLoad(objects.centerX);
+    FloatLane centerY = LaneLoad(objects.centerY);
+    FloatLane centerZ = LaneLoad(objects.centerZ);
+    FloatLane extentX = LaneLoad(objects.extentX);
+    FloatLane extentY = LaneLoad(objects.extentY);
+    FloatLane extentZ = LaneLoad(objects.extentZ);
+
+    FloatLane zero = LaneSet(0.0f);
+    LaneMask isOutside = LaneLess(zero, zero); // どれかの平面の完全に外側にあるレーン(最初は無し)
+    for (const PlaneLanes& plane : frustum.planes) {
+        FloatLane distance = LaneSub(
+            LaneAdd(LaneAdd(LaneMul(plane.normalX, centerX), LaneMul(plane.normalY, centerY)), LaneMul(plane.normalZ, centerZ)),
+            plane.distance);
+
+        FloatLane radius;
+        if constexpr (kIsSphere) {
+            radius = extentX;
+        } else {
+            radius = LaneAdd(LaneAdd(LaneMul(plane.absNormalX, extentX), LaneMul(plane.absNormalY, extentY)), LaneMul(plane.absNormalZ, extentZ));
+        }
+
+        isOutside = LaneOr(isOutside, LaneLess(distance, LaneSub(zero, radius)));
+    }
+    return ~LaneMaskBits(isOutside) & ((1u << kFloatLaneWidth) - 1u);
+}
+
+// 見えるレーンのビットを1要素1バイトに書き出す
+inline size_t StoreVisibleMask(unsigned int visibleBits, std::span<uint8_t> visibleMask, size_t first)
+{
+    for (size_t lane = 0; lane < kFloatLaneWidth; ++lane) {
+        visibleMask[first + lane] = static_cast<uint8_t>((visibleBits >> lane) & 1u);
+    }
+    return static_cast<size_t>(std::popcount(visibleBits));
+}
+
+} // namespace
+
+size_t CullSpheres(std::span<const Sphere> spheres, const Frustum& frustum, std::span<uint8_t> visibleMask)
+{
+    assert(visibleMask.size() >= spheres.size());
+
+    FrustumLanes lanes(frustum);
+
+    size_t visibleCount = 0;
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= spheres.size(); i += kFloatLaneWidth) {
+        ObjectLanes objects;
+        for (size_t lane = 0; lane < kFloatLaneWidth; ++lane) {
+            const Sphere& sphere = spheres[i + lane];
+            objects.centerX[lane] = sphere.center.x;
+            objects.centerY[lane] = sphere.center.y;
+            objects.centerZ[lane] = sphere.center.z;
+            objects.extentX[lane] = sphere.radius;
+            objects.extentY[lane] = sphere.radius;
+            objects.extentZ[lane] = sphere.radius;
+        }
+        visibleCount += StoreVisibleMask(VisibleLaneBits<true>(lanes, objects), visibleMask, i);
+    }
+
+    // 端数
+    for (; i < spheres.size(); ++i) {
+        bool isVisible = IsCollision(spheres[i], frustum);
+        visibleMask[i] = isVisible ? 1 : 0;
+        visibleCount += isVisible ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+size_t CullAABBs(std::span<const AABB> aabbs, const Frustum& frustum, std::span<uint8_t> visibleMask)
+{
+    assert(visibleMask.size() >= aabbs.size());
+
+    FrustumLanes lanes(frustum);
+
+    size_t visibleCount = 0;
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= aabbs.size(); i += kFloatLaneWidth) {
+        ObjectLanes objects;
+        for (size_t lane = 0; lane < kFloatLaneWidth; ++lane) {
+            Vector3 center = (aabbs[i + lane].min + aabbs[i + lane].max) * 0.5f;
+            Vector3 extent = (aabbs[i + lane].max - aabbs[i + lane].min) * 0.5f;
+            objects.centerX[lane] = center.x;
+            objects.centerY[lane] = center.y;
+            objects.centerZ[lane] = center.z;
+            objects.extentX[lane] = extent.x;
+            objects.extentY[lane] = extent.y;
+            objects.extentZ[lane] = extent.z;
+        }
+        visibleCount += StoreVisibleMask(VisibleLaneBits<false>(lanes, objects), visibleMask, i);
+    }
+
+    // 端数
+    for (; i < aabbs.size(); ++i) {
+        bool isVisible = IsCollision(aabbs[i], frustum);
+        visibleMask[i] = isVisible ? 1 : 0;
+        visibleCount += isVisible ? 1 : 0;
+    }
+    return visibleCount;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "MyMath.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// 球の視錐台カリング(一括)
+/// IsCollision(Sphere, Frustum) と同じ判定を、球をSIMDのレーンに並べてまとめて行う(端数は1個ずつ)
+/// </summary>
+/// <param name="spheres">判定する球の配列</param>
+/// <param name="frustum">視錐台</param>
+/// <param name="visibleMask">出力先(見えるなら1、見えないなら0。要素数は spheres 以上)</param>
+/// <returns>見える球の数</returns>
+size_t CullSpheres(std::span<const Sphere> spheres, const Frustum& frustum, std::span<uint8_t> visibleMask);
+
+/// <summary>
+/// AABBの視錐台カリング(一括)
+/// IsCollision(AABB, Frustum) と同じ判定を、AABBをSIMDのレーンに並べてまとめて行う(端数は1個ずつ)
+/// </summary>
+/// <param name="aabbs">判定するAABBの配列</param>
+/// <param name="frustum">視錐台</param>
+/// <param name="visibleMask">出力先(見えるなら1、見えないなら0。要素数は aabbs 以上)</param>
+/// <returns>見えるAABBの数</returns>
+size_t CullAABBs(std::span<const AABB> aabbs, const Frustum& frustum, std::span<uint8_t> visibleMask);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "MyMath.h"
+#include "SimdLane.h"
+
+//================================================
+// 　レーン数分の3次元ベクトル
+//
+// 点やベクトルをSIMDのレーンに並べ、x,y,z を成分ごとのレーンで持つ
+//================================================
+
+struct LaneVector {
+    FloatLane x;
+    FloatLane y;
+    FloatLane z;
+};
+
+// 全レーンに同じベクトルを配る
+inline LaneVector LaneBroadcast(const Vector3& v)
+{
+    return { LaneSet(v.x), LaneSet(v.y), LaneSet(v.z) };
+}
+
+inline LaneVector LaneSubtract(const LaneVector& v1, const LaneVector& v2)
+{
+    return { LaneSub(v1.x, v2.x), LaneSub(v1.y, v2.y), LaneSub(v1.z, v2.z) };
+}
+
+inline LaneVector LaneScale(const LaneVector& v, FloatLane scalar)
+{
+    return { LaneMul(v.x, scalar), LaneMul(v.y, scalar), LaneMul(v.z, scalar) };
+}
+
+// v1 + v2 * scalar
+inline LaneVector LaneMultiplyAdd(const LaneVector& v1, const LaneVector& v2, FloatLane scalar)
+{
+    return { LaneAdd(v1.x, LaneMul(v2.x, scalar)), LaneAdd(v1.y, LaneMul(v2.y, scalar)), LaneAdd(v1.z, LaneMul(v2.z, scalar)) };
+}
+
+inline FloatLane LaneDot(const LaneVector& v1, const LaneVector& v2)
+{
+    return LaneAdd(LaneAdd(LaneMul(v1.x, v2.x), LaneMul(v1.y, v2.y)), LaneMul(v1.z, v2.z));
+}
+
+inline LaneVector LaneSelectVector(LaneMask mask, const LaneVector& ifTrue, const LaneVector& ifFalse)
+{
+    return { LaneSelect(mask, ifTrue.x, ifFalse.x), LaneSelect(mask, ifTrue.y, ifFalse.y), LaneSelect(mask, ifTrue.z, ifFalse.z) };
+}
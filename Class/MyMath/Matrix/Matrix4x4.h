@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Matrix4x4Simd.h"
+#include <type_traits>
+
 /// <summary>
 /// 行列構造体
 /// </summary>
@@ -7,9 +10,9 @@ struct Matrix4x4 {
 
     float m[4][4];
 
-    Matrix4x4 operator+(const Matrix4x4& matrix) const
+    constexpr Matrix4x4 operator+(const Matrix4x4& matrix) const
     {
-        Matrix4x4 result;
+        Matrix4x4 result {};
         for (int row = 0; row < 4; ++row) {
             for (int column = 0; column < 4; ++column) {
                 result.m[row][column] = m[row][column] + matrix.m[row][column];
@@ -18,9 +21,9 @@ struct Matrix4x4 {
         return result;
     }
 
-    Matrix4x4 operator-(const Matrix4x4& matrix) const
+    constexpr Matrix4x4 operator-(const Matrix4x4& matrix) const
     {
-        Matrix4x4 result;
+        Matrix4x4 result {};
         for (int row = 0; row < 4; ++row) {
             for (int column = 0; column < 4; ++column) {
                 result.m[row][column] = m[row][column] - matrix.m[row][column];
@@ -29,17 +32,23 @@ struct Matrix4x4 {
         return result;
     }
 
-    Matrix4x4 operator*(const Matrix4x4& matrix) const
+    // 定数式ではスカラー実装、実行時はSIMD実装
+    constexpr Matrix4x4 operator*(const Matrix4x4& matrix) const
     {
-        Matrix4x4 result;
-        for (int row = 0; row < 4; ++row) {
-            for (int column = 0; column < 4; ++column) {
-                result.m[row][column] = 0.0f;
-                for (int i = 0; i < 4; ++i) {
-                    result.m[row][column] += m[row][i] * matrix.m[i][column];
+        Matrix4x4 result {};
+        if (std::is_constant_evaluated()) {
+            for (int row = 0; row < 4; ++row) {
+                for (int column = 0; column < 4; ++column) {
+                    result.m[row][column] = 0.0f;
+                    for (int i = 0; i < 4; ++i) {
+                        result.m[row][column] += m[row][i] * matrix.m[i][column];
+                    }
                 }
             }
+            return result;
         }
+
+        MultiplyMatrixSimd(m, matrix.m, result.m);
         return result;
     }
 };
\ No newline at end of file
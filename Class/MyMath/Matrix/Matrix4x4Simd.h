@@ -0,0 +1,448 @@
+#pragma once
+
+#include "../SimdConfig.h"
+#include <cassert>
+
+// 逆行列のSIMD実装とスカラー実装の許容誤差(要素ごとの相対誤差)
+// 積と転置は演算順序をスカラー実装と揃えているため完全一致する
+// (ただし 0.0f と -0.0f の符号の違いは除く)
+constexpr float kMatrixSimdInverseTolerance = 1e-5f;
+
+/// <summary>
+/// 4x4行列の積 (out = lhs * rhs)
+/// </summary>
+/// <param name="lhs">左辺</param>
+/// <param name="rhs">右辺</param>
+/// <param name="out">結果(lhs, rhs と同じ領域でも良い)</param>
+inline void MultiplyMatrixSimd(const float (&lhs)[4][4], const float (&rhs)[4][4], float (&out)[4][4])
+{
+#if MYMATH_SIMD_LEVEL >= 2
+    // 右辺の各行を上下128bitに複製しておく
+    __m256 r0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs[0]));
+    __m256 r1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs[1]));
+    __m256 r2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs[2]));
+    __m256 r3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs[3]));
+
+    // 左辺を2行ずつ処理する
+    __m256 l01 = _mm256_loadu_ps(lhs[0]);
+    __m256 l23 = _mm256_loadu_ps(lhs[2]);
+
+    __m256 o01 = _mm256_mul_ps(_mm256_shuffle_ps(l01, l01, 0x00), r0);
+    o01 = _mm256_add_ps(o01, _mm256_mul_ps(_mm256_shuffle_ps(l01, l01, 0x55), r1));
+    o01 = _mm256_add_ps(o01, _mm256_mul_ps(_mm256_shuffle_ps(l01, l01, 0xAA), r2));
+    o01 = _mm256_add_ps(o01, _mm256_mul_ps(_mm256_shuffle_ps(l01, l01, 0xFF), r3));
+
+    __m256 o23 = _mm256_mul_ps(_mm256_shuffle_ps(l23, l23, 0x00), r0);
+    o23 = _mm256_add_ps(o23, _mm256_mul_ps(_mm256_shuffle_ps(l23, l23, 0x55), r1));
+    o23 = _mm256_add_ps(o23, _mm256_mul_ps(_mm256_shuffle_ps(l23, l23, 0xAA), r2));
+    o23 = _mm256_add_ps(o23, _mm256_mul_ps(_mm256_shuffle_ps(l23, l23, 0xFF), r3));
+
+    _mm256_storeu_ps(out[0], o01);
+    _mm256_storeu_ps(out[2], o23);
+#elif MYMATH_SIMD_LEVEL >= 1
+    __m128 r0 = _mm_loadu_ps(rhs[0]);
+    __m128 r1 = _mm_loadu_ps(rhs[1]);
+    __m128 r2 = _mm_loadu_ps(rhs[2]);
+    __m128 r3 = _mm_loadu_ps(rhs[3]);
+
+    // 出力が入力と重なっても良いように、先に全行を計算してから書き込む
+    __m128 o[4];
+    for (int row = 0; row < 4; ++row) {
+        __m128 l = _mm_loadu_ps(lhs[row]);
+        __m128 v = _mm_mul_ps(_mm_shuffle_ps(l, l, 0x00), r0);
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_shuffle_ps(l, l, 0x55), r1));
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_shuffle_ps(l, l, 0xAA), r2));
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_shuffle_ps(l, l, 0xFF), r3));
+        o[row] = v;
+    }
+    for (int row = 0; row < 4; ++row) {
+        _mm_storeu_ps(out[row], o[row]);
+    }
+#else
+    float result[4][4];
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            result[row][column] = lhs[row][0] * rhs[0][column];
+            for (int i = 1; i < 4; ++i) {
+                result[row][column] += lhs[row][i] * rhs[i][column];
+            }
+        }
+    }
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            out[row][column] = result[row][column];
+        }
+    }
+#endif
+}
+
+/// <summary>
+/// 4x4行列の転置
+/// </summary>
+/// <param name="m">入力</param>
+/// <param name="out">結果(m と同じ領域でも良い)</param>
+inline void TransposeMatrixSimd(const float (&m)[4][4], float (&out)[4][4])
+{
+#if MYMATH_SIMD_LEVEL >= 1
+    __m128 r0 = _mm_loadu_ps(m[0]);
+    __m128 r1 = _mm_loadu_ps(m[1]);
+    __m128 r2 = _mm_loadu_ps(m[2]);
+    __m128 r3 = _mm_loadu_ps(m[3]);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(out[0], r0);
+    _mm_storeu_ps(out[1], r1);
+    _mm_storeu_ps(out[2], r2);
+    _mm_storeu_ps(out[3], r3);
+#else
+    float result[4][4];
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            result[row][column] = m[column][row];
+        }
+    }
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            out[row][column] = result[row][column];
+        }
+    }
+#endif
+}
+
+#if MYMATH_SIMD_LEVEL >= 1
+
+// 2x2行列(行優先で1レジスタに格納)用のヘルパー
+#define MYMATH_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define MYMATH_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), MYMATH_SHUFFLE_MASK(x, y, z, w))
+
+// A * B
+inline __m128 Mat2MulSimd(__m128 a, __m128 b)
+{
+    return _mm_add_ps(
+        _mm_mul_ps(a, MYMATH_SWIZZLE(b, 0, 3, 0, 3)),
+        _mm_mul_ps(MYMATH_SWIZZLE(a, 1, 0, 3, 2), MYMATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adj(A) * B
+inline __m128 Mat2AdjMulSimd(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(MYMATH_SWIZZLE(a, 3, 3, 0, 0), b),
+        _mm_mul_ps(MYMATH_SWIZZLE(a, 1, 1, 2, 2), MYMATH_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// A * adj(B)
+inline __m128 Mat2MulAdjSimd(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(a, MYMATH_SWIZZLE(b, 3, 0, 3, 0)),
+        _mm_mul_ps(MYMATH_SWIZZLE(a, 1, 0, 3, 2), MYMATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+#endif
+
+/// <summary>
+/// 4x4行列の逆行列 (2x2ブロック分解による余因子計算)
+/// スカラー実装との差は kMatrixSimdInverseTolerance 以内
+/// </summary>
+/// <param name="m">入力(正則であること)</param>
+/// <param name="out">結果(m と同じ領域でも良い)</param>
+/// <returns>行列式</returns>
+inline float InverseMatrixSimd(const float (&m)[4][4], float (&out)[4][4])
+{
+#if MYMATH_SIMD_LEVEL >= 1
+    __m128 r0 = _mm_loadu_ps(m[0]);
+    __m128 r1 = _mm_loadu_ps(m[1]);
+    __m128 r2 = _mm_loadu_ps(m[2]);
+    __m128 r3 = _mm_loadu_ps(m[3]);
+
+    // 2x2の小行列に分割
+    // | A B |
+    // | C D |
+    __m128 a = _mm_movelh_ps(r0, r1);
+    __m128 b = _mm_movehl_ps(r1, r0);
+    __m128 c = _mm_movelh_ps(r2, r3);
+    __m128 d = _mm_movehl_ps(r3, r2);
+
+    // 各小行列の行列式 (|A| |B| |C| |D|)
+    __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(r0, r2, MYMATH_SHUFFLE_MASK(0, 2, 0, 2)), _mm_shuffle_ps(r1, r3, MYMATH_SHUFFLE_MASK(1, 3, 1, 3))),
+        _mm_mul_ps(_mm_shuffle_ps(r0, r2, MYMATH_SHUFFLE_MASK(1, 3, 1, 3)), _mm_shuffle_ps(r1, r3, MYMATH_SHUFFLE_MASK(0, 2, 0, 2))));
+    __m128 detA = MYMATH_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = MYMATH_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = MYMATH_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = MYMATH_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    __m128 dc = Mat2AdjMulSimd(d, c);
+    __m128 ab = Mat2AdjMulSimd(a, b);
+
+    // 逆行列 = 1/|M| * | X Y |
+    //                  | Z W |
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2MulSimd(b, dc));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2MulSimd(c, ab));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdjSimd(d, ab));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdjSimd(a, dc));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 tr = _mm_mul_ps(ab, MYMATH_SWIZZLE(dc, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+    tr = _mm_add_ps(tr, MYMATH_SWIZZLE(tr, 1, 1, 1, 1));
+    tr = MYMATH_SWIZZLE(tr, 0, 0, 0, 0);
+    __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+    float det = _mm_cvtss_f32(detM);
+
+    // 行列式が 0 の場合は逆行列なし
+    assert(det != 0.0f);
+
+    __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    x = _mm_mul_ps(x, rDetM);
+    y = _mm_mul_ps(y, rDetM);
+    z = _mm_mul_ps(z, rDetM);
+    w = _mm_mul_ps(w, rDetM);
+
+    // 余因子の並び替えと格納をまとめて行う
+    _mm_storeu_ps(out[0], _mm_shuffle_ps(x, y, MYMATH_SHUFFLE_MASK(3, 1, 3, 1)));
+    _mm_storeu_ps(out[1], _mm_shuffle_ps(x, y, MYMATH_SHUFFLE_MASK(2, 0, 2, 0)));
+    _mm_storeu_ps(out[2], _mm_shuffle_ps(z, w, MYMATH_SHUFFLE_MASK(3, 1, 3, 1)));
+    _mm_storeu_ps(out[3], _mm_shuffle_ps(z, w, MYMATH_SHUFFLE_MASK(2, 0, 2, 0)));
+
+    return det;
+#else
+    // 2x2の小行列式を使った余因子展開
+    float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+    float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+    float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+    float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+    float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+    float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+    float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+    float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+    float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+    float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+    float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+    float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+    float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+    // 行列式が 0 の場合は逆行列なし
+    assert(det != 0.0f);
+
+    float invDet = 1.0f / det;
+    float result[4][4] = {
+        { (m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * invDet,
+            (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * invDet,
+            (m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * invDet,
+            (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * invDet },
+        { (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * invDet,
+            (m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * invDet,
+            (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * invDet,
+            (m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * invDet },
+        { (m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * invDet,
+            (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * invDet,
+            (m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * invDet,
+            (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * invDet },
+        { (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * invDet,
+            (m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * invDet,
+            (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * invDet,
+            (m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * invDet }
+    };
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            out[row][column] = result[row][column];
+        }
+    }
+    return det;
+#endif
+}
+
+/// <summary>
+/// 4列目が (0, 0, 0, 1) か(アフィン行列か)
+/// </summary>
+inline bool IsAffineMatrixSimd(const float (&m)[4][4])
+{
+    return m[0][3] == 0.0f && m[1][3] == 0.0f && m[2][3] == 0.0f && m[3][3] == 1.0f;
+}
+
+/// <summary>
+/// アフィン行列の3x3部分が正規直交か(各行が単位長で互いに直交)
+/// </summary>
+/// <param name="m">アフィン行列</param>
+/// <param name="tolerance">内積の許容誤差</param>
+inline bool IsOrthonormalMatrixSimd(const float (&m)[4][4], float tolerance)
+{
+#if MYMATH_SIMD_LEVEL >= 1
+    __m128 c0 = _mm_loadu_ps(m[0]);
+    __m128 c1 = _mm_loadu_ps(m[1]);
+    __m128 c2 = _mm_loadu_ps(m[2]);
+    __m128 c3 = _mm_setzero_ps();
+
+    // 転置して各レーンに行番号を対応させる
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    // (|r0|^2, |r1|^2, |r2|^2, 0)
+    __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, c0), _mm_mul_ps(c1, c1)), _mm_mul_ps(c2, c2));
+    // (r0・r1, r1・r2, r2・r0, 0)
+    __m128 dot = _mm_add_ps(_mm_add_ps(
+                                _mm_mul_ps(c0, MYMATH_SWIZZLE(c0, 1, 2, 0, 3)),
+                                _mm_mul_ps(c1, MYMATH_SWIZZLE(c1, 1, 2, 0, 3))),
+        _mm_mul_ps(c2, MYMATH_SWIZZLE(c2, 1, 2, 0, 3)));
+
+    __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 lengthError = _mm_andnot_ps(signMask, _mm_sub_ps(lengthSq, _mm_setr_ps(1.0f, 1.0f, 1.0f, 0.0f)));
+    __m128 dotError = _mm_andnot_ps(signMask, dot);
+    __m128 limit = _mm_set1_ps(tolerance);
+
+    __m128 isValid = _mm_and_ps(_mm_cmple_ps(lengthError, limit), _mm_cmple_ps(dotError, limit));
+    return _mm_movemask_ps(isValid) == 0xF;
+#else
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3;
+        float lengthSq = m[i][0] * m[i][0] + m[i][1] * m[i][1] + m[i][2] * m[i][2];
+        float dot = m[i][0] * m[j][0] + m[i][1] * m[j][1] + m[i][2] * m[j][2];
+        if (!(lengthSq - 1.0f <= tolerance && 1.0f - lengthSq <= tolerance && dot <= tolerance && -dot <= tolerance)) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+/// <summary>
+/// 剛体変換行列の逆行列(3x3部分の転置と平行移動の打ち消し)
+/// </summary>
+/// <param name="m">剛体変換行列(4列目が (0, 0, 0, 1))</param>
+/// <param name="out">結果(m と同じ領域でも良い)</param>
+inline void InverseRigidMatrixSimd(const float (&m)[4][4], float (&out)[4][4])
+{
+#if MYMATH_SIMD_LEVEL >= 1
+    __m128 r0 = _mm_loadu_ps(m[0]);
+    __m128 r1 = _mm_loadu_ps(m[1]);
+    __m128 r2 = _mm_loadu_ps(m[2]);
+    __m128 translate = _mm_loadu_ps(m[3]);
+    __m128 r3 = _mm_setzero_ps();
+
+    // 回転部分は転置(4列目は 0 のまま)
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    // 平行移動は回転を戻してから打ち消す
+    __m128 rotated = _mm_add_ps(_mm_add_ps(
+                                    _mm_mul_ps(MYMATH_SWIZZLE(translate, 0, 0, 0, 0), r0),
+                                    _mm_mul_ps(MYMATH_SWIZZLE(translate, 1, 1, 1, 1), r1)),
+        _mm_mul_ps(MYMATH_SWIZZLE(translate, 2, 2, 2, 2), r2));
+    r3 = _mm_add_ps(_mm_sub_ps(_mm_setzero_ps(), rotated), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+
+    _mm_storeu_ps(out[0], r0);
+    _mm_storeu_ps(out[1], r1);
+    _mm_storeu_ps(out[2], r2);
+    _mm_storeu_ps(out[3], r3);
+#else
+    float result[4][4] = {
+        { m[0][0], m[1][0], m[2][0], 0.0f },
+        { m[0][1], m[1][1], m[2][1], 0.0f },
+        { m[0][2], m[1][2], m[2][2], 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f }
+    };
+    for (int column = 0; column < 3; ++column) {
+        result[3][column] = -(m[3][0] * m[column][0] + m[3][1] * m[column][1] + m[3][2] * m[column][2]);
+    }
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            out[row][column] = result[row][column];
+        }
+    }
+#endif
+}
+
+/// <summary>
+/// アフィン行列の逆行列(3x3部分の逆行列と平行移動の打ち消し)
+/// </summary>
+/// <param name="m">アフィン行列(4列目が (0, 0, 0, 1) で3x3部分が正則)</param>
+/// <param name="out">結果(m と同じ領域でも良い)</param>
+/// <returns>3x3部分の行列式</returns>
+inline float InverseAffineMatrixSimd(const float (&m)[4][4], float (&out)[4][4])
+{
+#if MYMATH_SIMD_LEVEL >= 1
+    __m128 r0 = _mm_loadu_ps(m[0]);
+    __m128 r1 = _mm_loadu_ps(m[1]);
+    __m128 r2 = _mm_loadu_ps(m[2]);
+    __m128 translate = _mm_loadu_ps(m[3]);
+
+    // 3x3部分の逆行列の各列は、他の2行の外積を行列式で割ったもの
+    // cross(a, b) = a.yzx * b.zxy - a.zxy * b.yzx (4番目の要素は 0 になる)
+    __m128 r0yzx = MYMATH_SWIZZLE(r0, 1, 2, 0, 3);
+    __m128 r0zxy = MYMATH_SWIZZLE(r0, 2, 0, 1, 3);
+    __m128 r1yzx = MYMATH_SWIZZLE(r1, 1, 2, 0, 3);
+    __m128 r1zxy = MYMATH_SWIZZLE(r1, 2, 0, 1, 3);
+    __m128 r2yzx = MYMATH_SWIZZLE(r2, 1, 2, 0, 3);
+    __m128 r2zxy = MYMATH_SWIZZLE(r2, 2, 0, 1, 3);
+
+    __m128 c0 = _mm_sub_ps(_mm_mul_ps(r1yzx, r2zxy), _mm_mul_ps(r1zxy, r2yzx));
+    __m128 c1 = _mm_sub_ps(_mm_mul_ps(r2yzx, r0zxy), _mm_mul_ps(r2zxy, r0yzx));
+    __m128 c2 = _mm_sub_ps(_mm_mul_ps(r0yzx, r1zxy), _mm_mul_ps(r0zxy, r1yzx));
+    __m128 c3 = _mm_setzero_ps();
+
+    // 行列式 = r0・cross(r1, r2)
+    __m128 detV = _mm_mul_ps(r0, c0);
+    detV = _mm_add_ps(_mm_add_ps(MYMATH_SWIZZLE(detV, 0, 0, 0, 0), MYMATH_SWIZZLE(detV, 1, 1, 1, 1)), MYMATH_SWIZZLE(detV, 2, 2, 2, 2));
+    float det = _mm_cvtss_f32(detV);
+
+    // 行列式が 0 の場合は逆行列なし
+    assert(det != 0.0f);
+
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), detV);
+    c0 = _mm_mul_ps(c0, invDet);
+    c1 = _mm_mul_ps(c1, invDet);
+    c2 = _mm_mul_ps(c2, invDet);
+
+    // 列ベクトルを転置して行として格納
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    __m128 transformed = _mm_add_ps(_mm_add_ps(
+                                        _mm_mul_ps(MYMATH_SWIZZLE(translate, 0, 0, 0, 0), c0),
+                                        _mm_mul_ps(MYMATH_SWIZZLE(translate, 1, 1, 1, 1), c1)),
+        _mm_mul_ps(MYMATH_SWIZZLE(translate, 2, 2, 2, 2), c2));
+    c3 = _mm_add_ps(_mm_sub_ps(_mm_setzero_ps(), transformed), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+
+    _mm_storeu_ps(out[0], c0);
+    _mm_storeu_ps(out[1], c1);
+    _mm_storeu_ps(out[2], c2);
+    _mm_storeu_ps(out[3], c3);
+
+    return det;
+#else
+    // 他の2行の外積
+    float c[3][3];
+    for (int i = 0; i < 3; ++i) {
+        const float* a = m[(i + 1) % 3];
+        const float* b = m[(i + 2) % 3];
+        c[i][0] = a[1] * b[2] - a[2] * b[1];
+        c[i][1] = a[2] * b[0] - a[0] * b[2];
+        c[i][2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    float det = m[0][0] * c[0][0] + m[0][1] * c[0][1] + m[0][2] * c[0][2];
+
+    // 行列式が 0 の場合は逆行列なし
+    assert(det != 0.0f);
+
+    float invDet = 1.0f / det;
+    float result[4][4] = {};
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            result[row][column] = c[column][row] * invDet;
+        }
+    }
+    for (int column = 0; column < 3; ++column) {
+        result[3][column] = -(m[3][0] * result[0][column] + m[3][1] * result[1][column] + m[3][2] * result[2][column]);
+    }
+    result[3][3] = 1.0f;
+
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            out[row][column] = result[row][column];
+        }
+    }
+    return det;
+#endif
+}
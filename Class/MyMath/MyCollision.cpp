@@ -1,4 +1,6 @@
 #include "MyCollision.h"
+#include "PreparedTriangle.h"
+#include "SimdConfig.h"
 #include <math.h>
 
 // 平面と球の衝突判定
@@ -94,10 +96,10 @@ bool IsCollision(const Sphere& sphere, const AABB& aabb)
         std::clamp(sphere.center.z, aabb.min.z, aabb.max.z)
     };
 
-    // 球の中心と最接近点の距離を求める
-    float distance = Length(closesePoint - sphere.center);
+    // 球の中心と最接近点の距離を求める(平方根を避けて2乗で比較する)
+    Vector3 diff = closesePoint - sphere.center;
     // 距離が半径より小さければ衝突
-    if (distance <= sphere.radius) {
+    if (Dot(diff, diff) <= sphere.radius * sphere.radius) {
         return true;
     }
 
@@ -159,4 +161,646 @@ bool IsCollision(const AABB& aabb, const Segment& segment)
     float tmax = std::min(std::min(txmax, tymax), tzmax);
 
     return (tmin <= tmax) && (tmax >= 0.0f) && (tmin <= 1.0f);
-}
\ No newline at end of file
+}
+
+// 球と視錐台の衝突
+bool IsCollision(const Sphere& sphere, const Frustum& frustum)
+{
+    // どれか1つの平面の完全に外側にあれば見えない
+    for (const Plane& plane : frustum.planes) {
+        if (Dot(plane.normal, sphere.center) - plane.distance < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// AABBと視錐台の衝突
+bool IsCollision(const AABB& aabb, const Frustum& frustum)
+{
+    Vector3 center = (aabb.min + aabb.max) * 0.5f;
+    Vector3 extent = (aabb.max - aabb.min) * 0.5f;
+
+    for (const Plane& plane : frustum.planes) {
+        // 法線方向に最も遠い頂点までの距離(中心からの射影半径)
+        float radius = extent.x * fabsf(plane.normal.x) + extent.y * fabsf(plane.normal.y) + extent.z * fabsf(plane.normal.z);
+        if (Dot(plane.normal, center) - plane.distance < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// OBBとOBBの衝突
+// obb1 の軸 A0~A2、obb2 の軸 B0~B2、その外積 Ai x Bj の15軸のどれかで射影が離れていれば衝突していない
+// 軸の種類ごと(A, B, Ai x B0~B2 の5組)に3軸ずつまとめて調べる
+bool IsCollision(const OBB& obb1, const OBB& obb2)
+{
+    // 辺が平行なときに外積の軸が0になって誤判定しないよう、|R| に足す値
+    constexpr float kParallelEpsilon = 1e-6f;
+
+    const Vector3* a = obb1.orientations;
+    const Vector3* b = obb2.orientations;
+    Vector3 diff = obb2.center - obb1.center;
+    // 中心の差を obb1 の座標系で表したもの
+    const float t[3] = { Dot(diff, a[0]), Dot(diff, a[1]), Dot(diff, a[2]) };
+
+#if MYMATH_SIMD_LEVEL >= 1
+    // 要素 0~2 を軸の番号に対応させる(要素3は0で、判定には使わない)
+    const __m128 epsilon = _mm_set1_ps(kParallelEpsilon);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 aX = _mm_set_ps(0.0f, a[2].x, a[1].x, a[0].x);
+    const __m128 aY = _mm_set_ps(0.0f, a[2].y, a[1].y, a[0].y);
+    const __m128 aZ = _mm_set_ps(0.0f, a[2].z, a[1].z, a[0].z);
+    const __m128 size1 = _mm_set_ps(0.0f, obb1.size.z, obb1.size.y, obb1.size.x);
+    const __m128 size2 = _mm_set_ps(0.0f, obb2.size.z, obb2.size.y, obb2.size.x);
+
+    // R[i][j] = Dot(Ai, Bj)。r[j] は R の列(要素 i)で、後で転置して行にする
+    __m128 r[4];
+    for (int j = 0; j < 3; ++j) {
+        r[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(aX, _mm_set1_ps(b[j].x)), _mm_mul_ps(aY, _mm_set1_ps(b[j].y))), _mm_mul_ps(aZ, _mm_set1_ps(b[j].z)));
+    }
+    r[3] = _mm_setzero_ps();
+    __m128 absColumns[3];
+    for (int j = 0; j < 3; ++j) {
+        absColumns[j] = _mm_add_ps(_mm_andnot_ps(signMask, r[j]), epsilon);
+    }
+
+    // A0~A2: |t_i| > a_i + Σj b_j |R[i][j]|
+    __m128 radius2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absColumns[0], _mm_set1_ps(obb2.size.x)), _mm_mul_ps(absColumns[1], _mm_set1_ps(obb2.size.y))), _mm_mul_ps(absColumns[2], _mm_set1_ps(obb2.size.z)));
+    __m128 distance = _mm_andnot_ps(signMask, _mm_set_ps(0.0f, t[2], t[1], t[0]));
+    if (_mm_movemask_ps(_mm_cmpgt_ps(distance, _mm_add_ps(size1, radius2))) != 0) {
+        return false;
+    }
+
+    // 転置して r[i] を R の行(要素 j)にする
+    _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+    __m128 absRows[3];
+    for (int i = 0; i < 3; ++i) {
+        absRows[i] = _mm_add_ps(_mm_andnot_ps(signMask, r[i]), epsilon);
+    }
+
+    // B0~B2: |Σi t_i R[i][j]| > Σi a_i |R[i][j]| + b_j
+    __m128 radius1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absRows[0], _mm_set1_ps(obb1.size.x)), _mm_mul_ps(absRows[1], _mm_set1_ps(obb1.size.y))), _mm_mul_ps(absRows[2], _mm_set1_ps(obb1.size.z)));
+    distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[0], _mm_set1_ps(t[0])), _mm_mul_ps(r[1], _mm_set1_ps(t[1]))), _mm_mul_ps(r[2], _mm_set1_ps(t[2])));
+    distance = _mm_andnot_ps(signMask, distance);
+    if (_mm_movemask_ps(_mm_cmpgt_ps(distance, _mm_add_ps(radius1, size2))) != 0) {
+        return false;
+    }
+
+    // Ai x B0~B2(要素 j)。j + 1, j + 2 番目の要素を並べ替えで取り出す
+    const float size1Values[3] = { obb1.size.x, obb1.size.y, obb1.size.z };
+    const __m128 size2Next = _mm_shuffle_ps(size2, size2, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 size2Prev = _mm_shuffle_ps(size2, size2, _MM_SHUFFLE(3, 1, 0, 2));
+    for (int i = 0; i < 3; ++i) {
+        int i1 = (i + 1) % 3;
+        int i2 = (i + 2) % 3;
+        __m128 radiusA = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(size1Values[i1]), absRows[i2]), _mm_mul_ps(_mm_set1_ps(size1Values[i2]), absRows[i1]));
+        __m128 absRowNext = _mm_shuffle_ps(absRows[i], absRows[i], _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 absRowPrev = _mm_shuffle_ps(absRows[i], absRows[i], _MM_SHUFFLE(3, 1, 0, 2));
+        __m128 radiusB = _mm_add_ps(_mm_mul_ps(size2Next, absRowPrev), _mm_mul_ps(size2Prev, absRowNext));
+        distance = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(t[i2]), r[i1]), _mm_mul_ps(_mm_set1_ps(t[i1]), r[i2]));
+        distance = _mm_andnot_ps(signMask, distance);
+        if (_mm_movemask_ps(_mm_cmpgt_ps(distance, _mm_add_ps(radiusA, radiusB))) != 0) {
+            return false;
+        }
+    }
+    return true;
+#else
+    const float size1[3] = { obb1.size.x, obb1.size.y, obb1.size.z };
+    const float size2[3] = { obb2.size.x, obb2.size.y, obb2.size.z };
+
+    float r[3][3];
+    float absR[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r[i][j] = Dot(a[i], b[j]);
+            absR[i][j] = fabsf(r[i][j]) + kParallelEpsilon;
+        }
+    }
+
+    // A0~A2
+    for (int i = 0; i < 3; ++i) {
+        float radius2 = size2[0] * absR[i][0] + size2[1] * absR[i][1] + size2[2] * absR[i][2];
+        if (fabsf(t[i]) > size1[i] + radius2) {
+            return false;
+        }
+    }
+
+    // B0~B2
+    for (int j = 0; j < 3; ++j) {
+        float radius1 = size1[0] * absR[0][j] + size1[1] * absR[1][j] + size1[2] * absR[2][j];
+        float distance = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+        if (fabsf(distance) > radius1 + size2[j]) {
+            return false;
+        }
+    }
+
+    // Ai x Bj
+    for (int i = 0; i < 3; ++i) {
+        int i1 = (i + 1) % 3;
+        int i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j) {
+            int j1 = (j + 1) % 3;
+            int j2 = (j + 2) % 3;
+            float radiusA = size1[i1] * absR[i2][j] + size1[i2] * absR[i1][j];
+            float radiusB = size2[j1] * absR[i][j2] + size2[j2] * absR[i][j1];
+            float distance = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+            if (fabsf(distance) > radiusA + radiusB) {
+                return false;
+            }
+        }
+    }
+    return true;
+#endif
+}
+
+// 球とOBBの衝突
+bool IsCollision(const Sphere& sphere, const OBB& obb)
+{
+    // OBB の座標系で最近接点を求める
+    Vector3 diff = sphere.center - obb.center;
+    float distanceSq = 0.0f;
+    const float halfSizes[3] = { obb.size.x, obb.size.y, obb.size.z };
+    for (int i = 0; i < 3; ++i) {
+        float local = Dot(diff, obb.orientations[i]);
+        float outside = local - std::clamp(local, -halfSizes[i], halfSizes[i]);
+        distanceSq += outside * outside;
+    }
+    return distanceSq <= sphere.radius * sphere.radius;
+}
+
+// OBBと線分の衝突
+bool IsCollision(const OBB& obb, const Segment& segment)
+{
+    // OBB の座標系に移して AABB と判定する
+    Vector3 origin = segment.origin - obb.center;
+    Segment localSegment = {
+        { Dot(origin, obb.orientations[0]), Dot(origin, obb.orientations[1]), Dot(origin, obb.orientations[2]) },
+        { Dot(segment.diff, obb.orientations[0]), Dot(segment.diff, obb.orientations[1]), Dot(segment.diff, obb.orientations[2]) }
+    };
+    AABB localAABB = { obb.size * -1.0f, obb.size };
+    return IsCollision(localAABB, localSegment);
+}
+
+// OBBと平面の衝突
+bool IsCollision(const OBB& obb, const Plane& plane)
+{
+    // 法線方向の射影半径
+    float radius = obb.size.x * fabsf(Dot(plane.normal, obb.orientations[0]))
+        + obb.size.y * fabsf(Dot(plane.normal, obb.orientations[1]))
+        + obb.size.z * fabsf(Dot(plane.normal, obb.orientations[2]));
+    return fabsf(Dot(plane.normal, obb.center) - plane.distance) <= radius;
+}
+
+// 球と平面の接触
+bool Collide(const Sphere& sphere, const Plane& plane, Contact& contact)
+{
+    float distance = Dot(plane.normal, sphere.center) - plane.distance;
+    float absDistance = fabsf(distance);
+    if (absDistance > sphere.radius) {
+        return false;
+    }
+
+    // 球の中心がある側に押し出す(接触点は中心を平面に射影した点)
+    contact.normal = plane.normal * std::copysign(1.0f, distance);
+    contact.penetration = sphere.radius - absDistance;
+    contact.point = sphere.center - plane.normal * distance;
+    contact.t = 0.0f;
+    return true;
+}
+
+// 球とAABBの接触
+bool Collide(const Sphere& sphere, const AABB& aabb, Contact& contact)
+{
+    Vector3 closestPoint = {
+        std::clamp(sphere.center.x, aabb.min.x, aabb.max.x),
+        std::clamp(sphere.center.y, aabb.min.y, aabb.max.y),
+        std::clamp(sphere.center.z, aabb.min.z, aabb.max.z)
+    };
+
+    Vector3 diff = sphere.center - closestPoint;
+    float distanceSq = Dot(diff, diff);
+    if (distanceSq > sphere.radius * sphere.radius) {
+        return false;
+    }
+
+    contact.t = 0.0f;
+
+    if (distanceSq > 0.0f) {
+        float distance = sqrtf(distanceSq);
+        contact.normal = diff * (1.0f / distance);
+        contact.penetration = sphere.radius - distance;
+        contact.point = closestPoint;
+        return true;
+    }
+
+    // 中心が AABB の中にある場合は、最も近い面から押し出す
+    float faceDistances[6] = {
+        sphere.center.x - aabb.min.x, aabb.max.x - sphere.center.x,
+        sphere.center.y - aabb.min.y, aabb.max.y - sphere.center.y,
+        sphere.center.z - aabb.min.z, aabb.max.z - sphere.center.z,
+    };
+    const Vector3 faceNormals[6] = {
+        { -1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f },
+        { 0.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f },
+    };
+
+    int nearestFace = 0;
+    for (int i = 1; i < 6; ++i) {
+        if (faceDistances[i] < faceDistances[nearestFace]) {
+            nearestFace = i;
+        }
+    }
+
+    contact.normal = faceNormals[nearestFace];
+    contact.penetration = sphere.radius + faceDistances[nearestFace];
+    contact.point = sphere.center + contact.normal * faceDistances[nearestFace];
+    return true;
+}
+
+// 球と球の接触
+bool Collide(const Sphere& sphere1, const Sphere& sphere2, Contact& contact)
+{
+    Vector3 diff = sphere1.center - sphere2.center;
+    float distanceSq = Dot(diff, diff);
+    float radiusSum = sphere1.radius + sphere2.radius;
+    if (distanceSq > radiusSum * radiusSum) {
+        return false;
+    }
+
+    // 中心が一致する場合は上に押し出す
+    float distance = sqrtf(distanceSq);
+    contact.normal = distance > 0.0f ? diff * (1.0f / distance) : Vector3 { 0.0f, 1.0f, 0.0f };
+    contact.penetration = radiusSum - distance;
+    contact.point = sphere2.center + contact.normal * (sphere2.radius - contact.penetration * 0.5f);
+    contact.t = 0.0f;
+    return true;
+}
+
+// 線分と三角形の接触
+bool Collide(const Segment& segment, const Triangle& triangle, Contact& contact)
+{
+    PreparedTriangle preparedTriangle = MakePreparedTriangle(triangle);
+    TriangleIntersection intersection;
+    if (!IntersectSegment(preparedTriangle, segment, intersection)) {
+        return false;
+    }
+
+    // 線分の始点側を向く法線
+    Vector3 normal = Normalize(preparedTriangle.normal);
+    float normalDot = Dot(normal, segment.diff);
+    if (normalDot > 0.0f) {
+        normal = normal * -1.0f;
+        normalDot = -normalDot;
+    }
+
+    contact.normal = normal;
+    contact.penetration = (1.0f - intersection.t) * -normalDot;
+    contact.point = segment.origin + segment.diff * intersection.t;
+    contact.t = intersection.t;
+    return true;
+}
+
+namespace {
+
+Vector3 WithAxisValue(Vector3 v, int axis, float value)
+{
+    (axis == 0 ? v.x : (axis == 1 ? v.y : v.z)) = value;
+    return v;
+}
+
+// 点 origin + diff * t (0 <= t <= maxT) が球に入る時刻
+bool IntersectMovingPointSphere(const Vector3& origin, const Vector3& diff, const Vector3& center, float radius, float maxT, float& t)
+{
+    Vector3 m = origin - center;
+    float b = Dot(m, diff);
+    float c = Dot(m, m) - radius * radius;
+    if (c <= 0.0f) {
+        t = 0.0f; // 始めから中にある
+        return true;
+    }
+    if (b >= 0.0f) {
+        return false; // 遠ざかっている
+    }
+
+    float a = Dot(diff, diff);
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return false;
+    }
+    float hitT = (-b - sqrtf(discriminant)) / a;
+    if (hitT > maxT) {
+        return false;
+    }
+    t = hitT;
+    return true;
+}
+
+// 点 origin + diff * t (0 <= t <= maxT) がカプセル(線分 start ~ end から radius 以内)に入る時刻
+// カプセルは円柱の側面と両端の球に分けて、最も早いものを求める
+bool IntersectMovingPointCapsule(const Vector3& origin, const Vector3& diff, const Vector3& start, const Vector3& end, float radius, float maxT, float& t)
+{
+    bool isHit = false;
+
+    Vector3 axis = end - start;
+    float axisLengthSq = Dot(axis, axis);
+    if (axisLengthSq > 0.0f) {
+        // 軸に垂直な成分だけで、無限の円柱に入る時刻を求める
+        Vector3 m = origin - start;
+        float mAxis = Dot(m, axis);
+        float diffAxis = Dot(diff, axis);
+        Vector3 mPerp = m - axis * (mAxis / axisLengthSq);
+        Vector3 diffPerp = diff - axis * (diffAxis / axisLengthSq);
+
+        float a = Dot(diffPerp, diffPerp);
+        float b = Dot(mPerp, diffPerp);
+        float c = Dot(mPerp, mPerp) - radius * radius;
+        // 円柱の外から近づく場合だけ(中にある場合は両端の球から入る)
+        if (c > 0.0f && b < 0.0f) {
+            float discriminant = b * b - a * c;
+            if (discriminant >= 0.0f) {
+                float sideT = (-b - sqrtf(discriminant)) / a;
+                // 入った位置が両端の間にあれば側面に当たる
+                float axisPosition = mAxis + diffAxis * sideT;
+                if (sideT <= maxT && axisPosition >= 0.0f && axisPosition <= axisLengthSq) {
+                    maxT = sideT;
+                    t = sideT;
+                    isHit = true;
+                }
+            }
+        }
+    }
+
+    float sphereT;
+    if (IntersectMovingPointSphere(origin, diff, start, radius, maxT, sphereT)) {
+        maxT = sphereT;
+        t = sphereT;
+        isHit = true;
+    }
+    if (IntersectMovingPointSphere(origin, diff, end, radius, maxT, sphereT)) {
+        t = sphereT;
+        isHit = true;
+    }
+    return isHit;
+}
+
+// 三角形上の最近接点(頂点・辺・面のどの領域にあるかで分ける)
+Vector3 ClosestPointOnTriangle(const Vector3& point, const Triangle& triangle)
+{
+    const Vector3& a = triangle.vertices[0];
+    const Vector3& b = triangle.vertices[1];
+    const Vector3& c = triangle.vertices[2];
+    Vector3 ab = b - a;
+    Vector3 ac = c - a;
+
+    Vector3 ap = point - a;
+    float d1 = Dot(ab, ap);
+    float d2 = Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return a;
+    }
+
+    Vector3 bp = point - b;
+    float d3 = Dot(ab, bp);
+    float d4 = Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return b;
+    }
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    Vector3 cp = point - c;
+    float d5 = Dot(ab, cp);
+    float d6 = Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return c;
+    }
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+// 時刻 t の球の中心と、相手の形状上の最近接点から接触情報を作る
+void SetSweepContact(const Vector3& center, const Vector3& closestPoint, float t, Contact& contact)
+{
+    Vector3 diff = center - closestPoint;
+    float distanceSq = Dot(diff, diff);
+    contact.normal = distanceSq > 0.0f ? diff * (1.0f / sqrtf(distanceSq)) : Vector3 { 0.0f, 1.0f, 0.0f };
+    contact.penetration = 0.0f;
+    contact.point = closestPoint;
+    contact.t = t;
+}
+
+} // namespace
+
+// 移動する球と平面の衝突時刻
+bool SweepSphere(const Sphere& sphere, const Vector3& displacement, const Plane& plane, Contact& contact)
+{
+    float distance = Dot(plane.normal, sphere.center) - plane.distance;
+    if (fabsf(distance) <= sphere.radius) {
+        return Collide(sphere, plane, contact);
+    }
+
+    // 平面までの隙間を、移動で平面に近づく量で割る
+    float side = std::copysign(1.0f, distance);
+    float gap = fabsf(distance) - sphere.radius;
+    float approach = -Dot(plane.normal, displacement) * side;
+    if (approach < gap) {
+        return false; // 届かない(遠ざかる場合も含む)
+    }
+
+    float t = gap / approach;
+    contact.normal = plane.normal * side;
+    contact.penetration = 0.0f;
+    contact.point = sphere.center + displacement * t - contact.normal * sphere.radius;
+    contact.t = t;
+    return true;
+}
+
+// 移動する球とAABBの衝突時刻
+bool SweepSphere(const Sphere& sphere, const Vector3& displacement, const AABB& aabb, Contact& contact)
+{
+    if (Collide(sphere, aabb, contact)) {
+        return true;
+    }
+
+    // 半径だけ広げた AABB と中心の線分をスラブ法で判定する
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        float origin = AxisValue(sphere.center, axis);
+        float diff = AxisValue(displacement, axis);
+        float slabMin = AxisValue(aabb.min, axis) - sphere.radius;
+        float slabMax = AxisValue(aabb.max, axis) + sphere.radius;
+        if (diff == 0.0f) {
+            if (origin < slabMin || origin > slabMax) {
+                return false;
+            }
+            continue;
+        }
+
+        float t1 = (slabMin - origin) / diff;
+        float t2 = (slabMax - origin) / diff;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+
+    // 広げた AABB に入った点が、元の AABB の外にある軸を調べる
+    Vector3 entry = sphere.center + displacement * tMin;
+    int lowMask = 0;
+    int highMask = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (AxisValue(entry, axis) < AxisValue(aabb.min, axis)) {
+            lowMask |= 1 << axis;
+        } else if (AxisValue(entry, axis) > AxisValue(aabb.max, axis)) {
+            highMask |= 1 << axis;
+        }
+    }
+    int outsideMask = lowMask | highMask;
+    int outsideCount = (outsideMask & 1) + ((outsideMask >> 1) & 1) + ((outsideMask >> 2) & 1);
+
+    float t = tMin;
+    if (outsideCount >= 2) {
+        // 辺や頂点の近く(広げた AABB の角は丸まっている)。角の頂点から伸びる辺のカプセルと判定し直す
+        Vector3 corner = {
+            (highMask & 1) ? aabb.max.x : aabb.min.x,
+            (highMask & 2) ? aabb.max.y : aabb.min.y,
+            (highMask & 4) ? aabb.max.z : aabb.min.z,
+        };
+
+        bool isHit = false;
+        float edgeMaxT = tMax;
+        for (int axis = 0; axis < 3; ++axis) {
+            // 2軸で外にある場合は残りの1軸に沿った辺だけ
+            if (outsideCount == 2 && (outsideMask & (1 << axis))) {
+                continue;
+            }
+            Vector3 start = WithAxisValue(corner, axis, AxisValue(aabb.min, axis));
+            Vector3 end = WithAxisValue(corner, axis, AxisValue(aabb.max, axis));
+            float edgeT;
+            if (IntersectMovingPointCapsule(sphere.center, displacement, start, end, sphere.radius, edgeMaxT, edgeT)) {
+                edgeMaxT = edgeT;
+                isHit = true;
+            }
+        }
+        if (!isHit) {
+            return false;
+        }
+        t = edgeMaxT;
+    }
+
+    Vector3 center = sphere.center + displacement * t;
+    Vector3 closestPoint = {
+        std::clamp(center.x, aabb.min.x, aabb.max.x),
+        std::clamp(center.y, aabb.min.y, aabb.max.y),
+        std::clamp(center.z, aabb.min.z, aabb.max.z)
+    };
+    SetSweepContact(center, closestPoint, t, contact);
+    return true;
+}
+
+// 移動する球と三角形の衝突時刻
+bool SweepSphere(const Sphere& sphere, const Vector3& displacement, const Triangle& triangle, Contact& contact)
+{
+    const Vector3& a = triangle.vertices[0];
+    const Vector3& b = triangle.vertices[1];
+    const Vector3& c = triangle.vertices[2];
+    Vector3 normal = Cross(b - a, c - a);
+    float normalLength = Length(normal);
+
+    // 移動前から重なっている
+    Vector3 closestPoint = ClosestPointOnTriangle(sphere.center, triangle);
+    Vector3 diff = sphere.center - closestPoint;
+    float distanceSq = Dot(diff, diff);
+    if (distanceSq <= sphere.radius * sphere.radius) {
+        float distance = sqrtf(distanceSq);
+        if (distance > 0.0f) {
+            contact.normal = diff * (1.0f / distance);
+        } else if (normalLength > 0.0f) {
+            contact.normal = normal * (1.0f / normalLength);
+        } else {
+            contact.normal = { 0.0f, 1.0f, 0.0f };
+        }
+        contact.penetration = sphere.radius - distance;
+        contact.point = closestPoint;
+        contact.t = 0.0f;
+        return true;
+    }
+
+    // 面の内側に当たる場合は、辺や頂点より先に面に当たる
+    if (normalLength > 0.0f) {
+        Vector3 unitNormal = normal * (1.0f / normalLength);
+        float planeDistance = Dot(unitNormal, sphere.center - a);
+        float side = std::copysign(1.0f, planeDistance);
+        float gap = fabsf(planeDistance) - sphere.radius;
+        float approach = -Dot(unitNormal, displacement) * side;
+        if (gap > 0.0f && approach >= gap) {
+            float t = gap / approach;
+            Vector3 center = sphere.center + displacement * t;
+            Vector3 point = center - unitNormal * (side * sphere.radius);
+            if (Dot(Cross(b - a, point - a), normal) >= 0.0f && Dot(Cross(c - b, point - b), normal) >= 0.0f && Dot(Cross(a - c, point - c), normal) >= 0.0f) {
+                contact.normal = unitNormal * side;
+                contact.penetration = 0.0f;
+                contact.point = point;
+                contact.t = t;
+                return true;
+            }
+        }
+    }
+
+    // 辺のカプセル(両端の球で頂点も含む)
+    bool isHit = false;
+    float maxT = 1.0f;
+    for (int i = 0; i < 3; ++i) {
+        float edgeT;
+        if (IntersectMovingPointCapsule(sphere.center, displacement, triangle.vertices[i], triangle.vertices[(i + 1) % 3], sphere.radius, maxT, edgeT)) {
+            maxT = edgeT;
+            isHit = true;
+        }
+    }
+    if (!isHit) {
+        return false;
+    }
+
+    Vector3 center = sphere.center + displacement * maxT;
+    SetSweepContact(center, ClosestPointOnTriangle(center, triangle), maxT, contact);
+    return true;
+}
+
+// 移動する球同士の衝突時刻
+bool SweepSphere(const Sphere& sphere1, const Vector3& displacement1, const Sphere& sphere2, const Vector3& displacement2, Contact& contact)
+{
+    if (Collide(sphere1, sphere2, contact)) {
+        return true;
+    }
+
+    // 球2から見た球1の中心の相対的な動きが、半径の和の球に入る時刻
+    float t;
+    if (!IntersectMovingPointSphere(sphere1.center - sphere2.center, displacement1 - displacement2, { 0.0f, 0.0f, 0.0f }, sphere1.radius + sphere2.radius, 1.0f, t)) {
+        return false;
+    }
+
+    Vector3 center1 = sphere1.center + displacement1 * t;
+    Vector3 center2 = sphere2.center + displacement2 * t;
+    SetSweepContact(center1, center2, t, contact);
+    contact.point = center2 + contact.normal * sphere2.radius;
+    return true;
+}
@@ -2,6 +2,16 @@
 
 #include "MyMath.h"
 
+/// <summary>
+/// 接触情報(Collide の結果)
+/// </summary>
+struct Contact {
+    Vector3 normal; //!< 接触法線(正規化済み。1つ目の形状を押し出す向き)
+    float penetration; //!< めり込み量(法線方向に押し出す距離)
+    Vector3 point; //!< 接触点
+    float t; //!< 線分の交点の位置(origin + diff * t)、または移動の中で衝突する時刻の割合(0 ~ 1)。それ以外は0
+};
+
 /// <summary>
 /// 平面と球の衝突判定
 /// </summary>
@@ -38,4 +48,116 @@ bool IsCollision(const AABB& aabb1, const AABB& aabb2);
 bool IsCollision(const Sphere& sphere, const AABB& aabb);
 
 // AABBと線分の衝突
-bool IsCollision(const AABB& aabb, const Segment& segment);
\ No newline at end of file
+bool IsCollision(const AABB& aabb, const Segment& segment);
+
+// 球と視錐台の衝突(視錐台の角付近では外側でも true になることがある)
+bool IsCollision(const Sphere& sphere, const Frustum& frustum);
+
+// AABBと視錐台の衝突(視錐台の角付近では外側でも true になることがある)
+bool IsCollision(const AABB& aabb, const Frustum& frustum);
+
+// OBBとOBBの衝突(分離軸判定。15軸を軸の種類ごとにまとめて調べ、分離軸が見つかった時点で打ち切る)
+bool IsCollision(const OBB& obb1, const OBB& obb2);
+
+// 球とOBBの衝突
+bool IsCollision(const Sphere& sphere, const OBB& obb);
+
+// OBBと線分の衝突
+bool IsCollision(const OBB& obb, const Segment& segment);
+
+// OBBと平面の衝突
+bool IsCollision(const OBB& obb, const Plane& plane);
+
+//================================================
+// 　接触情報を求める衝突判定
+//
+// IsCollision と同じ条件で判定し、衝突していれば応答に使う接触情報を返す
+// 距離は2乗のまま比較し、平方根は衝突した場合に法線を求めるときだけ計算する
+//================================================
+
+/// <summary>
+/// 球と平面の接触(平面の法線は正規化済みであること)
+/// </summary>
+/// <param name="sphere">球</param>
+/// <param name="plane">平面</param>
+/// <param name="contact">接触情報(法線は球がある側を向く)</param>
+/// <returns>衝突していれば true</returns>
+bool Collide(const Sphere& sphere, const Plane& plane, Contact& contact);
+
+/// <summary>
+/// 球とAABBの接触
+/// </summary>
+/// <param name="sphere">球</param>
+/// <param name="aabb">AABB</param>
+/// <param name="contact">接触情報(法線はAABBから球へ向く。中心がAABBの中にあれば最も近い面の法線)</param>
+/// <returns>衝突していれば true</returns>
+bool Collide(const Sphere& sphere, const AABB& aabb, Contact& contact);
+
+/// <summary>
+/// 球と球の接触
+/// </summary>
+/// <param name="sphere1">球1</param>
+/// <param name="sphere2">球2</param>
+/// <param name="contact">接触情報(法線は球2から球1へ向く。接触点は重なりの中央)</param>
+/// <returns>衝突していれば true</returns>
+bool Collide(const Sphere& sphere1, const Sphere& sphere2, Contact& contact);
+
+/// <summary>
+/// 線分と三角形の接触
+/// </summary>
+/// <param name="segment">線分</param>
+/// <param name="triangle">三角形</param>
+/// <param name="contact">接触情報(法線は線分の始点側を向く。めり込み量は終点が面を越えた距離)</param>
+/// <returns>交わっていれば true</returns>
+bool Collide(const Segment& segment, const Triangle& triangle, Contact& contact);
+
+//================================================
+// 　移動する球の衝突判定(連続衝突判定)
+//
+// 1ステップの移動量(速度 * deltaTime)で球を動かしたときに最初に接触する時刻を求める
+// 移動後の位置だけを調べる判定と違い、小さい球や速い球でもすり抜けない
+// contact.t は衝突した時刻の割合(球の中心は center + displacement * t)、
+// 法線と接触点はその時刻のもので、めり込み量は0
+// 移動前から重なっている場合は t = 0 で、Collide と同じ接触情報を返す
+//================================================
+
+/// <summary>
+/// 移動する球と平面の衝突時刻(平面の法線は正規化済みであること)
+/// </summary>
+/// <param name="sphere">移動前の球</param>
+/// <param name="displacement">球の移動量</param>
+/// <param name="plane">平面</param>
+/// <param name="contact">最初に接触したときの接触情報</param>
+/// <returns>移動中に接触すれば true</returns>
+bool SweepSphere(const Sphere& sphere, const Vector3& displacement, const Plane& plane, Contact& contact);
+
+/// <summary>
+/// 移動する球とAABBの衝突時刻
+/// </summary>
+/// <param name="sphere">移動前の球</param>
+/// <param name="displacement">球の移動量</param>
+/// <param name="aabb">AABB</param>
+/// <param name="contact">最初に接触したときの接触情報</param>
+/// <returns>移動中に接触すれば true</returns>
+bool SweepSphere(const Sphere& sphere, const Vector3& displacement, const AABB& aabb, Contact& contact);
+
+/// <summary>
+/// 移動する球と三角形の衝突時刻(両面)
+/// </summary>
+/// <param name="sphere">移動前の球</param>
+/// <param name="displacement">球の移動量</param>
+/// <param name="triangle">三角形</param>
+/// <param name="contact">最初に接触したときの接触情報</param>
+/// <returns>移動中に接触すれば true</returns>
+bool SweepSphere(const Sphere& sphere, const Vector3& displacement, const Triangle& triangle, Contact& contact);
+
+/// <summary>
+/// 移動する球同士の衝突時刻(同じステップの中でどちらも等速で動くとみなす)
+/// </summary>
+/// <param name="sphere1">移動前の球1</param>
+/// <param name="displacement1">球1の移動量</param>
+/// <param name="sphere2">移動前の球2</param>
+/// <param name="displacement2">球2の移動量</param>
+/// <param name="contact">最初に接触したときの接触情報(法線は球2から球1へ向く)</param>
+/// <returns>移動中に接触すれば true</returns>
+bool SweepSphere(const Sphere& sphere1, const Vector3& displacement1, const Sphere& sphere2, const Vector3& displacement2, Contact& contact);
@@ -1,119 +1,81 @@
 ﻿#include "MyMath.h"
+#include "ScreenProjector.h"
+#include "SphereWireframe.h"
+#include "TransformBatch.h"
 #include <Novice.h>
 #include <assert.h>
 #include <cmath>
-#include <numbers>
+#include <vector>
 
-// ベクトルの加算
-Vector3 Add(const Vector3& v1, const Vector3& v2)
-{
-    return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z };
-}
-
-// ベクトルの減算
-Vector3 Subtract(const Vector3& v1, const Vector3& v2)
-{
-    return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z };
-}
+//================================================
+// 4x4行列関数
+//================================================
 
-// ベクトルのスカラー倍
-Vector3 Multiply(float scalar, const Vector3& v)
+// 逆行列
+Matrix4x4 Inverse(const Matrix4x4& m)
 {
-    return { scalar * v.x, scalar * v.y, scalar * v.z };
+    // 4列目だけで判定できるアフィン行列は3x3部分の逆行列で済ませる
+    // (正規直交性の判定は逆行列の計算と同程度に重いので、剛体変換は呼び出し側で指定する)
+    return Inverse(m, IsAffineMatrixSimd(m.m) ? MatrixType::Affine : MatrixType::General);
 }
 
-// ベクトルの内積
-float Dot(const Vector3& v1, const Vector3& v2)
+// 逆行列(行列の種類を指定)
+Matrix4x4 Inverse(const Matrix4x4& m, MatrixType type)
 {
-    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+    switch (type) {
+    case MatrixType::Rigid:
+        assert(ClassifyMatrix(m) == MatrixType::Rigid);
+        return InverseRigid(m);
+    case MatrixType::Affine:
+        assert(ClassifyMatrix(m) != MatrixType::General);
+        return InverseAffine(m);
+    default:
+        return InverseGeneral(m);
+    }
 }
 
-// ベクトルの長さ
-float Length(const Vector3& v)
+// 行列の分類
+MatrixType ClassifyMatrix(const Matrix4x4& m)
 {
-    return sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
-}
+    // 4列目が (0, 0, 0, 1) でなければ射影を含む
+    if (!IsAffineMatrixSimd(m.m)) {
+        return MatrixType::General;
+    }
 
-// ベクトルの正規化
-Vector3 Normalize(const Vector3& v)
-{
-    float length = Length(v);
-    assert(length != 0.0f); // ゼロ除算を防ぐためのアサーション
+    // 3x3部分の各行が単位長かつ互いに直交していれば剛体変換
+    if (IsOrthonormalMatrixSimd(m.m, kRigidMatrixTolerance)) {
+        return MatrixType::Rigid;
+    }
 
-    return { v.x / length, v.y / length, v.z / length };
+    return MatrixType::Affine;
 }
 
-Vector3 Cross(const Vector3& v1, const Vector3& v2)
+// アフィン行列の逆行列
+Matrix4x4 InverseAffine(const Matrix4x4& m)
 {
-    return {
-        v1.y * v2.z - v1.z * v2.y,
-        v1.z * v2.x - v1.x * v2.z,
-        v1.x * v2.y - v1.y * v2.x
-    };
+    Matrix4x4 result;
+    InverseAffineMatrixSimd(m.m, result.m);
+    return result;
 }
 
-//================================================
-// 4x4行列関数
-//================================================
-
-// 行列の加法
-Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2)
+// 剛体変換行列の逆行列
+Matrix4x4 InverseRigid(const Matrix4x4& m)
 {
     Matrix4x4 result;
-
-    result.m[0][0] = m1.m[0][0] + m2.m[0][0];
-    result.m[0][1] = m1.m[0][1] + m2.m[0][1];
-    result.m[0][2] = m1.m[0][2] + m2.m[0][2];
-    result.m[0][3] = m1.m[0][3] + m2.m[0][3];
-
-    result.m[1][0] = m1.m[1][0] + m2.m[1][0];
-    result.m[1][1] = m1.m[1][1] + m2.m[1][1];
-    result.m[1][2] = m1.m[1][2] + m2.m[1][2];
-    result.m[1][3] = m1.m[1][3] + m2.m[1][3];
-
-    result.m[2][0] = m1.m[2][0] + m2.m[2][0];
-    result.m[2][1] = m1.m[2][1] + m2.m[2][1];
-    result.m[2][2] = m1.m[2][2] + m2.m[2][2];
-    result.m[2][3] = m1.m[2][3] + m2.m[2][3];
-
-    result.m[3][0] = m1.m[3][0] + m2.m[3][0];
-    result.m[3][1] = m1.m[3][1] + m2.m[3][1];
-    result.m[3][2] = m1.m[3][2] + m2.m[3][2];
-    result.m[3][3] = m1.m[3][3] + m2.m[3][3];
-
+    InverseRigidMatrixSimd(m.m, result.m);
     return result;
 }
 
-// 行列の減法
-Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2)
+// 一般の逆行列
+Matrix4x4 InverseGeneral(const Matrix4x4& m)
 {
     Matrix4x4 result;
-
-    result.m[0][0] = m1.m[0][0] - m2.m[0][0];
-    result.m[0][1] = m1.m[0][1] - m2.m[0][1];
-    result.m[0][2] = m1.m[0][2] - m2.m[0][2];
-    result.m[0][3] = m1.m[0][3] - m2.m[0][3];
-
-    result.m[1][0] = m1.m[1][0] - m2.m[1][0];
-    result.m[1][1] = m1.m[1][1] - m2.m[1][1];
-    result.m[1][2] = m1.m[1][2] - m2.m[1][2];
-    result.m[1][3] = m1.m[1][3] - m2.m[1][3];
-
-    result.m[2][0] = m1.m[2][0] - m2.m[2][0];
-    result.m[2][1] = m1.m[2][1] - m2.m[2][1];
-    result.m[2][2] = m1.m[2][2] - m2.m[2][2];
-    result.m[2][3] = m1.m[2][3] - m2.m[2][3];
-
-    result.m[3][0] = m1.m[3][0] - m2.m[3][0];
-    result.m[3][1] = m1.m[3][1] - m2.m[3][1];
-    result.m[3][2] = m1.m[3][2] - m2.m[3][2];
-    result.m[3][3] = m1.m[3][3] - m2.m[3][3];
-
+    InverseMatrixSimd(m.m, result.m);
     return result;
 }
 
-// 行列の積
-Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
+// 行列の積(スカラー実装)
+Matrix4x4 MultiplyScalar(const Matrix4x4& m1, const Matrix4x4& m2)
 {
     Matrix4x4 result;
 
@@ -133,8 +95,8 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
     return result;
 }
 
-// 逆行列
-Matrix4x4 Inverse(const Matrix4x4& m)
+// 逆行列(スカラー実装)
+Matrix4x4 InverseScalar(const Matrix4x4& m)
 {
     Matrix4x4 result;
     float det;
@@ -191,8 +153,8 @@ Matrix4x4 Inverse(const Matrix4x4& m)
     return result;
 }
 
-// 転置行列
-Matrix4x4 Transpose(const Matrix4x4& m)
+// 転置行列(スカラー実装)
+Matrix4x4 TransposeScalar(const Matrix4x4& m)
 {
     Matrix4x4 result;
 
@@ -219,357 +181,93 @@ Matrix4x4 Transpose(const Matrix4x4& m)
     return result;
 }
 
-// 単位行列
-Matrix4x4 MakeIdentity4x4()
-{
-    Matrix4x4 result;
-
-    result.m[0][0] = 1.0f;
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = 1.0f;
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = 1.0f;
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = 0.0f;
-    result.m[3][1] = 0.0f;
-    result.m[3][2] = 0.0f;
-    result.m[3][3] = 1.0f;
-
-    return result;
-}
-
-// 平行移動行列
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate)
-{
-
-    Matrix4x4 result;
-
-    result.m[0][0] = 1.0f;
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = 1.0f;
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = 1.0f;
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = translate.x;
-    result.m[3][1] = translate.y;
-    result.m[3][2] = translate.z;
-    result.m[3][3] = 1.0f;
-
-    return result;
-}
-
-// 拡縮行列
-Matrix4x4 MakeScaleMatrix(const Vector3& scale)
-{
-    Matrix4x4 result;
-
-    result.m[0][0] = scale.x;
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = scale.y;
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = scale.z;
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = 0.0f;
-    result.m[3][1] = 0.0f;
-    result.m[3][2] = 0.0f;
-    result.m[3][3] = 1.0f;
-
-    return result;
-}
-
-// ベクトルの変換
-Vector3 TransformCoord(const Vector3& vector, const Matrix4x4& matrix)
-{
-    Vector3 result;
-
-    result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
-    result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
-    result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
-    float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + matrix.m[3][3];
-
-    /* assert(w != 0.0f);*/
-
-    result.x /= w;
-    result.y /= w;
-    result.z /= w;
-
-    return result;
-}
-
-// X軸回転行列
-Matrix4x4 MakeRotationXMatrix(float radian)
-{
-
-    Matrix4x4 result;
-    result.m[0][0] = 1.0f;
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = std::cosf(radian);
-    result.m[1][2] = std::sinf(radian);
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = -std::sinf(radian);
-    result.m[2][2] = cosf(radian);
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = 0.0f;
-    result.m[3][1] = 0.0f;
-    result.m[3][2] = 0.0f;
-    result.m[3][3] = 1.0f;
-
-    return result;
-}
-
-// Y軸回転行列
-Matrix4x4 MakeRotationYMatrix(float radian)
-{
-    Matrix4x4 result;
-
-    result.m[0][0] = std::cosf(radian);
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = -std::sinf(radian);
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = 1.0f;
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = std::sinf(radian);
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = std::cosf(radian);
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = 0.0f;
-    result.m[3][1] = 0.0f;
-    result.m[3][2] = 0.0f;
-    result.m[3][3] = 1.0f;
-
-    return result;
-}
-
-// Z軸回転行列
-Matrix4x4 MakeRotationZMatrix(float radian)
-{
-
-    Matrix4x4 result;
-
-    result.m[0][0] = std::cosf(radian);
-    result.m[0][1] = std::sinf(radian);
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = -std::sinf(radian);
-    result.m[1][1] = std::cosf(radian);
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = 1.0f;
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = 0.0f;
-    result.m[3][1] = 0.0f;
-    result.m[3][2] = 0.0f;
-    result.m[3][3] = 1.0f;
-
-    return result;
-}
-
-// アフィン変換行列
-Matrix4x4 makeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate)
-{
-    Matrix4x4 result;
-
-    // 回転行列を個別に計算
-    float cosX = std::cosf(rotate.x);
-    float sinX = std::sinf(rotate.x);
-    float cosY = std::cosf(rotate.y);
-    float sinY = std::sinf(rotate.y);
-    float cosZ = std::cosf(rotate.z);
-    float sinZ = std::sinf(rotate.z);
-
-    result.m[0][0] = scale.x * (cosY * cosZ);
-    result.m[0][1] = scale.x * (cosY * sinZ);
-    result.m[0][2] = scale.x * (-sinY);
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = scale.y * (sinX * sinY * cosZ - cosX * sinZ);
-    result.m[1][1] = scale.y * (sinX * sinY * sinZ + cosX * cosZ);
-    result.m[1][2] = scale.y * (sinX * cosY);
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = scale.z * (cosX * sinY * cosZ + sinX * sinZ);
-    result.m[2][1] = scale.z * (cosX * sinY * sinZ - sinX * cosZ);
-    result.m[2][2] = scale.z * (cosX * cosY);
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = translate.x;
-    result.m[3][1] = translate.y;
-    result.m[3][2] = translate.z;
-    result.m[3][3] = 1.0f;
-
-    return result;
-}
-
-Matrix4x4 MakeLookAtMatrix(const Vector3& eye, const Vector3& target, const Vector3& up)
-{
-    // 視線方向（カメラのZ軸）
-    Vector3 zAxis = Normalize(Subtract(target, eye));
-    // 右方向（カメラのX軸）
-    Vector3 xAxis = Normalize(Cross(up, zAxis));
-    // 上方向（カメラのY軸）
-    Vector3 yAxis = Cross(zAxis, xAxis);
-
-    // 行優先（または列優先）に応じて要調整
-    Matrix4x4 result = {
-        xAxis.x, yAxis.x, zAxis.x, 0.0f,
-        xAxis.y, yAxis.y, zAxis.y, 0.0f,
-        xAxis.z, yAxis.z, zAxis.z, 0.0f,
-        -Dot(xAxis, eye), -Dot(yAxis, eye), -Dot(zAxis, eye), 1.0f
-    };
-
-    return result;
-}
-
 //================================================
-// 　レンダリングパイプライン用
+// レンダリングパイプライン用
 //================================================
 
-// 透視投影行列
-Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip)
-{
-    Matrix4x4 result;
-
-    result.m[0][0] = 1.0f / (aspectRatio * std::tanf(fovY / 2.0f));
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = 1.0f / std::tanf(fovY / 2.0f);
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = farClip / (farClip - nearClip);
-    result.m[2][3] = 1.0f;
-
-    result.m[3][0] = 0.0f;
-    result.m[3][1] = 0.0f;
-    result.m[3][2] = -nearClip * farClip / (farClip - nearClip);
-    result.m[3][3] = 0.0f;
-
-    return result;
-}
-
-// 正射影行列
-Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip)
+// 視錐台
+Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix)
 {
-    Matrix4x4 result;
-
-    result.m[0][0] = 2.0f / (right - left);
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = 2.0f / (top - bottom);
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
+    const Matrix4x4& m = viewProjectionMatrix;
 
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = 1.0f / (farClip - nearClip);
-    result.m[2][3] = 0.0f;
+    // クリップ空間の列(行ベクトルなので p * M の各成分は列との内積)
+    float column[4][4];
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            column[i][j] = m.m[j][i];
+        }
+    }
 
-    result.m[3][0] = -(right + left) / (right - left);
-    result.m[3][1] = -(top + bottom) / (top - bottom);
-    result.m[3][2] = -nearClip / (farClip - nearClip);
-    result.m[3][3] = 1.0f;
+    // -w <= x <= w, -w <= y <= w, 0 <= z <= w の各不等式を a*x + b*y + c*z + d >= 0 の形にする
+    float coefficients[6][4];
+    for (int j = 0; j < 4; ++j) {
+        coefficients[0][j] = column[3][j] + column[0][j]; // 左
+        coefficients[1][j] = column[3][j] - column[0][j]; // 右
+        coefficients[2][j] = column[3][j] + column[1][j]; // 下
+        coefficients[3][j] = column[3][j] - column[1][j]; // 上
+        coefficients[4][j] = column[2][j]; // 近
+        coefficients[5][j] = column[3][j] - column[2][j]; // 遠
+    }
 
-    return result;
+    Frustum frustum {};
+    for (int i = 0; i < 6; ++i) {
+        Vector3 normal = { coefficients[i][0], coefficients[i][1], coefficients[i][2] };
+        float invLength = 1.0f / Length(normal);
+        frustum.planes[i].normal = normal * invLength;
+        frustum.planes[i].distance = -coefficients[i][3] * invLength;
+    }
+    return frustum;
 }
 
-// ビューポート変換行列
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth)
+// OBB
+OBB MakeOBB(const AABB& localAABB, const Matrix4x4& worldMatrix)
 {
+    OBB obb {};
+    obb.center = TransformCoord((localAABB.min + localAABB.max) * 0.5f, worldMatrix);
+
+    // 行ベクトルなので、1~3行目が拡大縮小込みの座標軸になる
+    Vector3 halfSize = (localAABB.max - localAABB.min) * 0.5f;
+    float scales[3];
+    for (int i = 0; i < 3; ++i) {
+        Vector3 axis = { worldMatrix.m[i][0], worldMatrix.m[i][1], worldMatrix.m[i][2] };
+        scales[i] = Length(axis);
+        if (scales[i] != 0.0f) {
+            obb.orientations[i] = axis * (1.0f / scales[i]);
+        }
+    }
 
-    Matrix4x4 result;
-
-    result.m[0][0] = width / 2.0f;
-    result.m[0][1] = 0.0f;
-    result.m[0][2] = 0.0f;
-    result.m[0][3] = 0.0f;
-
-    result.m[1][0] = 0.0f;
-    result.m[1][1] = -height / 2.0f;
-    result.m[1][2] = 0.0f;
-    result.m[1][3] = 0.0f;
-
-    result.m[2][0] = 0.0f;
-    result.m[2][1] = 0.0f;
-    result.m[2][2] = maxDepth - minDepth;
-    result.m[2][3] = 0.0f;
-
-    result.m[3][0] = left + width / 2.0f;
-    result.m[3][1] = top + height / 2.0f;
-    result.m[3][2] = minDepth;
-    result.m[3][3] = 1.0f;
+    // 拡大縮小が0の軸は、残りの2軸の外積で補う(その軸の厚さが0の OBB になる)
+    for (int i = 0; i < 3; ++i) {
+        if (scales[i] != 0.0f) {
+            continue;
+        }
+        const Vector3& axis1 = obb.orientations[(i + 1) % 3];
+        const Vector3& axis2 = obb.orientations[(i + 2) % 3];
+        Vector3 axis = Cross(axis1, axis2);
+        if (Length(axis) == 0.0f) {
+            // 残りの軸も0なら、求まっている軸と直交するようにワールドの軸から作る
+            Vector3 known = Length(axis1) != 0.0f ? axis1 : axis2;
+            for (int k = 0; k < 3; ++k) {
+                int worldAxis = (i + k) % 3;
+                Vector3 candidate = { worldAxis == 0 ? 1.0f : 0.0f, worldAxis == 1 ? 1.0f : 0.0f, worldAxis == 2 ? 1.0f : 0.0f };
+                axis = candidate - known * Dot(candidate, known);
+                if (Length(axis) > 0.5f) {
+                    break;
+                }
+            }
+        }
+        obb.orientations[i] = Normalize(axis);
+    }
 
-    return result;
+    obb.size = { halfSize.x * scales[0], halfSize.y * scales[1], halfSize.z * scales[2] };
+    return obb;
 }
 
-// ベクトルの射影
-Vector3 Project(const Vector3& v1, const Vector3 v2)
-{
-    Vector3 result;
-
-    float dot = Dot(v1, v2);
-    float v2LengthSq = Dot(v2, v2);
-
-    float scalar = dot / v2LengthSq;
-
-    result.x = scalar * v2.x;
-    result.y = scalar * v2.y;
-    result.z = scalar * v2.z;
-
-    return result;
-}
+//================================================
+// ベクトル
+//================================================
 
+// 最接近点
 Vector3 ClosestPoint(const Vector3& point, const Segment& segment)
 {
     Vector3 result;
@@ -588,12 +286,9 @@ Vector3 ClosestPoint(const Vector3& point, const Segment& segment)
         point.z - segment.origin.z
     };
 
-    // APベクトルの長さ
-    Vector3 proj = Project(ap, ab);
-
-    // スカラー値tを求める
+    // スカラー値tを求める(長さ0の線分は始点)
     float abLengthSq = Dot(ab, ab);
-    float t = Dot(ap, ab) / abLengthSq;
+    float t = abLengthSq > 0.0f ? Dot(ap, ab) / abLengthSq : 0.0f;
 
     // tを0~1にクランプ
     if (t < 0.0f) {
@@ -613,16 +308,6 @@ Vector3 ClosestPoint(const Vector3& point, const Segment& segment)
     return result;
 }
 
-Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t)
-{
-    Vector3 result;
-    // v1とv2の間をtの割合で補間
-    result.x = v1.x + (v2.x - v1.x) * t;
-    result.y = v1.y + (v2.y - v1.y) * t;
-    result.z = v1.z + (v2.z - v1.z) * t;
-    return result;
-}
-
 // デバッグ用関数
 void MatrixScreenPrintf(int x, int y, const Matrix4x4& matrix)
 {
@@ -644,6 +329,11 @@ void VectorScreenPrintf(int x, int y, const Vector3& vector)
 // 球描画用(後で分ける)
 //   グリッドを描画する
 void DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix)
+{
+    DrawGrid(ScreenProjector(viewProjectionMatrix, viewportMatrix));
+}
+
+void DrawGrid(const ScreenProjector& projector)
 {
     // グリッド半分の幅
     const float kGridHalfWidth = 2.0f;
@@ -655,111 +345,55 @@ void DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMa
     // 奥から手前への線を順番に描画
     for (uint32_t i = 0; i <= kSubDivision; ++i) {
         // 上の情報を使ってワールド座標系上の始点と終点を計算
-
         Vector3 start = { -kGridHalfWidth + kGridEvery * i, 0.0f, -kGridHalfWidth };
         Vector3 end = { -kGridHalfWidth + kGridEvery * i, 0.0f, kGridHalfWidth };
 
-        Vector3 ndcStart = TransformCoord(start, viewProjectionMatrix);
-        Vector3 ndcEnd = TransformCoord(end, viewProjectionMatrix);
-
-        // スクリーン座標系まで掛ける
-        Vector3 startScreen = TransformCoord(ndcStart, viewportMatrix);
-        Vector3 endScreen = TransformCoord(ndcEnd, viewportMatrix);
-
         // 変換した座標を使い、線を描画
-        Novice::DrawLine(
-            int(startScreen.x), int(startScreen.y),
-            int(endScreen.x), int(endScreen.y),
-            0xAAAAAAFF);
-
-        if (i == 5) {
-            Novice::DrawLine(
-                int(startScreen.x), int(startScreen.y),
-                int(endScreen.x), int(endScreen.y),
-                0x000000FF);
-        }
+        projector.DrawLine(start, end, i == 5 ? 0x000000FF : 0xAAAAAAFF);
     }
 
     for (uint32_t i = 0; i <= kSubDivision; ++i) {
         // 上の情報を使ってワールド座標系上の始点と終点を計算
-
         Vector3 start = { -kGridHalfWidth, 0.0f, -kGridHalfWidth + kGridEvery * i };
         Vector3 end = { kGridHalfWidth, 0.0f, -kGridHalfWidth + kGridEvery * i };
 
-        Vector3 ndcStart = TransformCoord(start, viewProjectionMatrix);
-        Vector3 ndcEnd = TransformCoord(end, viewProjectionMatrix);
-
-        // スクリーン座標系まで掛ける
-        Vector3 startScreen = TransformCoord(ndcStart, viewportMatrix);
-        Vector3 endScreen = TransformCoord(ndcEnd, viewportMatrix);
-
         // 変換した座標を使い、線を描画
-        Novice::DrawLine(
-            int(startScreen.x), int(startScreen.y),
-            int(endScreen.x), int(endScreen.y),
-            0xAAAAAAFF);
-
-        if (i == 5) {
-            Novice::DrawLine(
-                int(startScreen.x), int(startScreen.y),
-                int(endScreen.x), int(endScreen.y),
-                0x000000FF);
-        }
+        projector.DrawLine(start, end, i == 5 ? 0x000000FF : 0xAAAAAAFF);
     }
 }
 
 // スフィアを描画
 void DrawSphere(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
 {
-    // 球の分割数
-    const uint32_t kSubDivision = 20;
-
-    // 経度分割１つ分の角度
-    const float kLongEvery = 2.0f * std::numbers::pi_v<float> / static_cast<float>(kSubDivision);
-
-    // 緯度分割１つ分の角度
-    const float kLatEvery = std::numbers::pi_v<float> / static_cast<float>(kSubDivision);
-
-    // 緯度の方向に分割 -π/2 ~ π/2
-    for (uint32_t latIndex = 0; latIndex < kSubDivision; ++latIndex) {
-
-        // 現在の緯度
-        float lat = -std::numbers::pi_v<float> / 2.0f + kLatEvery * latIndex;
-
-        // 経度の方向に分割 0 ~ 2π
-        for (uint32_t lonIndex = 0; lonIndex < kSubDivision; ++lonIndex) {
-
-            // 現在の経度
-            float lon = kLongEvery * lonIndex;
-
-            // 各頂点の計算
-            Vector3 a, b, c;
-
-            a.x = std::cos(lat) * std::cos(lon) * sphere.radius + sphere.center.x;
-            a.y = std::sin(lat) * sphere.radius + sphere.center.y;
-            a.z = std::cos(lat) * std::sin(lon) * sphere.radius + sphere.center.z;
-
-            b.x = std::cos(lat + kLatEvery) * std::cos(lon) * sphere.radius + sphere.center.x;
-            b.y = std::sin(lat + kLatEvery) * sphere.radius + sphere.center.y;
-            b.z = std::cos(lat + kLatEvery) * std::sin(lon) * sphere.radius + sphere.center.z;
-
-            c.x = sphere.radius * std::cos(lat) * std::cos(lon + kLongEvery) + sphere.center.x;
-            c.y = sphere.radius * std::sin(lat) + sphere.center.y;
-            c.z = sphere.radius * std::cos(lat) * std::sin(lon + kLongEvery) + sphere.center.z;
-
-            // ビュー座標系に変換
-            Vector3 aView = TransformCoord(a, viewProjectionMatrix);
-            Vector3 bView = TransformCoord(b, viewProjectionMatrix);
-            Vector3 cView = TransformCoord(c, viewProjectionMatrix);
-
-            // スクリーン座標系に変換
-            Vector3 aScreen = TransformCoord(aView, viewportMatrix);
-            Vector3 bScreen = TransformCoord(bView, viewportMatrix);
-            Vector3 cScreen = TransformCoord(cView, viewportMatrix);
+    DrawSphere(sphere, ScreenProjector(viewProjectionMatrix, viewportMatrix), color);
+}
 
-            // 線を描画
-            Novice::DrawLine(int(aScreen.x), int(aScreen.y), int(bScreen.x), int(bScreen.y), color);
-            Novice::DrawLine(int(aScreen.x), int(aScreen.y), int(cScreen.x), int(cScreen.y), color);
-        }
+void DrawSphere(const Sphere& sphere, const ScreenProjector& projector, uint32_t color)
+{
+    // 球の分割数(画面上の大きさに応じてこの範囲で選ぶ)
+    const uint32_t kMinSubDivision = 4;
+    const uint32_t kMaxSubDivision = 20;
+
+    uint32_t subdivision = projector.SelectCircleSegmentCount(projector.ScreenRadius(sphere), kMinSubDivision, kMaxSubDivision);
+
+    // 単位球の頂点と線分は分割数ごとに共有する
+    const SphereWireframe& wireframe = GetSphereWireframe(subdivision);
+
+    // 単位球から球への変換(拡大と平行移動のみ)
+    Matrix4x4 sphereMatrix = MakeScaleMatrix({ sphere.radius, sphere.radius, sphere.radius });
+    sphereMatrix.m[3][0] = sphere.center.x;
+    sphereMatrix.m[3][1] = sphere.center.y;
+    sphereMatrix.m[3][2] = sphere.center.z;
+
+    // 近クリップ面をまたぐ場合はワールド座標に直して線分ごとにクリッピング
+    if (!projector.IsInFrontOfNearPlane(sphere)) {
+        thread_local std::vector<Vector3> worldPoints;
+        worldPoints.resize(wireframe.vertices.size());
+        TransformCoords(wireframe.vertices, worldPoints, sphereMatrix);
+        projector.DrawLines(worldPoints, wireframe.indices, color);
+        return;
     }
+
+    // 拡大・平行移動・射影を1つの行列にまとめて、共有頂点を1回ずつ変換する
+    projector.DrawLinesUnclipped(wireframe.vertices, wireframe.indices, sphereMatrix, color);
 }
@@ -1,13 +1,19 @@
 ﻿#pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <numbers>
+#include <type_traits>
 
 #include "Matrix/Matrix4x4.h"
+#include "Quaternion/Quaternion.h"
 #include "Vector/Vector3.h"
 
+struct ScreenProjector;
+
 static const int kRowHeight = 20;
 static const int kColumnWidth = 60;
 
@@ -47,99 +53,618 @@ struct AABB {
     Vector3 max; //!< 最大点
 };
 
+/// <summary>
+/// 有向境界箱
+/// </summary>
+struct OBB {
+    Vector3 center; //!< 中心
+    Vector3 orientations[3]; //!< 座標軸(正規化済みで互いに直交)
+    Vector3 size; //!< 座標軸方向の長さの半分
+};
+
+/// <summary>
+/// 視錐台
+/// </summary>
+struct Frustum {
+    Plane planes[6]; //!< 左, 右, 下, 上, 近, 遠(法線は内向きで正規化済み。Dot(normal, p) >= distance が内側)
+};
+
+/// <summary>
+/// 逆行列の計算方法を選ぶための行列の分類
+/// </summary>
+enum class MatrixType {
+    Rigid, //!< 回転+平行移動のみ(3x3部分が正規直交)
+    Affine, //!< アフィン変換(4列目が (0, 0, 0, 1))
+    General, //!< 射影を含む一般の行列
+};
+
+// 剛体変換とみなす3x3部分の正規直交性の許容誤差
+constexpr float kRigidMatrixTolerance = 1e-5f;
+
+//================================================
+// 　コンパイル時計算用
+//================================================
+
+// 三角関数(定数式の評価時のみ使用する。実行時は std::sinf, std::cosf を使う)
+constexpr double ConstexprSin(double radian)
+{
+    constexpr double kPi = std::numbers::pi_v<double>;
+
+    // [-π, π] に範囲を縮める
+    while (radian > kPi) {
+        radian -= 2.0 * kPi;
+    }
+    while (radian < -kPi) {
+        radian += 2.0 * kPi;
+    }
+
+    // テイラー展開
+    double term = radian;
+    double sum = radian;
+    for (int i = 1; i < 16; ++i) {
+        term *= -radian * radian / ((2.0 * i) * (2.0 * i + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double ConstexprCos(double radian)
+{
+    return ConstexprSin(radian + std::numbers::pi_v<double> / 2.0);
+}
+
+//================================================
+// 　ベクトル関数
+//================================================
+
 // 加算
-Vector3 Add(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 Add(const Vector3& v1, const Vector3& v2)
+{
+    return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z };
+}
 
 // 減算
-Vector3 Subtract(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 Subtract(const Vector3& v1, const Vector3& v2)
+{
+    return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z };
+}
 
 // スカラー倍
-Vector3 Multiply(float scalar, const Vector3& v);
+constexpr Vector3 Multiply(float scalar, const Vector3& v)
+{
+    return { scalar * v.x, scalar * v.y, scalar * v.z };
+}
 
 // 内積
-float Dot(const Vector3& v1, const Vector3& v2);
+constexpr float Dot(const Vector3& v1, const Vector3& v2)
+{
+    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
 
 // 長さ
-float Length(const Vector3& v);
+inline float Length(const Vector3& v)
+{
+    return sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+}
 
 // 正規化
-Vector3 Normalize(const Vector3& v);
+inline Vector3 Normalize(const Vector3& v)
+{
+    float length = Length(v);
+    assert(length != 0.0f); // ゼロ除算を防ぐためのアサーション
+
+    return { v.x / length, v.y / length, v.z / length };
+}
 
 // クロス積
-Vector3 Cross(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 Cross(const Vector3& v1, const Vector3& v2)
+{
+    return {
+        v1.y * v2.z - v1.z * v2.y,
+        v1.z * v2.x - v1.x * v2.z,
+        v1.x * v2.y - v1.y * v2.x
+    };
+}
+
+// 軸の成分(axis は 0:x, 1:y, 2:z)
+constexpr float AxisValue(const Vector3& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+//================================================
+// 　AABB関数
+//================================================
+
+// 空の AABB(どの点・AABB と合わせてもその点・AABB になる)
+constexpr AABB MakeEmptyAABB()
+{
+    constexpr float kInfinity = std::numeric_limits<float>::infinity();
+    return { { kInfinity, kInfinity, kInfinity }, { -kInfinity, -kInfinity, -kInfinity } };
+}
+
+// 2つの AABB を囲む AABB
+constexpr AABB Combine(const AABB& aabb1, const AABB& aabb2)
+{
+    return {
+        { std::min(aabb1.min.x, aabb2.min.x), std::min(aabb1.min.y, aabb2.min.y), std::min(aabb1.min.z, aabb2.min.z) },
+        { std::max(aabb1.max.x, aabb2.max.x), std::max(aabb1.max.y, aabb2.max.y), std::max(aabb1.max.z, aabb2.max.z) },
+    };
+}
+
+// AABB と点を囲む AABB
+constexpr AABB Combine(const AABB& aabb, const Vector3& point)
+{
+    return {
+        { std::min(aabb.min.x, point.x), std::min(aabb.min.y, point.y), std::min(aabb.min.z, point.z) },
+        { std::max(aabb.max.x, point.x), std::max(aabb.max.y, point.y), std::max(aabb.max.z, point.z) },
+    };
+}
+
+// 表面積(比較にしか使わないので半分の値。空なら0)
+constexpr float HalfSurfaceArea(const AABB& aabb)
+{
+    if (aabb.min.x > aabb.max.x) {
+        return 0.0f;
+    }
+    Vector3 size = aabb.max - aabb.min;
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+}
 
 //================================================
 // 4x4行列関数
 //================================================
 
 // 行列の加法
-Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2);
+constexpr Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2)
+{
+    return m1 + m2;
+}
 
 // 行列の減法
-Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2);
+constexpr Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2)
+{
+    return m1 - m2;
+}
+
+// 行列の積(定数式ではスカラー実装、実行時はSIMD実装)
+constexpr Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
+{
+    return m1 * m2;
+}
+
+// 逆行列(アフィン行列なら自動で InverseAffine を使う)
+Matrix4x4 Inverse(const Matrix4x4& m);
 
-// 行列の積
-Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+// 逆行列(作成方法から分かっている行列の種類を指定して最も軽い計算方法を選ぶ)
+Matrix4x4 Inverse(const Matrix4x4& m, MatrixType type);
 
-// 逆行列
-Matrix4x4 Inverse(const Matrix4x4& m);
+// 行列の分類(剛体変換の判定を含む)
+MatrixType ClassifyMatrix(const Matrix4x4& m);
 
-// 転置行列
-Matrix4x4 Transpose(const Matrix4x4& m);
+// アフィン行列の逆行列(3x3部分の逆行列と平行移動の打ち消し)
+Matrix4x4 InverseAffine(const Matrix4x4& m);
+
+// 剛体変換行列の逆行列(3x3部分の転置と平行移動の打ち消し)
+Matrix4x4 InverseRigid(const Matrix4x4& m);
+
+// 一般の逆行列(分類せずに4x4の余因子展開を行う)
+Matrix4x4 InverseGeneral(const Matrix4x4& m);
+
+// 転置行列(定数式ではスカラー実装、実行時はSIMD実装)
+constexpr Matrix4x4 Transpose(const Matrix4x4& m)
+{
+    if (std::is_constant_evaluated()) {
+        return {
+            m.m[0][0], m.m[1][0], m.m[2][0], m.m[3][0],
+            m.m[0][1], m.m[1][1], m.m[2][1], m.m[3][1],
+            m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2],
+            m.m[0][3], m.m[1][3], m.m[2][3], m.m[3][3]
+        };
+    }
+
+    Matrix4x4 result {};
+    TransposeMatrixSimd(m.m, result.m);
+    return result;
+}
+
+// 行列の積(スカラー実装。SIMD版との比較・検証用)
+Matrix4x4 MultiplyScalar(const Matrix4x4& m1, const Matrix4x4& m2);
+
+// 逆行列(スカラー実装。SIMD版との比較・検証用)
+Matrix4x4 InverseScalar(const Matrix4x4& m);
+
+// 転置行列(スカラー実装。SIMD版との比較・検証用)
+Matrix4x4 TransposeScalar(const Matrix4x4& m);
 
 // 単位行列
-Matrix4x4 MakeIdentity4x4();
+constexpr Matrix4x4 MakeIdentity4x4()
+{
+    return {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
 
 // 平行移動行列
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate);
+constexpr Matrix4x4 MakeTranslateMatrix(const Vector3& translate)
+{
+    return {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        translate.x, translate.y, translate.z, 1.0f
+    };
+}
 
 // 拡大縮小行列
-Matrix4x4 MakeScaleMatrix(const Vector3& scale);
+constexpr Matrix4x4 MakeScaleMatrix(const Vector3& scale)
+{
+    return {
+        scale.x, 0.0f, 0.0f, 0.0f,
+        0.0f, scale.y, 0.0f, 0.0f,
+        0.0f, 0.0f, scale.z, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
 
 // 　座標変換
-Vector3 TransformCoord(const Vector3& vector, const Matrix4x4& matrix);
+constexpr Vector3 TransformCoord(const Vector3& vector, const Matrix4x4& matrix)
+{
+    Vector3 result {};
+
+    result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + matrix.m[3][0];
+    result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + matrix.m[3][1];
+    result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + matrix.m[3][2];
+    float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + matrix.m[3][3];
+
+    /* assert(w != 0.0f);*/
+
+    result.x /= w;
+    result.y /= w;
+    result.z /= w;
+
+    return result;
+}
 
 // x軸回転行列
-Matrix4x4 MakeRotationXMatrix(float radian);
+inline Matrix4x4 MakeRotationXMatrix(float radian)
+{
+    float cosValue = std::cosf(radian);
+    float sinValue = std::sinf(radian);
+
+    return {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, cosValue, sinValue, 0.0f,
+        0.0f, -sinValue, cosValue, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
 
 // y軸回転行列
-Matrix4x4 MakeRotationYMatrix(float radian);
+inline Matrix4x4 MakeRotationYMatrix(float radian)
+{
+    float cosValue = std::cosf(radian);
+    float sinValue = std::sinf(radian);
+
+    return {
+        cosValue, 0.0f, -sinValue, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        sinValue, 0.0f, cosValue, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
 
 // z軸回転行列
-Matrix4x4 MakeRotationZMatrix(float radian);
+inline Matrix4x4 MakeRotationZMatrix(float radian)
+{
+    float cosValue = std::cosf(radian);
+    float sinValue = std::sinf(radian);
+
+    return {
+        cosValue, sinValue, 0.0f, 0.0f,
+        -sinValue, cosValue, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
 
 // 3次元アフィン変換
-Matrix4x4 makeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
-
-Matrix4x4 MakeLookAtMatrix(const Vector3& eye, const Vector3& target, const Vector3& up);
+inline Matrix4x4 makeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate)
+{
+    // 回転行列を個別に計算
+    float cosX = std::cosf(rotate.x);
+    float sinX = std::sinf(rotate.x);
+    float cosY = std::cosf(rotate.y);
+    float sinY = std::sinf(rotate.y);
+    float cosZ = std::cosf(rotate.z);
+    float sinZ = std::sinf(rotate.z);
+
+    return {
+        scale.x * (cosY * cosZ),
+        scale.x * (cosY * sinZ),
+        scale.x * (-sinY),
+        0.0f,
+
+        scale.y * (sinX * sinY * cosZ - cosX * sinZ),
+        scale.y * (sinX * sinY * sinZ + cosX * cosZ),
+        scale.y * (sinX * cosY),
+        0.0f,
+
+        scale.z * (cosX * sinY * cosZ + sinX * sinZ),
+        scale.z * (cosX * sinY * sinZ - sinX * cosZ),
+        scale.z * (cosX * cosY),
+        0.0f,
+
+        translate.x,
+        translate.y,
+        translate.z,
+        1.0f
+    };
+}
+
+inline Matrix4x4 MakeLookAtMatrix(const Vector3& eye, const Vector3& target, const Vector3& up)
+{
+    // 視線方向（カメラのZ軸）
+    Vector3 zAxis = Normalize(Subtract(target, eye));
+    // 右方向（カメラのX軸）
+    Vector3 xAxis = Normalize(Cross(up, zAxis));
+    // 上方向（カメラのY軸）
+    Vector3 yAxis = Cross(zAxis, xAxis);
+
+    // 行優先（または列優先）に応じて要調整
+    return {
+        xAxis.x, yAxis.x, zAxis.x, 0.0f,
+        xAxis.y, yAxis.y, zAxis.y, 0.0f,
+        xAxis.z, yAxis.z, zAxis.z, 0.0f,
+        -Dot(xAxis, eye), -Dot(yAxis, eye), -Dot(zAxis, eye), 1.0f
+    };
+}
 
 //================================================
 // 　レンダリングパイプライン用
 //================================================
 
-// 透視投影行列
-Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
+// 透視投影行列(定数式でも作成できる)
+constexpr Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip)
+{
+    float tanHalfFovY = 0.0f;
+    if (std::is_constant_evaluated()) {
+        tanHalfFovY = static_cast<float>(ConstexprSin(fovY / 2.0) / ConstexprCos(fovY / 2.0));
+    } else {
+        tanHalfFovY = std::tanf(fovY / 2.0f);
+    }
+
+    return {
+        1.0f / (aspectRatio * tanHalfFovY), 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f / tanHalfFovY, 0.0f, 0.0f,
+        0.0f, 0.0f, farClip / (farClip - nearClip), 1.0f,
+        0.0f, 0.0f, -nearClip * farClip / (farClip - nearClip), 0.0f
+    };
+}
 
 // 正射影行列
-Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
+constexpr Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip)
+{
+    return {
+        2.0f / (right - left), 0.0f, 0.0f, 0.0f,
+        0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f / (farClip - nearClip), 0.0f,
+        -(right + left) / (right - left), -(top + bottom) / (top - bottom), -nearClip / (farClip - nearClip), 1.0f
+    };
+}
 
 // ビューポート変換行列
-Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
+constexpr Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth)
+{
+    return {
+        width / 2.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, -height / 2.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, maxDepth - minDepth, 0.0f,
+        left + width / 2.0f, top + height / 2.0f, minDepth, 1.0f
+    };
+}
+
+// 視錐台(ビュープロジェクション行列から6平面を取り出す)
+Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix);
+
+// ローカル座標の AABB をワールド行列(拡大縮小・回転・平行移動。せん断は不可)で変換した OBB
+// 拡大縮小が0の軸は厚さ0になり、座標軸は残りの軸と直交する向きで補う
+OBB MakeOBB(const AABB& localAABB, const Matrix4x4& worldMatrix);
 
 //================================================
 // ベクトル
 //================================================
 
 // 正射影ベクトル
-Vector3 Project(const Vector3& v1, const Vector3 v2);
-// 最接近点
+constexpr Vector3 Project(const Vector3& v1, const Vector3 v2)
+{
+    float dot = Dot(v1, v2);
+    float v2LengthSq = Dot(v2, v2);
+
+    float scalar = dot / v2LengthSq;
+
+    return { scalar * v2.x, scalar * v2.y, scalar * v2.z };
+}
+
+// 反射ベクトル(法線方向の成分を反転して restitution 倍にし、接線方向の成分はそのまま残す。restitution が1なら鏡面反射)
+constexpr Vector3 Reflect(const Vector3& input, const Vector3& normal, float restitution = 1.0f)
+{
+    Vector3 normalComponent = Project(input, normal);
+    return input - normalComponent * (1.0f + restitution);
+}
+
+// 最接近点(多数の点をまとめて求める場合は ProximityQuery.h の ClosestPoints)
 Vector3 ClosestPoint(const Vector3& point, const Segment& segment);
 
 //================================================
 // 2次ベジェ曲線
 //================================================
 
-Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t);
+constexpr Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t)
+{
+    // v1とv2の間をtの割合で補間
+    return {
+        v1.x + (v2.x - v1.x) * t,
+        v1.y + (v2.y - v1.y) * t,
+        v1.z + (v2.z - v1.z) * t
+    };
+}
+
+//================================================
+// 　クォータニオン関数
+//================================================
+
+// 単位クォータニオン(回転なし)
+constexpr Quaternion IdentityQuaternion()
+{
+    return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+// 積(q2 の回転のあとに q1 の回転)
+constexpr Quaternion Multiply(const Quaternion& q1, const Quaternion& q2)
+{
+    return q1 * q2;
+}
+
+// 共役
+constexpr Quaternion Conjugate(const Quaternion& q)
+{
+    return { -q.x, -q.y, -q.z, q.w };
+}
+
+// 内積
+constexpr float Dot(const Quaternion& q1, const Quaternion& q2)
+{
+    return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+// ノルム
+inline float Norm(const Quaternion& q)
+{
+    return sqrtf(Dot(q, q));
+}
+
+// 正規化
+inline Quaternion Normalize(const Quaternion& q)
+{
+    float norm = Norm(q);
+    assert(norm != 0.0f); // ゼロ除算を防ぐためのアサーション
+
+    return q * (1.0f / norm);
+}
+
+// 逆クォータニオン(回転を表す長さ1のクォータニオンなら Conjugate と同じ)
+inline Quaternion Inverse(const Quaternion& q)
+{
+    float normSq = Dot(q, q);
+    assert(normSq != 0.0f);
+
+    return Conjugate(q) * (1.0f / normSq);
+}
+
+// 任意軸回転(axis は正規化済み)
+inline Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle)
+{
+    float halfSin = std::sinf(angle * 0.5f);
+    return { axis.x * halfSin, axis.y * halfSin, axis.z * halfSin, std::cosf(angle * 0.5f) };
+}
+
+// オイラー角からの回転(makeAffineMatrix と同じく x, y, z 軸の順に回転する)
+inline Quaternion MakeRotateQuaternion(const Vector3& rotate)
+{
+    float cosX = std::cosf(rotate.x * 0.5f);
+    float sinX = std::sinf(rotate.x * 0.5f);
+    float cosY = std::cosf(rotate.y * 0.5f);
+    float sinY = std::sinf(rotate.y * 0.5f);
+    float cosZ = std::cosf(rotate.z * 0.5f);
+    float sinZ = std::sinf(rotate.z * 0.5f);
+
+    // qz * qy * qx を展開したもの
+    return {
+        sinX * cosY * cosZ - cosX * sinY * sinZ,
+        cosX * sinY * cosZ + sinX * cosY * sinZ,
+        cosX * cosY * sinZ - sinX * sinY * cosZ,
+        cosX * cosY * cosZ + sinX * sinY * sinZ
+    };
+}
+
+// ベクトルの回転(q は長さ1)
+constexpr Vector3 RotateVector(const Vector3& v, const Quaternion& q)
+{
+    // q v q* を展開して整理したもの(t = 2 (q.xyz × v), v' = v + w t + q.xyz × t)
+    Vector3 axis = { q.x, q.y, q.z };
+    Vector3 t = Cross(axis, v) * 2.0f;
+    return v + t * q.w + Cross(axis, t);
+}
+
+// 回転行列(q は長さ1)
+constexpr Matrix4x4 MakeRotateMatrix(const Quaternion& q)
+{
+    float xx = q.x * q.x;
+    float yy = q.y * q.y;
+    float zz = q.z * q.z;
+    float xy = q.x * q.y;
+    float xz = q.x * q.z;
+    float yz = q.y * q.z;
+    float wx = q.w * q.x;
+    float wy = q.w * q.y;
+    float wz = q.w * q.z;
+
+    return {
+        1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f,
+        2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f,
+        2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
+
+// 3次元アフィン変換(回転をクォータニオンで指定。三角関数を使わない)
+constexpr Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate)
+{
+    Matrix4x4 result = MakeRotateMatrix(rotate);
+    for (int column = 0; column < 3; ++column) {
+        result.m[0][column] *= scale.x;
+        result.m[1][column] *= scale.y;
+        result.m[2][column] *= scale.z;
+    }
+    result.m[3][0] = translate.x;
+    result.m[3][1] = translate.y;
+    result.m[3][2] = translate.z;
+    return result;
+}
+
+// 正規化線形補間(近い方の回転で補間する。Slerp より軽いが角速度は一定でない)
+inline Quaternion Nlerp(const Quaternion& q1, const Quaternion& q2, float t)
+{
+    Quaternion end = Dot(q1, q2) < 0.0f ? -q2 : q2;
+    return Normalize(q1 + (end - q1) * t);
+}
+
+// 球面線形補間(近い方の回転で補間する)
+inline Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t)
+{
+    float dot = Dot(q1, q2);
+    Quaternion end = q2;
+    if (dot < 0.0f) {
+        end = -q2;
+        dot = -dot;
+    }
+
+    // ほぼ同じ向きなら sin(θ) が0に近づくので Nlerp で代用する
+    const float kNlerpThreshold = 0.9995f;
+    if (dot > kNlerpThreshold) {
+        return Normalize(q1 + (end - q1) * t);
+    }
+
+    float theta = std::acosf(dot);
+    float invSinTheta = 1.0f / std::sinf(theta);
+    float scale1 = std::sinf((1.0f - t) * theta) * invSinTheta;
+    float scale2 = std::sinf(t * theta) * invSinTheta;
+    return q1 * scale1 + end * scale2;
+}
 
 //================================================
 // 　値確認用
@@ -151,6 +676,8 @@ void VectorScreenPrintf(int x, int y, const Vector3& vector);
 
 // グリッド
 void DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix);
+void DrawGrid(const ScreenProjector& projector);
 
 // 球体の描画
 void DrawSphere(const Sphere& sphere, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+void DrawSphere(const Sphere& sphere, const ScreenProjector& projector, uint32_t color);
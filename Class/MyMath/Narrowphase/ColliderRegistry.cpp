@@ -0,0 +1,168 @@
+#include "ColliderRegistry.h"
+#include "../../../Collision.h"
+#include "../MyCollision.h"
+#include "GJK.h"
+#include <array>
+#include <utility>
+
+namespace {
+
+using BucketEntry = ColliderRegistry::BucketEntry;
+using BucketFunction = void (*)(const ColliderRegistry& registry, std::span<const BucketEntry> entries, std::span<uint8_t> results);
+
+// AABB を OBB として扱う(OBB との判定を使い回す)
+OBB ToOBB(const AABB& aabb)
+{
+    return {
+        (aabb.min + aabb.max) * 0.5f,
+        { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+        (aabb.max - aabb.min) * 0.5f
+    };
+}
+
+//================================================
+// 　種類の組み合わせごとの判定(ShapeType の小さい方が1つ目)
+// 既存の IsCollision の引数の順に並べ替えて呼ぶ。ここにない組み合わせ(平面との一部と線分同士)は判定できない
+//================================================
+
+bool Overlaps(const Sphere& sphere1, const Sphere& sphere2) { return isCollision(sphere1, sphere2); }
+bool Overlaps(const Sphere& sphere, const AABB& aabb) { return IsCollision(sphere, aabb); }
+bool Overlaps(const Sphere& sphere, const OBB& obb) { return IsCollision(sphere, obb); }
+bool Overlaps(const Sphere& sphere, const Plane& plane) { return IsCollision(sphere, plane); }
+bool Overlaps(const AABB& aabb1, const AABB& aabb2) { return IsCollision(aabb1, aabb2); }
+bool Overlaps(const AABB& aabb, const OBB& obb) { return IsCollision(ToOBB(aabb), obb); }
+bool Overlaps(const AABB& aabb, const Plane& plane) { return IsCollision(ToOBB(aabb), plane); }
+bool Overlaps(const AABB& aabb, const Segment& segment) { return IsCollision(aabb, segment); }
+bool Overlaps(const OBB& obb1, const OBB& obb2) { return IsCollision(obb1, obb2); }
+bool Overlaps(const OBB& obb, const Plane& plane) { return IsCollision(obb, plane); }
+bool Overlaps(const OBB& obb, const Segment& segment) { return IsCollision(obb, segment); }
+bool Overlaps(const Plane& plane, const Segment& segment) { return IsCollision(segment, plane); }
+bool Overlaps(const Triangle& triangle, const Segment& segment) { return IsCollision(triangle, segment); }
+
+// 専用の判定がない凸形状同士は GJK で判定する
+bool Overlaps(const Sphere& sphere, const Triangle& triangle) { return GJKIntersect(sphere, triangle); }
+bool Overlaps(const Sphere& sphere, const Segment& segment) { return GJKIntersect(sphere, segment); }
+bool Overlaps(const AABB& aabb, const Triangle& triangle) { return GJKIntersect(aabb, triangle); }
+bool Overlaps(const OBB& obb, const Triangle& triangle) { return GJKIntersect(obb, triangle); }
+bool Overlaps(const Triangle& triangle1, const Triangle& triangle2) { return GJKIntersect(triangle1, triangle2); }
+
+// 1つのバケットを判定する(同じ判定関数を繰り返すだけのループ)
+template <class Shape1, class Shape2>
+void TestBucket(const ColliderRegistry& registry, std::span<const BucketEntry> entries, std::span<uint8_t> results)
+{
+    std::span<const Shape1> shapes1 = registry.GetShapes<Shape1>();
+    std::span<const Shape2> shapes2 = registry.GetShapes<Shape2>();
+    for (const BucketEntry& entry : entries) {
+        results[entry.pairIndex] = Overlaps(shapes1[entry.index1], shapes2[entry.index2]) ? 1 : 0;
+    }
+}
+
+// Overlaps がある組み合わせだけ判定関数を表に入れる
+template <size_t Index1, size_t Index2>
+constexpr BucketFunction SelectBucketFunction()
+{
+    using Shape1 = std::tuple_element_t<Index1, ColliderShapes>;
+    using Shape2 = std::tuple_element_t<Index2, ColliderShapes>;
+    if constexpr (requires(const Shape1& shape1, const Shape2& shape2) { Overlaps(shape1, shape2); }) {
+        return &TestBucket<Shape1, Shape2>;
+    } else {
+        return nullptr;
+    }
+}
+
+template <size_t Index1, size_t... Indices2>
+constexpr std::array<BucketFunction, kShapeTypeCount> MakeBucketFunctionRow(std::index_sequence<Indices2...>)
+{
+    return { SelectBucketFunction<Index1, Indices2>()... };
+}
+
+template <size_t... Indices>
+constexpr std::array<std::array<BucketFunction, kShapeTypeCount>, kShapeTypeCount> MakeBucketFunctionTable(std::index_sequence<Indices...> indices)
+{
+    return { MakeBucketFunctionRow<Indices>(indices)... };
+}
+
+// 種類の組み合わせごとの判定関数(判定できない組み合わせは nullptr)
+constexpr std::array<std::array<BucketFunction, kShapeTypeCount>, kShapeTypeCount> kBucketFunctions = MakeBucketFunctionTable(std::make_index_sequence<kShapeTypeCount>());
+
+BucketFunction GetBucketFunction(ShapeType type1, ShapeType type2)
+{
+    return kBucketFunctions[static_cast<size_t>(type1)][static_cast<size_t>(type2)];
+}
+
+} // namespace
+
+void ColliderRegistry::Clear()
+{
+    colliders_.clear();
+    std::apply([](auto&... shapes) { (shapes.clear(), ...); }, shapes_);
+}
+
+bool ColliderRegistry::IsSupported(ShapeType type1, ShapeType type2)
+{
+    if (type1 > type2) {
+        std::swap(type1, type2);
+    }
+    return GetBucketFunction(type1, type2) != nullptr;
+}
+
+bool ColliderRegistry::Test(uint32_t id1, uint32_t id2) const
+{
+    Collider collider1 = colliders_[id1];
+    Collider collider2 = colliders_[id2];
+    if (collider1.type > collider2.type) {
+        std::swap(collider1, collider2);
+    }
+
+    BucketFunction function = GetBucketFunction(collider1.type, collider2.type);
+    if (function == nullptr) {
+        return false;
+    }
+
+    BucketEntry entry = { collider1.index, collider2.index, 0 };
+    uint8_t result = 0;
+    function(*this, { &entry, 1 }, { &result, 1 });
+    return result != 0;
+}
+
+void ColliderRegistry::TestPairs(std::span<const CollisionPair> pairs, std::span<uint8_t> results)
+{
+    TestPairs(pairs, results, buckets_);
+}
+
+void ColliderRegistry::TestPairs(std::span<const CollisionPair> pairs, std::span<uint8_t> results, PairBuckets& buckets) const
+{
+    for (auto& row : buckets.entries) {
+        for (std::vector<BucketEntry>& bucket : row) {
+            bucket.clear();
+        }
+    }
+
+    // 種類の組み合わせごとに分ける
+    for (uint32_t i = 0; i < pairs.size(); ++i) {
+        Collider collider1 = colliders_[pairs[i].first];
+        Collider collider2 = colliders_[pairs[i].second];
+        if (collider1.type > collider2.type) {
+            std::swap(collider1, collider2);
+        }
+        buckets.entries[static_cast<size_t>(collider1.type)][static_cast<size_t>(collider2.type)].push_back({ collider1.index, collider2.index, i });
+    }
+
+    for (size_t type1 = 0; type1 < kShapeTypeCount; ++type1) {
+        for (size_t type2 = type1; type2 < kShapeTypeCount; ++type2) {
+            const std::vector<BucketEntry>& bucket = buckets.entries[type1][type2];
+            if (bucket.empty()) {
+                continue;
+            }
+
+            BucketFunction function = kBucketFunctions[type1][type2];
+            if (function == nullptr) {
+                for (const BucketEntry& entry : bucket) {
+                    results[entry.pairIndex] = 0;
+                }
+                continue;
+            }
+            function(*this, bucket, results);
+        }
+    }
+}
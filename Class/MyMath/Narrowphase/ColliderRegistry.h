@@ -0,0 +1,139 @@
+#pragma once
+
+#include "../Broadphase/CollisionPair.h"
+#include "../MyMath.h"
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// コライダーの形状の種類
+/// </summary>
+enum class ShapeType : uint8_t {
+    Sphere,
+    AABB,
+    OBB,
+    Plane,
+    Triangle,
+    Segment,
+};
+
+// 形状の種類の数
+constexpr size_t kShapeTypeCount = 6;
+
+// 登録できる形状(ShapeType の順)
+using ColliderShapes = std::tuple<Sphere, AABB, OBB, Plane, Triangle, Segment>;
+
+// 形状の型に対応する ShapeType
+template <class Shape, size_t Index = 0>
+constexpr ShapeType ShapeTypeOf()
+{
+    static_assert(Index < kShapeTypeCount, "ColliderShapes にない形状");
+    if constexpr (std::is_same_v<Shape, std::tuple_element_t<Index, ColliderShapes>>) {
+        return static_cast<ShapeType>(Index);
+    } else {
+        return ShapeTypeOf<Shape, Index + 1>();
+    }
+}
+
+/// <summary>
+/// 種類の異なる形状をまとめて登録し、種類の組み合わせで衝突判定を振り分ける
+/// 形状は種類ごとの配列に詰めて持ち、判定関数は種類の組み合わせの表(6x6)から引く
+/// TestPairs は候補の組を種類の組み合わせごとのバケットに分けてから、バケットごとに同じ判定を繰り返す
+/// (組ごとに分岐や間接呼び出しをせず、同じ種類の配列を続けて読む)
+/// 判定できるのは MyCollision の IsCollision がある組み合わせと、GJK で判定する凸形状同士の組み合わせ(IsSupported で調べられる)
+/// </summary>
+class ColliderRegistry {
+public:
+    // バケットに入れる組
+    struct BucketEntry {
+        uint32_t index1; //!< 種類の番号が小さい方の形状の、種類ごとの配列での添字
+        uint32_t index2; //!< 種類の番号が大きい方の形状の添字
+        uint32_t pairIndex; //!< TestPairs に渡した組の添字
+    };
+
+    // TestPairs の作業領域(種類の組み合わせごとの組。1つ目の種類 <= 2つ目の種類だけ使う)
+    // スレッドごとに別の作業領域を渡せば、TestPairs を複数のスレッドから同時に呼べる
+    struct PairBuckets {
+        std::vector<BucketEntry> entries[kShapeTypeCount][kShapeTypeCount];
+    };
+
+    // 形状を登録し、コライダーの番号(登録順)を返す
+    template <class Shape>
+    uint32_t Add(const Shape& shape);
+
+    // 登録した形状(種類が違う場合は assert)
+    template <class Shape>
+    Shape& Get(uint32_t id);
+
+    template <class Shape>
+    const Shape& Get(uint32_t id) const;
+
+    // 同じ種類の形状を登録順に詰めた配列
+    template <class Shape>
+    std::span<const Shape> GetShapes() const { return std::get<std::vector<Shape>>(shapes_); }
+
+    // すべてのコライダーを削除する
+    void Clear();
+
+    // コライダーの形状の種類
+    ShapeType GetType(uint32_t id) const { return colliders_[id].type; }
+
+    // コライダーの数
+    size_t GetColliderCount() const { return colliders_.size(); }
+
+    // 2つの種類の組み合わせを判定できるか
+    static bool IsSupported(ShapeType type1, ShapeType type2);
+
+    /// <summary>
+    /// 2つのコライダーの衝突判定(判定できない組み合わせは false)
+    /// </summary>
+    bool Test(uint32_t id1, uint32_t id2) const;
+
+    /// <summary>
+    /// 候補の組(ブロードフェーズの出力など)をまとめて判定する
+    /// 判定できない組み合わせの結果は0
+    /// </summary>
+    /// <param name="pairs">コライダーの番号の組</param>
+    /// <param name="results">各組の結果(衝突していれば1。要素数は pairs 以上)</param>
+    void TestPairs(std::span<const CollisionPair> pairs, std::span<uint8_t> results);
+
+    // 作業領域を指定して判定する(判定中は登録したコライダーを変更しないこと)
+    void TestPairs(std::span<const CollisionPair> pairs, std::span<uint8_t> results, PairBuckets& buckets) const;
+
+private:
+    struct Collider {
+        ShapeType type;
+        uint32_t index; //!< 種類ごとの配列での添字
+    };
+
+    std::vector<Collider> colliders_;
+    std::tuple<std::vector<Sphere>, std::vector<AABB>, std::vector<OBB>, std::vector<Plane>, std::vector<Triangle>, std::vector<Segment>> shapes_; //!< ShapeType の順
+    PairBuckets buckets_; //!< 作業領域を指定しない TestPairs で使う
+};
+
+template <class Shape>
+uint32_t ColliderRegistry::Add(const Shape& shape)
+{
+    std::vector<Shape>& shapes = std::get<std::vector<Shape>>(shapes_);
+    colliders_.push_back({ ShapeTypeOf<Shape>(), static_cast<uint32_t>(shapes.size()) });
+    shapes.push_back(shape);
+    return static_cast<uint32_t>(colliders_.size() - 1);
+}
+
+template <class Shape>
+Shape& ColliderRegistry::Get(uint32_t id)
+{
+    assert(colliders_[id].type == ShapeTypeOf<Shape>());
+    return std::get<std::vector<Shape>>(shapes_)[colliders_[id].index];
+}
+
+template <class Shape>
+const Shape& ColliderRegistry::Get(uint32_t id) const
+{
+    assert(colliders_[id].type == ShapeTypeOf<Shape>());
+    return std::get<std::vector<Shape>>(shapes_)[colliders_[id].index];
+}
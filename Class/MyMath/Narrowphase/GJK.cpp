@@ -0,0 +1,780 @@
+#include "GJK.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+ConvexShape::ConvexShape(const Sphere& sphere)
+    : kind_(Kind::Polytope)
+    , vertexCount_(1)
+    , radius_(sphere.radius)
+{
+    vertices_[0] = sphere.center;
+}
+
+ConvexShape::ConvexShape(const AABB& aabb)
+    : kind_(Kind::Box)
+{
+    Vector3 halfSize = (aabb.max - aabb.min) * 0.5f;
+    vertices_[0] = (aabb.min + aabb.max) * 0.5f;
+    vertices_[1] = { halfSize.x, 0.0f, 0.0f };
+    vertices_[2] = { 0.0f, halfSize.y, 0.0f };
+    vertices_[3] = { 0.0f, 0.0f, halfSize.z };
+}
+
+ConvexShape::ConvexShape(const OBB& obb)
+    : kind_(Kind::Box)
+{
+    vertices_[0] = obb.center;
+    vertices_[1] = obb.orientations[0] * obb.size.x;
+    vertices_[2] = obb.orientations[1] * obb.size.y;
+    vertices_[3] = obb.orientations[2] * obb.size.z;
+}
+
+ConvexShape::ConvexShape(const Triangle& triangle)
+    : kind_(Kind::Polytope)
+    , vertexCount_(3)
+{
+    vertices_[0] = triangle.vertices[0];
+    vertices_[1] = triangle.vertices[1];
+    vertices_[2] = triangle.vertices[2];
+}
+
+ConvexShape::ConvexShape(const Segment& segment)
+    : kind_(Kind::Polytope)
+    , vertexCount_(2)
+{
+    vertices_[0] = segment.origin;
+    vertices_[1] = segment.origin + segment.diff;
+}
+
+ConvexShape::ConvexShape(std::span<const Vector3> points)
+    : kind_(Kind::PointCloud)
+    , vertexCount_(static_cast<uint32_t>(points.size()))
+    , points_(points.data())
+{
+    assert(!points.empty());
+}
+
+namespace {
+
+// GJK の反復回数の上限
+const uint32_t kMaxGJKIterationCount = 32;
+// EPA で多面体に加える頂点の数の上限
+const uint32_t kMaxEPAIterationCount = 64;
+const uint32_t kMaxPolytopeVertexCount = kMaxEPAIterationCount + 4;
+// 凸多面体の面の数は 2 x 頂点数 - 4 以下
+const uint32_t kMaxPolytopeFaceCount = kMaxPolytopeVertexCount * 2;
+const uint32_t kMaxHorizonEdgeCount = kMaxPolytopeFaceCount * 3;
+
+// 最近点の距離の2乗が、単体の大きさの2乗のこの割合以下なら原点に接しているとみなす
+const float kTouchTolerance = 1e-10f;
+// 距離の上限と下限の差(2乗)がこの割合以下になったら収束とみなす
+const float kConvergenceTolerance = 1e-5f;
+// EPA の収束の判定(めり込みの深さに対する割合)
+const float kEPATolerance = 1e-4f;
+// 退化した(線分や三角形がつぶれた)とみなす大きさの割合
+const float kDegenerateTolerance = 1e-6f;
+
+// 単体の頂点(形状1の頂点 - 形状2の頂点)
+struct SimplexVertex {
+    Vector3 point1; //!< 形状1の頂点
+    Vector3 point2; //!< 形状2の頂点
+    Vector3 w; //!< point1 - point2(ミンコフスキー差の点)
+    uint32_t index1;
+    uint32_t index2;
+    float weight; //!< 原点に最も近い点の重心座標
+};
+
+struct Simplex {
+    SimplexVertex vertices[4];
+    uint32_t count;
+};
+
+enum class GJKStatus {
+    Separated, //!< コアが離れている(単体の最近点がコアの最近点)
+    Overlapping, //!< コアが重なっている(接している場合を含む)
+    WithinMargin, //!< コアの距離が overlapMargin 以下と分かった
+    BeyondMargin, //!< コアの距離が separationMargin より大きいと分かった
+};
+
+SimplexVertex MakeSimplexVertex(const ConvexShape& shape1, const ConvexShape& shape2, uint32_t index1, uint32_t index2)
+{
+    SimplexVertex vertex {};
+    vertex.point1 = shape1.GetVertex(index1);
+    vertex.point2 = shape2.GetVertex(index2);
+    vertex.w = vertex.point1 - vertex.point2;
+    vertex.index1 = index1;
+    vertex.index2 = index2;
+    vertex.weight = 1.0f;
+    return vertex;
+}
+
+// ミンコフスキー差の direction 方向のサポート点
+SimplexVertex FindSupport(const ConvexShape& shape1, const ConvexShape& shape2, const Vector3& direction)
+{
+    return MakeSimplexVertex(shape1, shape2, shape1.FindSupport(direction), shape2.FindSupport(direction * -1.0f));
+}
+
+// キャッシュの単体を今の形状で作り直す(番号が使えなければ適当な1点から始める)
+Simplex LoadSimplex(const ConvexShape& shape1, const ConvexShape& shape2, const GJKCache* cache)
+{
+    Simplex simplex {};
+    if (cache != nullptr && cache->count > 0 && cache->count <= 4) {
+        bool isValid = true;
+        for (uint32_t i = 0; i < cache->count; ++i) {
+            isValid = isValid && cache->indices1[i] < shape1.GetVertexCount() && cache->indices2[i] < shape2.GetVertexCount();
+        }
+        if (isValid) {
+            for (uint32_t i = 0; i < cache->count; ++i) {
+                simplex.vertices[i] = MakeSimplexVertex(shape1, shape2, cache->indices1[i], cache->indices2[i]);
+            }
+            simplex.count = cache->count;
+            return simplex;
+        }
+    }
+
+    simplex.vertices[0] = MakeSimplexVertex(shape1, shape2, 0, 0);
+    simplex.count = 1;
+    return simplex;
+}
+
+void StoreSimplex(const Simplex& simplex, GJKCache* cache)
+{
+    if (cache == nullptr) {
+        return;
+    }
+    cache->count = simplex.count;
+    for (uint32_t i = 0; i < simplex.count; ++i) {
+        cache->indices1[i] = simplex.vertices[i].index1;
+        cache->indices2[i] = simplex.vertices[i].index2;
+    }
+}
+
+Vector3 GetClosestPoint(const Simplex& simplex)
+{
+    Vector3 point = { 0.0f, 0.0f, 0.0f };
+    for (uint32_t i = 0; i < simplex.count; ++i) {
+        point += simplex.vertices[i].w * simplex.vertices[i].weight;
+    }
+    return point;
+}
+
+// 単体の頂点の、原点からの距離の2乗の最大値(許容誤差の基準)
+float GetMaxLengthSq(const Simplex& simplex)
+{
+    float maxLengthSq = 0.0f;
+    for (uint32_t i = 0; i < simplex.count; ++i) {
+        maxLengthSq = std::max(maxLengthSq, Dot(simplex.vertices[i].w, simplex.vertices[i].w));
+    }
+    return maxLengthSq;
+}
+
+//================================================
+// 　単体の最近点
+//
+// 原点に最も近い点を求め、その点を含む最小の部分単体に減らして重みを設定する
+//================================================
+
+Simplex MakeSimplex(const SimplexVertex& a)
+{
+    Simplex simplex {};
+    simplex.vertices[0] = a;
+    simplex.vertices[0].weight = 1.0f;
+    simplex.count = 1;
+    return simplex;
+}
+
+Simplex MakeSimplex(const SimplexVertex& a, const SimplexVertex& b, float t)
+{
+    Simplex simplex {};
+    simplex.vertices[0] = a;
+    simplex.vertices[1] = b;
+    simplex.vertices[0].weight = 1.0f - t;
+    simplex.vertices[1].weight = t;
+    simplex.count = 2;
+    return simplex;
+}
+
+Simplex SolveSegment(const SimplexVertex& a, const SimplexVertex& b)
+{
+    Vector3 ab = b.w - a.w;
+    float t = -Dot(a.w, ab);
+    float lengthSq = Dot(ab, ab);
+    if (t <= 0.0f || lengthSq <= 0.0f) {
+        return MakeSimplex(a);
+    }
+    if (t >= lengthSq) {
+        return MakeSimplex(b);
+    }
+    return MakeSimplex(a, b, t / lengthSq);
+}
+
+// 原点に最も近い点までの距離の2乗
+float GetClosestDistanceSq(const Simplex& simplex)
+{
+    Vector3 point = GetClosestPoint(simplex);
+    return Dot(point, point);
+}
+
+// 退化した三角形は3辺のうち最も近いものにする
+Simplex SolveDegenerateTriangle(const SimplexVertex& a, const SimplexVertex& b, const SimplexVertex& c)
+{
+    Simplex best = SolveSegment(a, b);
+    float bestDistanceSq = GetClosestDistanceSq(best);
+    for (const Simplex& candidate : { SolveSegment(b, c), SolveSegment(a, c) }) {
+        float distanceSq = GetClosestDistanceSq(candidate);
+        if (distanceSq < bestDistanceSq) {
+            bestDistanceSq = distanceSq;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// ClosestPointOnTriangle と同じ領域判定を、点を原点として行う
+Simplex SolveTriangle(const SimplexVertex& a, const SimplexVertex& b, const SimplexVertex& c)
+{
+    Vector3 ab = b.w - a.w;
+    Vector3 ac = c.w - a.w;
+
+    float d1 = -Dot(ab, a.w);
+    float d2 = -Dot(ac, a.w);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return MakeSimplex(a);
+    }
+
+    float d3 = -Dot(ab, b.w);
+    float d4 = -Dot(ac, b.w);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return MakeSimplex(b);
+    }
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return MakeSimplex(a, b, d1 / (d1 - d3));
+    }
+
+    float d5 = -Dot(ab, c.w);
+    float d6 = -Dot(ac, c.w);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return MakeSimplex(c);
+    }
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return MakeSimplex(a, c, d2 / (d2 - d6));
+    }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return MakeSimplex(b, c, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float sum = va + vb + vc;
+    Vector3 normal = Cross(ab, ac);
+    if (sum <= 0.0f || Dot(normal, normal) <= kDegenerateTolerance * Dot(ab, ab) * Dot(ac, ac)) {
+        return SolveDegenerateTriangle(a, b, c);
+    }
+
+    Simplex simplex {};
+    simplex.vertices[0] = a;
+    simplex.vertices[1] = b;
+    simplex.vertices[2] = c;
+    simplex.vertices[1].weight = vb / sum;
+    simplex.vertices[2].weight = vc / sum;
+    simplex.vertices[0].weight = 1.0f - simplex.vertices[1].weight - simplex.vertices[2].weight;
+    simplex.count = 3;
+    return simplex;
+}
+
+// 四面体の4つの面(最後の添字は面の反対側の頂点)
+const uint32_t kTetrahedronFaces[4][4] = {
+    { 0, 1, 2, 3 },
+    { 0, 3, 1, 2 },
+    { 0, 2, 3, 1 },
+    { 1, 3, 2, 0 },
+};
+
+// 原点が四面体の内側にあれば false(重みは原点の重心座標にする)
+bool SolveTetrahedron(Simplex& simplex)
+{
+    const SimplexVertex* v = simplex.vertices;
+    float volume = Dot(Cross(v[1].w - v[0].w, v[2].w - v[0].w), v[3].w - v[0].w);
+    float scale = GetMaxLengthSq(simplex);
+    bool isDegenerate = std::fabs(volume) <= kDegenerateTolerance * scale * std::sqrt(scale);
+
+    // 原点が外側にある面(退化していればすべての面)のうち最も近いもの
+    float weights[4];
+    Simplex best {};
+    float bestDistanceSq = std::numeric_limits<float>::infinity();
+    for (int face = 0; face < 4; ++face) {
+        const SimplexVertex& a = v[kTetrahedronFaces[face][0]];
+        const SimplexVertex& b = v[kTetrahedronFaces[face][1]];
+        const SimplexVertex& c = v[kTetrahedronFaces[face][2]];
+        const SimplexVertex& d = v[kTetrahedronFaces[face][3]];
+        Vector3 normal = Cross(b.w - a.w, c.w - a.w);
+        float originSide = -Dot(normal, a.w);
+        float oppositeSide = Dot(normal, d.w - a.w);
+        weights[kTetrahedronFaces[face][3]] = oppositeSide != 0.0f ? originSide / oppositeSide : 0.0f;
+        if (!isDegenerate && originSide * oppositeSide >= 0.0f) {
+            continue;
+        }
+        Simplex candidate = SolveTriangle(a, b, c);
+        float distanceSq = GetClosestDistanceSq(candidate);
+        if (distanceSq < bestDistanceSq) {
+            bestDistanceSq = distanceSq;
+            best = candidate;
+        }
+    }
+
+    if (bestDistanceSq == std::numeric_limits<float>::infinity()) {
+        // 内側。面と原点で作る四面体と、面と反対側の頂点で作る四面体の体積の比が、その頂点の重み
+        for (uint32_t i = 0; i < 4; ++i) {
+            simplex.vertices[i].weight = weights[i];
+        }
+        return false;
+    }
+    simplex = best;
+    return true;
+}
+
+// 原点が四面体の内側にあれば false
+bool SolveSimplex(Simplex& simplex)
+{
+    switch (simplex.count) {
+    case 1:
+        simplex.vertices[0].weight = 1.0f;
+        return true;
+    case 2:
+        simplex = SolveSegment(simplex.vertices[0], simplex.vertices[1]);
+        return true;
+    case 3:
+        simplex = SolveTriangle(simplex.vertices[0], simplex.vertices[1], simplex.vertices[2]);
+        return true;
+    default:
+        return SolveTetrahedron(simplex);
+    }
+}
+
+bool ContainsVertex(const Simplex& simplex, const SimplexVertex& vertex)
+{
+    for (uint32_t i = 0; i < simplex.count; ++i) {
+        if (simplex.vertices[i].index1 == vertex.index1 && simplex.vertices[i].index2 == vertex.index2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// <summary>
+/// コア同士の GJK
+/// </summary>
+/// <param name="simplex">始めの単体(終了時の単体を返す)</param>
+/// <param name="separationMargin">コアの距離がこれより大きいと分かった時点で打ち切る(負なら打ち切らない)</param>
+/// <param name="overlapMargin">コアの距離がこれ以下と分かった時点で打ち切る(負なら打ち切らない)</param>
+GJKStatus RunGJK(const ConvexShape& shape1, const ConvexShape& shape2, Simplex& simplex, float separationMargin, float overlapMargin, uint32_t& iterationCount)
+{
+    float separationMarginSq = separationMargin * separationMargin;
+    float overlapMarginSq = overlapMargin * overlapMargin;
+
+    iterationCount = 0;
+    while (iterationCount < kMaxGJKIterationCount) {
+        if (!SolveSimplex(simplex)) {
+            return GJKStatus::Overlapping;
+        }
+
+        // v は単体の中で原点に最も近い点(距離の上限)
+        Vector3 v = GetClosestPoint(simplex);
+        float vv = Dot(v, v);
+        if (vv <= kTouchTolerance * GetMaxLengthSq(simplex)) {
+            return GJKStatus::Overlapping;
+        }
+        if (overlapMargin >= 0.0f && vv <= overlapMarginSq) {
+            return GJKStatus::WithinMargin;
+        }
+
+        ++iterationCount;
+        SimplexVertex vertex = FindSupport(shape1, shape2, v * -1.0f);
+
+        // vw / |v| は距離の下限
+        float vw = Dot(v, vertex.w);
+        if (separationMargin >= 0.0f && vw > 0.0f && vw * vw > vv * separationMarginSq) {
+            return GJKStatus::BeyondMargin;
+        }
+        // 上限と下限が十分近いか、新しい点が見つからなければ収束
+        if (vv - vw <= kConvergenceTolerance * vv || ContainsVertex(simplex, vertex)) {
+            return GJKStatus::Separated;
+        }
+        simplex.vertices[simplex.count++] = vertex;
+    }
+
+    // 反復が上限に達したら、最後の単体の最近点を使う
+    return SolveSimplex(simplex) ? GJKStatus::Separated : GJKStatus::Overlapping;
+}
+
+// コアの最近点
+void GetClosestPoints(const Simplex& simplex, Vector3& point1, Vector3& point2)
+{
+    point1 = { 0.0f, 0.0f, 0.0f };
+    point2 = { 0.0f, 0.0f, 0.0f };
+    for (uint32_t i = 0; i < simplex.count; ++i) {
+        point1 += simplex.vertices[i].point1 * simplex.vertices[i].weight;
+        point2 += simplex.vertices[i].point2 * simplex.vertices[i].weight;
+    }
+}
+
+//================================================
+// 　EPA
+//
+// 原点を含む四面体から始め、原点に最も近い面の法線方向のサポート点を加えて多面体を広げていく
+// 広がらなくなったときの最も近い面が、コアのめり込みの向きと深さ
+//================================================
+
+struct PolytopeFace {
+    uint32_t indices[3]; //!< 外から見て反時計回り
+    Vector3 normal; //!< 外向きの単位法線
+    float distance; //!< 原点から面までの距離
+};
+
+struct Polytope {
+    SimplexVertex vertices[kMaxPolytopeVertexCount];
+    PolytopeFace faces[kMaxPolytopeFaceCount];
+    uint32_t vertexCount = 0;
+    uint32_t faceCount = 0;
+};
+
+// 面を加える(つぶれた面は選ばれないように距離を無限大にする)
+void AddFace(Polytope& polytope, uint32_t i0, uint32_t i1, uint32_t i2)
+{
+    PolytopeFace& face = polytope.faces[polytope.faceCount++];
+    face.indices[0] = i0;
+    face.indices[1] = i1;
+    face.indices[2] = i2;
+
+    const Vector3& a = polytope.vertices[i0].w;
+    Vector3 normal = Cross(polytope.vertices[i1].w - a, polytope.vertices[i2].w - a);
+    float length = Length(normal);
+    if (length <= 0.0f) {
+        face.normal = { 0.0f, 1.0f, 0.0f };
+        face.distance = std::numeric_limits<float>::infinity();
+        return;
+    }
+    face.normal = normal * (1.0f / length);
+    face.distance = Dot(face.normal, a);
+}
+
+// 単体を原点を含む四面体にふくらませる(ミンコフスキー差が平らで広げられなければ false)
+bool ExpandSimplex(const ConvexShape& shape1, const ConvexShape& shape2, Simplex& simplex)
+{
+    float scale = std::max(GetMaxLengthSq(simplex), 1e-12f);
+
+    // 退化した四面体は、最も大きい面の三角形から広げ直す
+    if (simplex.count == 4) {
+        const SimplexVertex* v = simplex.vertices;
+        float volume = Dot(Cross(v[1].w - v[0].w, v[2].w - v[0].w), v[3].w - v[0].w);
+        if (std::fabs(volume) > kDegenerateTolerance * scale * std::sqrt(scale)) {
+            return true;
+        }
+        int bestFace = 0;
+        float bestArea = -1.0f;
+        for (int face = 0; face < 4; ++face) {
+            Vector3 normal = Cross(v[kTetrahedronFaces[face][1]].w - v[kTetrahedronFaces[face][0]].w, v[kTetrahedronFaces[face][2]].w - v[kTetrahedronFaces[face][0]].w);
+            float area = Dot(normal, normal);
+            if (area > bestArea) {
+                bestArea = area;
+                bestFace = face;
+            }
+        }
+        Simplex triangle {};
+        for (int i = 0; i < 3; ++i) {
+            triangle.vertices[i] = v[kTetrahedronFaces[bestFace][i]];
+        }
+        triangle.count = 3;
+        simplex = triangle;
+    }
+
+    const Vector3 kAxes[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+    while (simplex.count < 4) {
+        const Vector3& a = simplex.vertices[0].w;
+        Vector3 directions[6];
+        uint32_t directionCount = 0;
+        if (simplex.count == 1) {
+            for (const Vector3& axis : kAxes) {
+                directions[directionCount++] = axis;
+                directions[directionCount++] = axis * -1.0f;
+            }
+        } else if (simplex.count == 2) {
+            // 線分に垂直な方向
+            Vector3 ab = simplex.vertices[1].w - a;
+            Vector3 axis = kAxes[0];
+            if (std::fabs(ab.y) < std::fabs(ab.x) && std::fabs(ab.y) <= std::fabs(ab.z)) {
+                axis = kAxes[1];
+            } else if (std::fabs(ab.z) < std::fabs(ab.x)) {
+                axis = kAxes[2];
+            }
+            Vector3 perpendicular1 = Cross(ab, axis);
+            Vector3 perpendicular2 = Cross(ab, perpendicular1);
+            directions[directionCount++] = perpendicular1;
+            directions[directionCount++] = perpendicular1 * -1.0f;
+            directions[directionCount++] = perpendicular2;
+            directions[directionCount++] = perpendicular2 * -1.0f;
+        } else {
+            Vector3 normal = Cross(simplex.vertices[1].w - a, simplex.vertices[2].w - a);
+            directions[directionCount++] = normal;
+            directions[directionCount++] = normal * -1.0f;
+        }
+
+        bool isExpanded = false;
+        for (uint32_t i = 0; i < directionCount && !isExpanded; ++i) {
+            SimplexVertex vertex = FindSupport(shape1, shape2, directions[i]);
+            Vector3 diff = vertex.w - a;
+            float offsetSq = 0.0f;
+            if (simplex.count == 1) {
+                offsetSq = Dot(diff, diff);
+            } else if (simplex.count == 2) {
+                Vector3 ab = simplex.vertices[1].w - a;
+                Vector3 cross = Cross(diff, ab);
+                offsetSq = Dot(cross, cross) / Dot(ab, ab);
+            } else {
+                Vector3 normal = directions[0];
+                float offset = Dot(diff, normal);
+                offsetSq = offset * offset / Dot(normal, normal);
+            }
+            if (offsetSq > kDegenerateTolerance * kDegenerateTolerance * scale) {
+                simplex.vertices[simplex.count++] = vertex;
+                isExpanded = true;
+            }
+        }
+        if (!isExpanded) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 辺を地平線に加える(逆向きの辺があれば、両側の面が消えるので取り除く)
+void AddHorizonEdge(uint32_t (*edges)[2], uint32_t& edgeCount, uint32_t i0, uint32_t i1)
+{
+    for (uint32_t i = 0; i < edgeCount; ++i) {
+        if (edges[i][0] == i1 && edges[i][1] == i0) {
+            edges[i][0] = edges[edgeCount - 1][0];
+            edges[i][1] = edges[edgeCount - 1][1];
+            --edgeCount;
+            return;
+        }
+    }
+    edges[edgeCount][0] = i0;
+    edges[edgeCount][1] = i1;
+    ++edgeCount;
+}
+
+/// <summary>
+/// EPA でコアのめり込みを求める
+/// </summary>
+/// <param name="simplex">GJK が終了したときの単体(原点を含む)</param>
+/// <param name="normal">ミンコフスキー差の外向きの法線(形状1をこの逆向きに動かすと離れる)</param>
+/// <param name="depth">めり込みの深さ</param>
+/// <param name="point1">形状1の最も深い点</param>
+/// <param name="point2">形状2の最も深い点</param>
+void RunEPA(const ConvexShape& shape1, const ConvexShape& shape2, const Simplex& simplex, Vector3& normal, float& depth, Vector3& point1, Vector3& point2)
+{
+    Simplex tetrahedron = simplex;
+    if (!ExpandSimplex(shape1, shape2, tetrahedron)) {
+        // ミンコフスキー差が平らなら、その面に垂直な向きに接しているだけとみなす
+        GetClosestPoints(simplex, point1, point2);
+        Vector3 a = tetrahedron.vertices[0].w;
+        Vector3 flatNormal = tetrahedron.count >= 3 ? Cross(tetrahedron.vertices[1].w - a, tetrahedron.vertices[2].w - a) : Vector3 { 0.0f, 0.0f, 0.0f };
+        normal = Dot(flatNormal, flatNormal) > 0.0f ? Normalize(flatNormal) : Vector3 { 0.0f, 1.0f, 0.0f };
+        depth = 0.0f;
+        return;
+    }
+
+    Polytope polytope;
+    for (uint32_t i = 0; i < 4; ++i) {
+        polytope.vertices[i] = tetrahedron.vertices[i];
+    }
+    polytope.vertexCount = 4;
+
+    // 法線が外を向くように、反対側の頂点と逆向きにそろえる
+    for (const uint32_t(&face)[4] : kTetrahedronFaces) {
+        const Vector3& a = polytope.vertices[face[0]].w;
+        Vector3 faceNormal = Cross(polytope.vertices[face[1]].w - a, polytope.vertices[face[2]].w - a);
+        if (Dot(faceNormal, polytope.vertices[face[3]].w - a) > 0.0f) {
+            AddFace(polytope, face[0], face[2], face[1]);
+        } else {
+            AddFace(polytope, face[0], face[1], face[2]);
+        }
+    }
+
+    uint32_t horizonEdges[kMaxHorizonEdgeCount][2];
+    uint32_t nearestFace = 0;
+    for (uint32_t iteration = 0; iteration < kMaxEPAIterationCount; ++iteration) {
+        nearestFace = 0;
+        for (uint32_t i = 1; i < polytope.faceCount; ++i) {
+            if (polytope.faces[i].distance < polytope.faces[nearestFace].distance) {
+                nearestFace = i;
+            }
+        }
+        const PolytopeFace& face = polytope.faces[nearestFace];
+
+        // 面の向きにこれ以上広がらなければ収束
+        SimplexVertex vertex = FindSupport(shape1, shape2, face.normal);
+        float supportDistance = Dot(face.normal, vertex.w);
+        if (supportDistance - face.distance <= kEPATolerance * std::max(face.distance, 1.0f)) {
+            break;
+        }
+        if (polytope.vertexCount == kMaxPolytopeVertexCount) {
+            break;
+        }
+
+        // 新しい点から見える面を取り除き、その地平線と新しい点で面を張る
+        uint32_t newIndex = polytope.vertexCount;
+        polytope.vertices[polytope.vertexCount++] = vertex;
+        uint32_t edgeCount = 0;
+        for (uint32_t i = 0; i < polytope.faceCount;) {
+            const PolytopeFace& visibleFace = polytope.faces[i];
+            if (Dot(visibleFace.normal, vertex.w - polytope.vertices[visibleFace.indices[0]].w) <= 0.0f) {
+                ++i;
+                continue;
+            }
+            AddHorizonEdge(horizonEdges, edgeCount, visibleFace.indices[0], visibleFace.indices[1]);
+            AddHorizonEdge(horizonEdges, edgeCount, visibleFace.indices[1], visibleFace.indices[2]);
+            AddHorizonEdge(horizonEdges, edgeCount, visibleFace.indices[2], visibleFace.indices[0]);
+            polytope.faces[i] = polytope.faces[--polytope.faceCount];
+        }
+        if (polytope.faceCount + edgeCount > kMaxPolytopeFaceCount) {
+            break;
+        }
+        for (uint32_t i = 0; i < edgeCount; ++i) {
+            AddFace(polytope, horizonEdges[i][0], horizonEdges[i][1], newIndex);
+        }
+        if (polytope.faceCount == 0) {
+            break;
+        }
+    }
+
+    nearestFace = 0;
+    for (uint32_t i = 1; i < polytope.faceCount; ++i) {
+        if (polytope.faces[i].distance < polytope.faces[nearestFace].distance) {
+            nearestFace = i;
+        }
+    }
+    const PolytopeFace& face = polytope.faces[nearestFace];
+    normal = face.normal;
+    depth = std::max(face.distance, 0.0f);
+
+    // 原点を面に投影した点の重心座標で、それぞれの形状の点を求める
+    const SimplexVertex& a = polytope.vertices[face.indices[0]];
+    const SimplexVertex& b = polytope.vertices[face.indices[1]];
+    const SimplexVertex& c = polytope.vertices[face.indices[2]];
+    Vector3 projected = face.normal * face.distance;
+    Vector3 ab = b.w - a.w;
+    Vector3 ac = c.w - a.w;
+    Vector3 ap = projected - a.w;
+    float d00 = Dot(ab, ab);
+    float d01 = Dot(ab, ac);
+    float d11 = Dot(ac, ac);
+    float d20 = Dot(ap, ab);
+    float d21 = Dot(ap, ac);
+    float denominator = d00 * d11 - d01 * d01;
+    float weightB = denominator > 0.0f ? (d11 * d20 - d01 * d21) / denominator : 0.0f;
+    float weightC = denominator > 0.0f ? (d00 * d21 - d01 * d20) / denominator : 0.0f;
+    float weightA = 1.0f - weightB - weightC;
+    point1 = a.point1 * weightA + b.point1 * weightB + c.point1 * weightC;
+    point2 = a.point2 * weightA + b.point2 * weightB + c.point2 * weightC;
+}
+
+} // namespace
+
+GJKResult GJKDistance(const ConvexShape& shape1, const ConvexShape& shape2, GJKCache* cache)
+{
+    Simplex simplex = LoadSimplex(shape1, shape2, cache);
+    GJKResult result {};
+    GJKStatus status = RunGJK(shape1, shape2, simplex, -1.0f, -1.0f, result.iterationCount);
+    StoreSimplex(simplex, cache);
+
+    GetClosestPoints(simplex, result.point1, result.point2);
+    if (status == GJKStatus::Overlapping) {
+        result.distance = 0.0f;
+        return result;
+    }
+
+    // コアの最近点を半径だけ相手に近づける
+    Vector3 diff = result.point2 - result.point1;
+    float coreDistance = Length(diff);
+    float radius = shape1.GetRadius() + shape2.GetRadius();
+    if (coreDistance <= radius) {
+        result.distance = 0.0f;
+        return result;
+    }
+    Vector3 direction = diff * (1.0f / coreDistance);
+    result.point1 += direction * shape1.GetRadius();
+    result.point2 -= direction * shape2.GetRadius();
+    result.distance = coreDistance - radius;
+    return result;
+}
+
+bool GJKIntersect(const ConvexShape& shape1, const ConvexShape& shape2, GJKCache* cache)
+{
+    Simplex simplex = LoadSimplex(shape1, shape2, cache);
+    float radius = shape1.GetRadius() + shape2.GetRadius();
+    uint32_t iterationCount = 0;
+    GJKStatus status = RunGJK(shape1, shape2, simplex, radius, radius, iterationCount);
+    StoreSimplex(simplex, cache);
+
+    switch (status) {
+    case GJKStatus::Overlapping:
+    case GJKStatus::WithinMargin:
+        return true;
+    case GJKStatus::BeyondMargin:
+        return false;
+    default: {
+        Vector3 closestPoint = GetClosestPoint(simplex);
+        return Dot(closestPoint, closestPoint) <= radius * radius;
+    }
+    }
+}
+
+bool GJKCollide(const ConvexShape& shape1, const ConvexShape& shape2, Contact& contact, GJKCache* cache)
+{
+    Simplex simplex = LoadSimplex(shape1, shape2, cache);
+    float radius1 = shape1.GetRadius();
+    float radius2 = shape2.GetRadius();
+    float radius = radius1 + radius2;
+    uint32_t iterationCount = 0;
+    GJKStatus status = RunGJK(shape1, shape2, simplex, radius, -1.0f, iterationCount);
+    StoreSimplex(simplex, cache);
+
+    if (status == GJKStatus::BeyondMargin) {
+        return false;
+    }
+
+    Vector3 point1 = {};
+    Vector3 point2 = {};
+    if (status == GJKStatus::Separated) {
+        // コアは離れていて、半径の分だけ重なっている
+        GetClosestPoints(simplex, point1, point2);
+        Vector3 diff = point1 - point2;
+        float distanceSq = Dot(diff, diff);
+        if (distanceSq > radius * radius) {
+            return false;
+        }
+        float distance = sqrtf(distanceSq);
+        contact.normal = distance > 0.0f ? diff * (1.0f / distance) : Vector3 { 0.0f, 1.0f, 0.0f };
+        contact.penetration = radius - distance;
+    } else {
+        Vector3 normal = {};
+        float depth = 0.0f;
+        RunEPA(shape1, shape2, simplex, normal, depth, point1, point2);
+        contact.normal = normal * -1.0f;
+        contact.penetration = depth + radius;
+    }
+
+    // 両方の表面の点の中央
+    Vector3 surface1 = point1 - contact.normal * radius1;
+    Vector3 surface2 = point2 + contact.normal * radius2;
+    contact.point = (surface1 + surface2) * 0.5f;
+    contact.t = 0.0f;
+    return true;
+}
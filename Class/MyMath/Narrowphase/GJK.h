@@ -0,0 +1,157 @@
+#pragma once
+
+#include "../MyCollision.h"
+#include "../MyMath.h"
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// GJK / EPA で判定する凸形状
+/// 形状は「頂点を持つ凸多面体(コア)」と「それを膨らませる半径」で表す
+/// (球は中心の1点を半径で膨らませたもの。それ以外は半径0)
+/// サポート関数は頂点の番号を返すので、前フレームの単体を番号で覚えておける
+/// 点群は配列を参照するだけなので、使い終わるまで元の配列を変更しないこと
+/// </summary>
+class ConvexShape {
+public:
+    // 暗黙に変換して GJK の関数にそのまま渡せるようにする
+    ConvexShape(const Sphere& sphere);
+    ConvexShape(const AABB& aabb);
+    ConvexShape(const OBB& obb);
+    ConvexShape(const Triangle& triangle);
+    ConvexShape(const Segment& segment);
+
+    // 点群(凸包として扱う。1点以上)
+    ConvexShape(std::span<const Vector3> points);
+
+    /// <summary>
+    /// 方向に最も遠いコアの頂点の番号(サポート写像)
+    /// </summary>
+    uint32_t FindSupport(const Vector3& direction) const;
+
+    // コアの頂点
+    Vector3 GetVertex(uint32_t index) const;
+
+    // コアの頂点の数
+    uint32_t GetVertexCount() const;
+
+    // コアを膨らませる半径
+    float GetRadius() const { return radius_; }
+
+private:
+    enum class Kind : uint8_t {
+        Polytope, //!< 1 ~ 3 個の頂点(球のコア・線分・三角形)
+        Box, //!< 中心と3つの軸(半分の長さを掛けたもの)
+        PointCloud,
+    };
+
+    Kind kind_;
+    uint32_t vertexCount_ = 0; //!< Polytope と PointCloud の頂点の数
+    float radius_ = 0.0f;
+    Vector3 vertices_[4] = {}; //!< Polytope は頂点、Box は中心と3つの軸
+    const Vector3* points_ = nullptr; //!< PointCloud の点
+};
+
+/// <summary>
+/// GJK の単体のキャッシュ(組ごとにフレームをまたいで持っておく)
+/// 終了時の単体の頂点の番号を覚えておき、次の判定はそこから始める
+/// 形状の動きが小さければ、1 ~ 2 回の反復で収束する
+/// </summary>
+struct GJKCache {
+    uint32_t count = 0; //!< 単体の頂点の数(0なら空)
+    uint32_t indices1[4] = {}; //!< 形状1の頂点の番号
+    uint32_t indices2[4] = {}; //!< 形状2の頂点の番号
+};
+
+/// <summary>
+/// GJK の距離の結果
+/// </summary>
+struct GJKResult {
+    Vector3 point1; //!< 形状1の最近点(半径込み)
+    Vector3 point2; //!< 形状2の最近点(半径込み)
+    float distance; //!< 形状の間の距離(重なっていれば0)
+    uint32_t iterationCount; //!< 反復回数
+};
+
+/// <summary>
+/// 2つの凸形状の距離と最近点を求める
+/// </summary>
+/// <param name="shape1">形状1</param>
+/// <param name="shape2">形状2</param>
+/// <param name="cache">前回の単体(nullptr なら使わない。終了時の単体を書き込む)</param>
+/// <returns>距離と最近点(コアが重なっていれば、最近点は両方のコアに含まれる1点)</returns>
+GJKResult GJKDistance(const ConvexShape& shape1, const ConvexShape& shape2, GJKCache* cache = nullptr);
+
+/// <summary>
+/// 2つの凸形状の衝突判定
+/// 距離を求めずに、分離軸が見つかった時点で打ち切る
+/// </summary>
+/// <param name="cache">前回の単体(nullptr なら使わない。終了時の単体を書き込む)</param>
+/// <returns>重なっていれば true(接しているだけの場合も含む)</returns>
+bool GJKIntersect(const ConvexShape& shape1, const ConvexShape& shape2, GJKCache* cache = nullptr);
+
+/// <summary>
+/// 2つの凸形状の接触
+/// コアが離れていれば GJK の最近点から、コアが重なっていれば EPA でめり込みを求める
+/// </summary>
+/// <param name="shape1">形状1</param>
+/// <param name="shape2">形状2</param>
+/// <param name="contact">接触情報(法線は形状2から形状1へ向く。接触点は重なりの中央)</param>
+/// <param name="cache">前回の単体(nullptr なら使わない。終了時の単体を書き込む)</param>
+/// <returns>衝突していれば true</returns>
+bool GJKCollide(const ConvexShape& shape1, const ConvexShape& shape2, Contact& contact, GJKCache* cache = nullptr);
+
+inline uint32_t ConvexShape::FindSupport(const Vector3& direction) const
+{
+    switch (kind_) {
+    case Kind::Box:
+        // 軸の向きの符号をビットにした番号
+        return (Dot(direction, vertices_[1]) > 0.0f ? 1u : 0u)
+            | (Dot(direction, vertices_[2]) > 0.0f ? 2u : 0u)
+            | (Dot(direction, vertices_[3]) > 0.0f ? 4u : 0u);
+    case Kind::PointCloud: {
+        uint32_t best = 0;
+        float bestDot = Dot(points_[0], direction);
+        for (uint32_t i = 1; i < vertexCount_; ++i) {
+            float dot = Dot(points_[i], direction);
+            if (dot > bestDot) {
+                bestDot = dot;
+                best = i;
+            }
+        }
+        return best;
+    }
+    default: {
+        uint32_t best = 0;
+        float bestDot = Dot(vertices_[0], direction);
+        for (uint32_t i = 1; i < vertexCount_; ++i) {
+            float dot = Dot(vertices_[i], direction);
+            if (dot > bestDot) {
+                bestDot = dot;
+                best = i;
+            }
+        }
+        return best;
+    }
+    }
+}
+
+inline Vector3 ConvexShape::GetVertex(uint32_t index) const
+{
+    switch (kind_) {
+    case Kind::Box:
+        return vertices_[0]
+            + vertices_[1] * ((index & 1u) ? 1.0f : -1.0f)
+            + vertices_[2] * ((index & 2u) ? 1.0f : -1.0f)
+            + vertices_[3] * ((index & 4u) ? 1.0f : -1.0f);
+    case Kind::PointCloud:
+        return points_[index];
+    default:
+        return vertices_[index];
+    }
+}
+
+inline uint32_t ConvexShape::GetVertexCount() const
+{
+    return kind_ == Kind::Box ? 8u : vertexCount_;
+}
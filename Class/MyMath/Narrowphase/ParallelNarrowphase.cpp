@@ -0,0 +1,47 @@
+#include "ParallelNarrowphase.h"
+
+ParallelNarrowphase::ParallelNarrowphase(ThreadPool& threadPool)
+    : threadPool_(threadPool)
+    , workerBuffers_(threadPool.GetWorkerCount())
+{
+}
+
+void ParallelNarrowphase::FindCollidingPairs(const ColliderRegistry& registry, std::span<const CollisionPair> candidates, std::vector<CollisionPair>& collidingPairs)
+{
+    // チャンクごとに種類の組み合わせのバケットに分けて判定する(作業領域はワーカーごと)
+    FindCollidingPairsByChunk(
+        candidates,
+        [&](std::span<const CollisionPair> chunk, WorkerBuffer& buffer) {
+            buffer.results.resize(chunk.size());
+            registry.TestPairs(chunk, buffer.results, buffer.buckets);
+            for (size_t i = 0; i < chunk.size(); ++i) {
+                if (buffer.results[i] != 0) {
+                    buffer.pairs.push_back(chunk[i]);
+                }
+            }
+        },
+        collidingPairs);
+}
+
+void ParallelNarrowphase::BeginFrame(size_t candidateCount)
+{
+    for (WorkerBuffer& buffer : workerBuffers_) {
+        buffer.pairs.clear();
+    }
+    chunkOutputs_.resize(ThreadPool::GetChunkCount(candidateCount, kChunkSize));
+}
+
+void ParallelNarrowphase::Merge(std::vector<CollisionPair>& collidingPairs) const
+{
+    size_t totalCount = 0;
+    for (const WorkerBuffer& buffer : workerBuffers_) {
+        totalCount += buffer.pairs.size();
+    }
+
+    collidingPairs.clear();
+    collidingPairs.reserve(totalCount);
+    for (const ChunkOutput& output : chunkOutputs_) {
+        const std::vector<CollisionPair>& pairs = workerBuffers_[output.workerIndex].pairs;
+        collidingPairs.insert(collidingPairs.end(), pairs.begin() + output.begin, pairs.begin() + output.begin + output.count);
+    }
+}
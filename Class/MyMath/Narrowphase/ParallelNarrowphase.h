@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../Broadphase/CollisionPair.h"
+#include "../ThreadPool.h"
+#include "ColliderRegistry.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 衝突候補の組を複数のスレッドで判定するナローフェーズ
+/// 候補の配列をチャンクに分けてスレッドプールで処理し、衝突した組はワーカーごとのバッファに書き込む
+/// 最後にチャンクの順に連結するので、結果はスレッド数や処理の順序によらず、1スレッドで判定した場合と同じ並びになる
+/// バッファはフレームをまたいで使い回す
+/// </summary>
+class ParallelNarrowphase {
+public:
+    // 1チャンクの組の数(ワーカー間の受け渡しの単位)
+    static constexpr size_t kChunkSize = 4096;
+
+    explicit ParallelNarrowphase(ThreadPool& threadPool);
+
+    /// <summary>
+    /// 衝突している組を求める
+    /// </summary>
+    /// <param name="candidates">衝突候補の組</param>
+    /// <param name="test">組を判定する関数 bool(const CollisionPair&)(複数のスレッドから同時に呼ばれる)</param>
+    /// <param name="collidingPairs">衝突している組(クリアしてから candidates の順に追加する)</param>
+    template <class PairTest>
+    void FindCollidingPairs(std::span<const CollisionPair> candidates, const PairTest& test, std::vector<CollisionPair>& collidingPairs);
+
+    /// <summary>
+    /// 登録したコライダー同士の衝突している組を求める(判定できない種類の組み合わせは衝突しないものとする)
+    /// チャンクごとに ColliderRegistry::TestPairs で種類の組み合わせのバケットに分けて判定する
+    /// </summary>
+    /// <param name="registry">コライダー(判定中は変更しないこと)</param>
+    /// <param name="candidates">コライダーの番号の組</param>
+    /// <param name="collidingPairs">衝突している組(クリアしてから candidates の順に追加する)</param>
+    void FindCollidingPairs(const ColliderRegistry& registry, std::span<const CollisionPair> candidates, std::vector<CollisionPair>& collidingPairs);
+
+private:
+    // チャンクの結果が、どのワーカーのバッファのどこにあるか
+    struct ChunkOutput {
+        uint32_t workerIndex;
+        uint32_t begin;
+        uint32_t count;
+    };
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4324) // alignas で詰め物が入ったことの警告
+#endif
+    // ワーカーごとの出力先(別のワーカーと同じキャッシュラインに載らないようにする)
+    struct alignas(64) WorkerBuffer {
+        std::vector<CollisionPair> pairs;
+        ColliderRegistry::PairBuckets buckets; //!< ColliderRegistry::TestPairs の作業領域
+        std::vector<uint8_t> results; //!< チャンクの各組の判定結果
+    };
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+    // candidates をチャンクに分けて処理し、チャンクの順に連結する
+    // chunkTest は void(std::span<const CollisionPair> chunk, WorkerBuffer& buffer) で、衝突した組を buffer.pairs に追加する
+    template <class ChunkTest>
+    void FindCollidingPairsByChunk(std::span<const CollisionPair> candidates, const ChunkTest& chunkTest, std::vector<CollisionPair>& collidingPairs);
+
+    void BeginFrame(size_t candidateCount);
+    // チャンクの順に連結する
+    void Merge(std::vector<CollisionPair>& collidingPairs) const;
+
+    ThreadPool& threadPool_;
+    std::vector<WorkerBuffer> workerBuffers_;
+    std::vector<ChunkOutput> chunkOutputs_;
+};
+
+template <class PairTest>
+void ParallelNarrowphase::FindCollidingPairs(std::span<const CollisionPair> candidates, const PairTest& test, std::vector<CollisionPair>& collidingPairs)
+{
+    FindCollidingPairsByChunk(
+        candidates,
+        [&](std::span<const CollisionPair> chunk, WorkerBuffer& buffer) {
+            for (const CollisionPair& pair : chunk) {
+                if (test(pair)) {
+                    buffer.pairs.push_back(pair);
+                }
+            }
+        },
+        collidingPairs);
+}
+
+template <class ChunkTest>
+void ParallelNarrowphase::FindCollidingPairsByChunk(std::span<const CollisionPair> candidates, const ChunkTest& chunkTest, std::vector<CollisionPair>& collidingPairs)
+{
+    BeginFrame(candidates.size());
+
+    threadPool_.ParallelFor(candidates.size(), kChunkSize, [&](size_t chunkIndex, size_t begin, size_t end, uint32_t workerIndex) {
+        WorkerBuffer& buffer = workerBuffers_[workerIndex];
+        size_t outputBegin = buffer.pairs.size();
+        chunkTest(candidates.subspan(begin, end - begin), buffer);
+        chunkOutputs_[chunkIndex] = { workerIndex, static_cast<uint32_t>(outputBegin), static_cast<uint32_t>(buffer.pairs.size() - outputBegin) };
+    });
+
+    Merge(collidingPairs);
+}
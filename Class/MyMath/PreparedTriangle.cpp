@@ -0,0 +1,49 @@
+#include "PreparedTriangle.h"
+#include <assert.h>
+
+void MakePreparedTriangles(std::span<const Triangle> triangles, std::span<PreparedTriangle> preparedTriangles)
+{
+    assert(preparedTriangles.size() >= triangles.size());
+
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        preparedTriangles[i] = MakePreparedTriangle(triangles[i]);
+    }
+}
+
+size_t IntersectSegment(std::span<const PreparedTriangle> triangles, const Segment& segment, std::span<uint8_t> hitMask)
+{
+    assert(hitMask.size() >= triangles.size());
+
+    // 当たるかどうかが予測しにくいので、途中で打ち切らずに全条件をまとめて判定する
+    size_t hitCount = 0;
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const PreparedTriangle& triangle = triangles[i];
+
+        float det = -Dot(segment.diff, triangle.normal);
+        float invDet = 1.0f / det;
+        Vector3 s = segment.origin - triangle.vertex0;
+        Vector3 q = Cross(s, segment.diff);
+        float t = Dot(s, triangle.normal) * invDet;
+        float u = Dot(triangle.edge2, q) * invDet;
+        float v = -Dot(triangle.edge1, q) * invDet;
+
+        bool hit = (det != 0.0f) & (t >= 0.0f) & (t <= 1.0f) & (u >= 0.0f) & (u <= 1.0f) & (v >= 0.0f) & (u + v <= 1.0f);
+        hitMask[i] = hit ? 1 : 0;
+        hitCount += hit ? 1 : 0;
+    }
+    return hitCount;
+}
+
+bool FindFirstIntersection(std::span<const PreparedTriangle> triangles, const Segment& segment, uint32_t& triangleIndex, TriangleIntersection& intersection, float maxT)
+{
+    bool found = false;
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        // 見つかるたびに t の上限を縮めて、それより遠い三角形は早めに打ち切る
+        if (IntersectSegment(triangles[i], segment, intersection, maxT)) {
+            triangleIndex = static_cast<uint32_t>(i);
+            maxT = intersection.t;
+            found = true;
+        }
+    }
+    return found;
+}
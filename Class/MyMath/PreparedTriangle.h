@@ -0,0 +1,99 @@
+#pragma once
+
+#include "MyMath.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// 線分との判定用に前計算した三角形
+/// 辺と法線(正規化しない)を持っておき、判定のたびに外積や平方根を計算しない
+/// </summary>
+struct PreparedTriangle {
+    Vector3 vertex0; //!< 頂点0
+    Vector3 edge1; //!< 頂点1 - 頂点0
+    Vector3 edge2; //!< 頂点2 - 頂点0
+    Vector3 normal; //!< Cross(edge1, edge2)(正規化しない)
+};
+
+/// <summary>
+/// 線分と三角形の交点
+/// </summary>
+struct TriangleIntersection {
+    float t; //!< 線分上の位置(origin + diff * t)
+    float u; //!< 頂点1の重み(重心座標)
+    float v; //!< 頂点2の重み(重心座標。頂点0の重みは 1 - u - v)
+};
+
+// 三角形を前計算する
+inline PreparedTriangle MakePreparedTriangle(const Triangle& triangle)
+{
+    Vector3 edge1 = triangle.vertices[1] - triangle.vertices[0];
+    Vector3 edge2 = triangle.vertices[2] - triangle.vertices[0];
+    return { triangle.vertices[0], edge1, edge2, Cross(edge1, edge2) };
+}
+
+/// <summary>
+/// 線分と三角形の交差判定(Möller–Trumbore 法。両面)
+/// IsCollision(Triangle, Segment) と同じ判定を、正規化せずに外積1回で行う
+/// </summary>
+/// <param name="triangle">前計算した三角形</param>
+/// <param name="segment">線分</param>
+/// <param name="intersection">交点(交わる場合のみ書き込む)</param>
+/// <param name="maxT">t の上限(これより遠い交点は無視する)</param>
+/// <returns>交わるなら true</returns>
+inline bool IntersectSegment(const PreparedTriangle& triangle, const Segment& segment, TriangleIntersection& intersection, float maxT = 1.0f)
+{
+    // origin + diff * t = vertex0 + edge1 * u + edge2 * v をクラメルの公式で解く
+    float det = -Dot(segment.diff, triangle.normal);
+    if (det == 0.0f) {
+        return false; // 平行
+    }
+    float invDet = 1.0f / det;
+
+    Vector3 s = segment.origin - triangle.vertex0;
+    float t = Dot(s, triangle.normal) * invDet;
+    if (t < 0.0f || t > maxT) {
+        return false; // 線分上にない
+    }
+
+    Vector3 q = Cross(s, segment.diff);
+    float u = Dot(triangle.edge2, q) * invDet;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+    float v = -Dot(triangle.edge1, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+
+    intersection = { t, u, v };
+    return true;
+}
+
+/// <summary>
+/// 三角形をまとめて前計算する
+/// </summary>
+/// <param name="triangles">三角形の配列</param>
+/// <param name="preparedTriangles">出力先(要素数は triangles 以上)</param>
+void MakePreparedTriangles(std::span<const Triangle> triangles, std::span<PreparedTriangle> preparedTriangles);
+
+/// <summary>
+/// 線分と三角形の交差判定(一括)
+/// </summary>
+/// <param name="triangles">前計算した三角形の配列</param>
+/// <param name="segment">線分</param>
+/// <param name="hitMask">出力先(交わるなら1、交わらないなら0。要素数は triangles 以上)</param>
+/// <returns>交わる三角形の数</returns>
+size_t IntersectSegment(std::span<const PreparedTriangle> triangles, const Segment& segment, std::span<uint8_t> hitMask);
+
+/// <summary>
+/// 線分と最初に交わる(t が最小の)三角形を探す
+/// </summary>
+/// <param name="triangles">前計算した三角形の配列</param>
+/// <param name="segment">線分</param>
+/// <param name="triangleIndex">交わった三角形の添字</param>
+/// <param name="intersection">交点</param>
+/// <param name="maxT">t の上限</param>
+/// <returns>交わる三角形があれば true</returns>
+bool FindFirstIntersection(std::span<const PreparedTriangle> triangles, const Segment& segment, uint32_t& triangleIndex, TriangleIntersection& intersection, float maxT = 1.0f);
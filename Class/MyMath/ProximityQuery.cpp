@@ -0,0 +1,284 @@
+#include "ProximityQuery.h"
+#include "LaneVector.h"
+#include <assert.h>
+
+namespace {
+
+inline FloatLane LaneDistanceSq(const LaneVector& v1, const LaneVector& v2)
+{
+    LaneVector diff = LaneSubtract(v1, v2);
+    return LaneDot(diff, diff);
+}
+
+inline FloatLane LaneClamp01(FloatLane t)
+{
+    return LaneMin(LaneMax(t, LaneSet(0.0f)), LaneSet(1.0f));
+}
+
+// 長さの2乗の逆数(0なら0)
+float InverseLengthSq(const Vector3& v)
+{
+    float lengthSq = Dot(v, v);
+    return lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+}
+
+//================================================
+// 　レーンごとの最近点(戻り値は距離の2乗)
+//================================================
+
+inline FloatLane ClosestPointLane(const ProximitySegment& segment, const LaneVector& point, LaneVector& closestPoint)
+{
+    LaneVector origin = LaneBroadcast(segment.origin);
+    LaneVector diff = LaneBroadcast(segment.diff);
+    FloatLane t = LaneClamp01(LaneMul(LaneDot(LaneSubtract(point, origin), diff), LaneSet(segment.invLengthSq)));
+    closestPoint = LaneMultiplyAdd(origin, diff, t);
+    return LaneDistanceSq(point, closestPoint);
+}
+
+inline FloatLane ClosestPointLane(const ProximityTriangle& triangle, const LaneVector& point, LaneVector& closestPoint)
+{
+    LaneVector vertex0 = LaneBroadcast(triangle.vertex0);
+    LaneVector vertex1 = LaneBroadcast(triangle.vertex1);
+    LaneVector edge0 = LaneBroadcast(triangle.edges[0]);
+    LaneVector edge1 = LaneBroadcast(triangle.edges[1]);
+    LaneVector edge2 = LaneBroadcast(triangle.edges[2]);
+    LaneVector normal = LaneBroadcast(triangle.normal);
+
+    LaneVector ap = LaneSubtract(point, vertex0);
+    FloatLane d0 = LaneDot(ap, edge0);
+    FloatLane d1 = LaneDot(ap, edge1);
+
+    // 3辺のうち最も近い点
+    LaneVector edgePoint0 = LaneMultiplyAdd(vertex0, edge0, LaneClamp01(LaneMul(d0, LaneSet(triangle.invEdgeLengthSq[0]))));
+    LaneVector edgePoint1 = LaneMultiplyAdd(vertex0, edge1, LaneClamp01(LaneMul(d1, LaneSet(triangle.invEdgeLengthSq[1]))));
+    FloatLane t2 = LaneClamp01(LaneMul(LaneDot(LaneSubtract(point, vertex1), edge2), LaneSet(triangle.invEdgeLengthSq[2])));
+    LaneVector edgePoint2 = LaneMultiplyAdd(vertex1, edge2, t2);
+
+    FloatLane distanceSq0 = LaneDistanceSq(point, edgePoint0);
+    FloatLane distanceSq1 = LaneDistanceSq(point, edgePoint1);
+    FloatLane distanceSq2 = LaneDistanceSq(point, edgePoint2);
+    LaneMask isEdge1Nearer = LaneLess(distanceSq1, distanceSq0);
+    LaneVector edgePoint = LaneSelectVector(isEdge1Nearer, edgePoint1, edgePoint0);
+    FloatLane edgeDistanceSq = LaneMin(distanceSq1, distanceSq0);
+    LaneMask isEdge2Nearer = LaneLess(distanceSq2, edgeDistanceSq);
+    edgePoint = LaneSelectVector(isEdge2Nearer, edgePoint2, edgePoint);
+    edgeDistanceSq = LaneMin(distanceSq2, edgeDistanceSq);
+
+    // 面に下ろした点の重心座標(分母を掛けたまま比べる)
+    FloatLane v = LaneSub(LaneMul(LaneSet(triangle.edgeDot11), d0), LaneMul(LaneSet(triangle.edgeDot01), d1));
+    FloatLane w = LaneSub(LaneMul(LaneSet(triangle.edgeDot00), d1), LaneMul(LaneSet(triangle.edgeDot01), d0));
+    FloatLane zero = LaneSet(0.0f);
+    LaneMask isInside = LaneAnd(LaneAnd(LaneLessEqual(zero, v), LaneLessEqual(zero, w)), LaneLessEqual(LaneAdd(v, w), LaneSet(triangle.denominator)));
+
+    FloatLane planeDistance = LaneDot(ap, normal);
+    FloatLane planeScale = LaneMul(planeDistance, LaneSet(triangle.invNormalLengthSq));
+    LaneVector facePoint = LaneMultiplyAdd(point, normal, LaneSub(zero, planeScale));
+    FloatLane faceDistanceSq = LaneMul(planeDistance, planeScale);
+
+    closestPoint = LaneSelectVector(isInside, facePoint, edgePoint);
+    return LaneSelect(isInside, faceDistanceSq, edgeDistanceSq);
+}
+
+inline FloatLane ClosestPointLane(const AABB& aabb, const LaneVector& point, LaneVector& closestPoint)
+{
+    closestPoint = {
+        LaneMin(LaneMax(point.x, LaneSet(aabb.min.x)), LaneSet(aabb.max.x)),
+        LaneMin(LaneMax(point.y, LaneSet(aabb.min.y)), LaneSet(aabb.max.y)),
+        LaneMin(LaneMax(point.z, LaneSet(aabb.min.z)), LaneSet(aabb.max.z)),
+    };
+    return LaneDistanceSq(point, closestPoint);
+}
+
+inline FloatLane ClosestPointLane(const ProximityPlane& plane, const LaneVector& point, LaneVector& closestPoint)
+{
+    LaneVector normal = LaneBroadcast(plane.normal);
+    FloatLane signedDistance = LaneSub(LaneDot(point, normal), LaneSet(plane.distance));
+    FloatLane scale = LaneMul(signedDistance, LaneSet(plane.invNormalLengthSq));
+    closestPoint = LaneMultiplyAdd(point, normal, LaneSub(LaneSet(0.0f), scale));
+    return LaneMul(signedDistance, scale);
+}
+
+//================================================
+// 　配列全体の処理
+//
+// 端数はレーン幅の一時配列に詰めて(残りのレーンは端数の最初の点で埋める)同じレーンの計算をする
+// 三角形などのカーネルをスカラーでもう1つ書くと長くなるので、端数もレーンで処理する
+//================================================
+
+// 端数の点をレーン幅に詰める
+LaneVector LoadRemainder(const Vector3SoA& points, size_t first)
+{
+    float x[kFloatLaneWidth];
+    float y[kFloatLaneWidth];
+    float z[kFloatLaneWidth];
+    for (size_t lane = 0; lane < kFloatLaneWidth; ++lane) {
+        size_t index = first + lane < points.Size() ? first + lane : first;
+        x[lane] = points.x[index];
+        y[lane] = points.y[index];
+        z[lane] = points.z[index];
+    }
+    return { LaneLoad(x), LaneLoad(y), LaneLoad(z) };
+}
+
+template <class Primitive>
+void ClosestPointsImpl(const Vector3SoA& points, const Primitive& primitive, Vector3SoA& closestPoints, std::span<float> distancesSq)
+{
+    size_t count = points.Size();
+    assert(distancesSq.empty() || distancesSq.size() >= count);
+    if (closestPoints.Size() != count) {
+        closestPoints.Resize(count);
+    }
+
+    // 書き出す(最後のレーンの組は端数の数だけ)
+    auto store = [&](size_t first, size_t laneCount, const LaneVector& closestPoint, FloatLane distanceSq) {
+        float x[kFloatLaneWidth];
+        float y[kFloatLaneWidth];
+        float z[kFloatLaneWidth];
+        float d[kFloatLaneWidth];
+        LaneStore(x, closestPoint.x);
+        LaneStore(y, closestPoint.y);
+        LaneStore(z, closestPoint.z);
+        LaneStore(d, distanceSq);
+        for (size_t lane = 0; lane < laneCount; ++lane) {
+            closestPoints.x[first + lane] = x[lane];
+            closestPoints.y[first + lane] = y[lane];
+            closestPoints.z[first + lane] = z[lane];
+            if (!distancesSq.empty()) {
+                distancesSq[first + lane] = d[lane];
+            }
+        }
+    };
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        LaneVector point = { LaneLoad(&points.x[i]), LaneLoad(&points.y[i]), LaneLoad(&points.z[i]) };
+        LaneVector closestPoint;
+        FloatLane distanceSq = ClosestPointLane(primitive, point, closestPoint);
+        LaneStore(&closestPoints.x[i], closestPoint.x);
+        LaneStore(&closestPoints.y[i], closestPoint.y);
+        LaneStore(&closestPoints.z[i], closestPoint.z);
+        if (!distancesSq.empty()) {
+            LaneStore(&distancesSq[i], distanceSq);
+        }
+    }
+
+    if (i < count) {
+        LaneVector closestPoint;
+        FloatLane distanceSq = ClosestPointLane(primitive, LoadRemainder(points, i), closestPoint);
+        store(i, count - i, closestPoint, distanceSq);
+    }
+}
+
+template <class Primitive>
+void FindNearestImpl(const Vector3SoA& points, std::span<const Primitive> primitives, std::span<uint32_t> nearestIndices, std::span<float> distancesSq)
+{
+    size_t count = points.Size();
+    assert(!primitives.empty());
+    assert(nearestIndices.size() >= count);
+    assert(distancesSq.size() >= count);
+
+    // レーンごとに最も近いプリミティブを探し、最初の laneCount 個を書き出す
+    auto findNearest = [&](size_t first, size_t laneCount, const LaneVector& point) {
+        LaneVector closestPoint;
+        FloatLane nearestDistanceSq = ClosestPointLane(primitives[0], point, closestPoint);
+        FloatLane nearestIndex = LaneSet(0.0f);
+        for (size_t j = 1; j < primitives.size(); ++j) {
+            FloatLane distanceSq = ClosestPointLane(primitives[j], point, closestPoint);
+            LaneMask isNearer = LaneLess(distanceSq, nearestDistanceSq);
+            nearestDistanceSq = LaneSelect(isNearer, distanceSq, nearestDistanceSq);
+            nearestIndex = LaneSelect(isNearer, LaneSet(static_cast<float>(j)), nearestIndex);
+        }
+
+        float indices[kFloatLaneWidth];
+        float d[kFloatLaneWidth];
+        LaneStore(indices, nearestIndex);
+        LaneStore(d, nearestDistanceSq);
+        for (size_t lane = 0; lane < laneCount; ++lane) {
+            nearestIndices[first + lane] = static_cast<uint32_t>(indices[lane]);
+            distancesSq[first + lane] = d[lane];
+        }
+    };
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        findNearest(i, kFloatLaneWidth, { LaneLoad(&points.x[i]), LaneLoad(&points.y[i]), LaneLoad(&points.z[i]) });
+    }
+    if (i < count) {
+        findNearest(i, count - i, LoadRemainder(points, i));
+    }
+}
+
+} // namespace
+
+ProximitySegment MakeProximitySegment(const Segment& segment)
+{
+    return { segment.origin, segment.diff, InverseLengthSq(segment.diff) };
+}
+
+ProximityTriangle MakeProximityTriangle(const Triangle& triangle)
+{
+    ProximityTriangle result {};
+    result.vertex0 = triangle.vertices[0];
+    result.vertex1 = triangle.vertices[1];
+    result.edges[0] = triangle.vertices[1] - triangle.vertices[0];
+    result.edges[1] = triangle.vertices[2] - triangle.vertices[0];
+    result.edges[2] = triangle.vertices[2] - triangle.vertices[1];
+    for (int i = 0; i < 3; ++i) {
+        result.invEdgeLengthSq[i] = InverseLengthSq(result.edges[i]);
+    }
+    result.normal = Cross(result.edges[0], result.edges[1]);
+    result.invNormalLengthSq = InverseLengthSq(result.normal);
+    result.edgeDot00 = Dot(result.edges[0], result.edges[0]);
+    result.edgeDot01 = Dot(result.edges[0], result.edges[1]);
+    result.edgeDot11 = Dot(result.edges[1], result.edges[1]);
+    result.denominator = result.edgeDot00 * result.edgeDot11 - result.edgeDot01 * result.edgeDot01;
+    if (result.denominator <= 0.0f || result.invNormalLengthSq == 0.0f) {
+        result.denominator = -1.0f;
+    }
+    return result;
+}
+
+ProximityPlane MakeProximityPlane(const Plane& plane)
+{
+    return { plane.normal, plane.distance, InverseLengthSq(plane.normal) };
+}
+
+void ClosestPoints(const Vector3SoA& points, const ProximitySegment& segment, Vector3SoA& closestPoints, std::span<float> distancesSq)
+{
+    ClosestPointsImpl(points, segment, closestPoints, distancesSq);
+}
+
+void ClosestPoints(const Vector3SoA& points, const ProximityTriangle& triangle, Vector3SoA& closestPoints, std::span<float> distancesSq)
+{
+    ClosestPointsImpl(points, triangle, closestPoints, distancesSq);
+}
+
+void ClosestPoints(const Vector3SoA& points, const AABB& aabb, Vector3SoA& closestPoints, std::span<float> distancesSq)
+{
+    ClosestPointsImpl(points, aabb, closestPoints, distancesSq);
+}
+
+void ClosestPoints(const Vector3SoA& points, const ProximityPlane& plane, Vector3SoA& closestPoints, std::span<float> distancesSq)
+{
+    ClosestPointsImpl(points, plane, closestPoints, distancesSq);
+}
+
+void FindNearest(const Vector3SoA& points, std::span<const ProximitySegment> segments, std::span<uint32_t> nearestIndices, std::span<float> distancesSq)
+{
+    FindNearestImpl(points, segments, nearestIndices, distancesSq);
+}
+
+void FindNearest(const Vector3SoA& points, std::span<const ProximityTriangle> triangles, std::span<uint32_t> nearestIndices, std::span<float> distancesSq)
+{
+    FindNearestImpl(points, triangles, nearestIndices, distancesSq);
+}
+
+void FindNearest(const Vector3SoA& points, std::span<const AABB> aabbs, std::span<uint32_t> nearestIndices, std::span<float> distancesSq)
+{
+    FindNearestImpl(points, aabbs, nearestIndices, distancesSq);
+}
+
+void FindNearest(const Vector3SoA& points, std::span<const ProximityPlane> planes, std::span<uint32_t> nearestIndices, std::span<float> distancesSq)
+{
+    FindNearestImpl(points, planes, nearestIndices, distancesSq);
+}
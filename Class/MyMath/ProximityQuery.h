@@ -0,0 +1,102 @@
+#pragma once
+
+#include "MyMath.h"
+#include "Vector/Vector3SoA.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+//================================================
+// 　最近点・距離の一括計算
+//
+// 多数の点(SoA形式)について、線分・三角形・AABB・平面への最近点と距離の2乗を求める
+// 点をSIMDのレーンに並べ、プリミティブの定数(辺の長さの2乗の逆数など)は前計算して全レーンに配る
+// 1点ごとの計算に除算は無く、分岐もしない
+//================================================
+
+/// <summary>
+/// 最近点を求めるために前計算した線分
+/// </summary>
+struct ProximitySegment {
+    Vector3 origin;
+    Vector3 diff;
+    float invLengthSq; //!< 1 / |diff|^2(長さ0なら0で、最近点は始点になる)
+};
+
+/// <summary>
+/// 最近点を求めるために前計算した三角形
+/// 原点から面に下ろした点が三角形の内側なら面上の点、外側なら3辺のうち最も近い点が最近点
+/// </summary>
+struct ProximityTriangle {
+    Vector3 vertex0;
+    Vector3 vertex1;
+    Vector3 edges[3]; //!< 頂点0→1、頂点0→2、頂点1→2
+    float invEdgeLengthSq[3]; //!< 各辺の長さの2乗の逆数(長さ0なら0)
+    Vector3 normal; //!< Cross(edges[0], edges[1])(正規化しない)
+    float invNormalLengthSq; //!< 1 / |normal|^2(つぶれた三角形なら0)
+    float edgeDot00; //!< Dot(edges[0], edges[0])
+    float edgeDot01; //!< Dot(edges[0], edges[1])
+    float edgeDot11; //!< Dot(edges[1], edges[1])
+    float denominator; //!< 重心座標の分母 edgeDot00 * edgeDot11 - edgeDot01^2(つぶれた三角形なら -1 にして、面の内側と判定しない)
+};
+
+/// <summary>
+/// 最近点を求めるために前計算した平面
+/// </summary>
+struct ProximityPlane {
+    Vector3 normal;
+    float distance;
+    float invNormalLengthSq; //!< 1 / |normal|^2(法線が正規化済みなら1)
+};
+
+ProximitySegment MakeProximitySegment(const Segment& segment);
+ProximityTriangle MakeProximityTriangle(const Triangle& triangle);
+ProximityPlane MakeProximityPlane(const Plane& plane);
+
+//================================================
+// 　1つのプリミティブへの最近点(一括)
+//================================================
+
+/// <summary>
+/// 線分上の最近点(一括)
+/// ClosestPoint(const Vector3&, const Segment&) と同じ点を求める
+/// </summary>
+/// <param name="points">点の配列</param>
+/// <param name="segment">前計算した線分</param>
+/// <param name="closestPoints">出力先(points と同じ配列でも良い。要素数は points に合わせる)</param>
+/// <param name="distancesSq">出力先(点から最近点までの距離の2乗。空なら書き込まない。要素数は points 以上)</param>
+void ClosestPoints(const Vector3SoA& points, const ProximitySegment& segment, Vector3SoA& closestPoints, std::span<float> distancesSq = {});
+
+// 三角形上の最近点(一括)
+void ClosestPoints(const Vector3SoA& points, const ProximityTriangle& triangle, Vector3SoA& closestPoints, std::span<float> distancesSq = {});
+
+// AABB上の最近点(一括。内側の点はその点自身)
+void ClosestPoints(const Vector3SoA& points, const AABB& aabb, Vector3SoA& closestPoints, std::span<float> distancesSq = {});
+
+// 平面上の最近点(一括)
+void ClosestPoints(const Vector3SoA& points, const ProximityPlane& plane, Vector3SoA& closestPoints, std::span<float> distancesSq = {});
+
+//================================================
+// 　最も近いプリミティブ(一括)
+//
+// 点ごとに、距離の2乗が最も小さいプリミティブの添字を求める(同じ距離なら添字の小さい方)
+// プリミティブの添字は 2^24 未満であること(レーンの中では float で持つ)
+//================================================
+
+/// <summary>
+/// 最も近い線分(一括)
+/// </summary>
+/// <param name="points">点の配列</param>
+/// <param name="segments">前計算した線分の配列(1つ以上)</param>
+/// <param name="nearestIndices">出力先(最も近い線分の添字。要素数は points 以上)</param>
+/// <param name="distancesSq">出力先(最も近い線分までの距離の2乗。要素数は points 以上)</param>
+void FindNearest(const Vector3SoA& points, std::span<const ProximitySegment> segments, std::span<uint32_t> nearestIndices, std::span<float> distancesSq);
+
+// 最も近い三角形(一括)
+void FindNearest(const Vector3SoA& points, std::span<const ProximityTriangle> triangles, std::span<uint32_t> nearestIndices, std::span<float> distancesSq);
+
+// 最も近いAABB(一括。内側にあれば距離0)
+void FindNearest(const Vector3SoA& points, std::span<const AABB> aabbs, std::span<uint32_t> nearestIndices, std::span<float> distancesSq);
+
+// 最も近い平面(一括。裏側でも距離で比べる)
+void FindNearest(const Vector3SoA& points, std::span<const ProximityPlane> planes, std::span<uint32_t> nearestIndices, std::span<float> distancesSq);
@@ -0,0 +1,72 @@
+#pragma once
+
+/// <summary>
+/// クォータニオン構造体
+/// (x, y, z) が虚部、w が実部。回転として使う場合は長さ1
+/// </summary>
+struct Quaternion {
+    float x, y, z, w;
+
+    // 4要素すべてを指定して作る(3要素の波括弧初期化が Vector3 と曖昧にならないよう集成体にしない)
+    Quaternion() = default;
+    constexpr Quaternion(float xValue, float yValue, float zValue, float wValue)
+        : x(xValue)
+        , y(yValue)
+        , z(zValue)
+        , w(wValue)
+    {
+    }
+
+    //========================================
+    // 　二項演算子
+    //========================================
+
+    // 積(ハミルトン積)
+    // 行ベクトルの行列と同じく、(q1 * q2) は q2 の回転のあとに q1 の回転を行う
+    constexpr Quaternion operator*(const Quaternion& q) const
+    {
+        return {
+            w * q.x + x * q.w + y * q.z - z * q.y,
+            w * q.y - x * q.z + y * q.w + z * q.x,
+            w * q.z + x * q.y - y * q.x + z * q.w,
+            w * q.w - x * q.x - y * q.y - z * q.z
+        };
+    }
+
+    // 加算
+    constexpr Quaternion operator+(const Quaternion& q) const
+    {
+        return { x + q.x, y + q.y, z + q.z, w + q.w };
+    }
+
+    // 減算
+    constexpr Quaternion operator-(const Quaternion& q) const
+    {
+        return { x - q.x, y - q.y, z - q.z, w - q.w };
+    }
+
+    // スカラー乗算
+    constexpr Quaternion operator*(float scalar) const
+    {
+        return { x * scalar, y * scalar, z * scalar, w * scalar };
+    }
+
+    //========================================
+    // 　単項演算子
+    //========================================
+
+    constexpr Quaternion operator-() const
+    {
+        return { -x, -y, -z, -w };
+    }
+
+    //========================================
+    // 　複合代入演算子
+    //========================================
+
+    constexpr Quaternion& operator*=(const Quaternion& q)
+    {
+        *this = *this * q;
+        return *this;
+    }
+};
@@ -0,0 +1,239 @@
+#include "ScreenProjector.h"
+#include "TransformBatch.h"
+#include <Novice.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+namespace {
+
+// 同次座標
+struct HomogeneousPoint {
+    float x, y, z, w;
+};
+
+// 同次座標への変換(除算なし)
+HomogeneousPoint TransformHomogeneous(const Vector3& v, const Matrix4x4& matrix)
+{
+    return {
+        v.x * matrix.m[0][0] + v.y * matrix.m[1][0] + v.z * matrix.m[2][0] + matrix.m[3][0],
+        v.x * matrix.m[0][1] + v.y * matrix.m[1][1] + v.z * matrix.m[2][1] + matrix.m[3][1],
+        v.x * matrix.m[0][2] + v.y * matrix.m[1][2] + v.z * matrix.m[2][2] + matrix.m[3][2],
+        v.x * matrix.m[0][3] + v.y * matrix.m[1][3] + v.z * matrix.m[2][3] + matrix.m[3][3]
+    };
+}
+
+// 同次座標の除算
+Vector3 PerspectiveDivide(const HomogeneousPoint& h)
+{
+    float invW = 1.0f / h.w;
+    return { h.x * invW, h.y * invW, h.z * invW };
+}
+
+// 同次座標の線形補間
+HomogeneousPoint LerpHomogeneous(const HomogeneousPoint& h1, const HomogeneousPoint& h2, float t)
+{
+    return {
+        h1.x + (h2.x - h1.x) * t,
+        h1.y + (h2.y - h1.y) * t,
+        h1.z + (h2.z - h1.z) * t,
+        h1.w + (h2.w - h1.w) * t
+    };
+}
+
+// 射影結果の一時バッファ
+std::vector<Vector3>& GetScreenPointBuffer(size_t count)
+{
+    thread_local std::vector<Vector3> buffer;
+    if (buffer.size() < count) {
+        buffer.resize(count);
+    }
+    return buffer;
+}
+
+// 頂点をまとめて変換し、スクリーン座標の線分を描画
+void DrawTransformedLines(std::span<const Vector3> points, std::span<const uint32_t> indices, const Matrix4x4& matrix, uint32_t color)
+{
+    std::vector<Vector3>& screenPoints = GetScreenPointBuffer(points.size());
+    TransformCoords(points, screenPoints, matrix);
+
+    for (size_t i = 0; i + 1 < indices.size(); i += 2) {
+        const Vector3& start = screenPoints[indices[i]];
+        const Vector3& end = screenPoints[indices[i + 1]];
+        Novice::DrawLine(int(start.x), int(start.y), int(end.x), int(end.y), color);
+    }
+}
+
+} // namespace
+
+ScreenProjector::ScreenProjector(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix)
+{
+    worldToScreenMatrix = Multiply(viewProjectionMatrix, viewportMatrix);
+
+    // クリップ空間のz(z >= 0 が近クリップ面の内側)をワールド空間の平面として持つ
+    nearPlane.normal = { viewProjectionMatrix.m[0][2], viewProjectionMatrix.m[1][2], viewProjectionMatrix.m[2][2] };
+    nearPlane.distance = -viewProjectionMatrix.m[3][2];
+
+    // クリップ空間のwも同じ形で持つ
+    depthPlane.normal = { viewProjectionMatrix.m[0][3], viewProjectionMatrix.m[1][3], viewProjectionMatrix.m[2][3] };
+    depthPlane.distance = -viewProjectionMatrix.m[3][3];
+
+    // 射影後のx,yの拡大率の大きい方をビューポートの拡大率と掛け合わせる
+    Vector3 clipX = { viewProjectionMatrix.m[0][0], viewProjectionMatrix.m[1][0], viewProjectionMatrix.m[2][0] };
+    Vector3 clipY = { viewProjectionMatrix.m[0][1], viewProjectionMatrix.m[1][1], viewProjectionMatrix.m[2][1] };
+    pixelsPerUnit = std::max(Length(clipX) * std::abs(viewportMatrix.m[0][0]), Length(clipY) * std::abs(viewportMatrix.m[1][1]));
+}
+
+bool ScreenProjector::IsInFrontOfNearPlane(const Sphere& sphere) const
+{
+    // 平面は正規化していないので、半径を法線の長さ分だけ拡大して比較する
+    return NearDistance(sphere.center) >= sphere.radius * Length(nearPlane.normal);
+}
+
+float ScreenProjector::ScreenRadius(const Sphere& sphere) const
+{
+    float w = Dot(depthPlane.normal, sphere.center) - depthPlane.distance;
+
+    // 球がカメラの位置にかかっている
+    if (w <= sphere.radius * Length(depthPlane.normal)) {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    return sphere.radius * pixelsPerUnit / w;
+}
+
+uint32_t ScreenProjector::SelectCircleSegmentCount(float screenRadius, uint32_t minCount, uint32_t maxCount) const
+{
+    // 誤差が半径以上なら最小の分割数で十分
+    if (screenRadius <= maxPixelError) {
+        return minCount;
+    }
+
+    // n分割の弦と弧の最大距離 r(1 - cos(π/n)) <= e となる n
+    float count = std::ceil(std::numbers::pi_v<float> / std::acos(1.0f - maxPixelError / screenRadius));
+    if (!(count < static_cast<float>(maxCount))) {
+        return maxCount;
+    }
+    return std::max(minCount, static_cast<uint32_t>(count));
+}
+
+uint32_t ScreenProjector::SelectBezierSegmentCount(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, uint32_t maxCount) const
+{
+    if (NearDistance(controlPoint0) < 0.0f || NearDistance(controlPoint1) < 0.0f || NearDistance(controlPoint2) < 0.0f) {
+        return maxCount;
+    }
+
+    Vector3 screen0 = Project(controlPoint0);
+    Vector3 screen1 = Project(controlPoint1);
+    Vector3 screen2 = Project(controlPoint2);
+
+    // 2次ベジェ曲線の2階微分は 2(p0 - 2p1 + p2) で一定なので、
+    // n分割の折れ線の誤差は |p0 - 2p1 + p2| / (4n^2) 以下になる
+    float dx = screen0.x - 2.0f * screen1.x + screen2.x;
+    float dy = screen0.y - 2.0f * screen1.y + screen2.y;
+    float count = std::ceil(std::sqrt(std::sqrt(dx * dx + dy * dy) / (4.0f * maxPixelError)));
+    if (!(count < static_cast<float>(maxCount))) {
+        return maxCount;
+    }
+    return std::max(1u, static_cast<uint32_t>(count));
+}
+
+Vector3 ScreenProjector::Project(const Vector3& point) const
+{
+    return PerspectiveDivide(TransformHomogeneous(point, worldToScreenMatrix));
+}
+
+void ScreenProjector::ProjectPoints(std::span<const Vector3> points, std::span<Vector3> screenPoints) const
+{
+    TransformCoords(points, screenPoints, worldToScreenMatrix);
+}
+
+bool ScreenProjector::ProjectLine(const Vector3& start, const Vector3& end, Vector3& screenStart, Vector3& screenEnd) const
+{
+    float startDistance = NearDistance(start);
+    float endDistance = NearDistance(end);
+
+    // 両端ともカメラの後ろ
+    if (startDistance < 0.0f && endDistance < 0.0f) {
+        return false;
+    }
+
+    HomogeneousPoint h1 = TransformHomogeneous(start, worldToScreenMatrix);
+    HomogeneousPoint h2 = TransformHomogeneous(end, worldToScreenMatrix);
+
+    // 近クリップ面をまたぐ場合は交点で切る(同次座標上では線形補間で良い)
+    if (startDistance < 0.0f) {
+        h1 = LerpHomogeneous(h1, h2, startDistance / (startDistance - endDistance));
+    } else if (endDistance < 0.0f) {
+        h2 = LerpHomogeneous(h1, h2, startDistance / (startDistance - endDistance));
+    }
+
+    screenStart = PerspectiveDivide(h1);
+    screenEnd = PerspectiveDivide(h2);
+    return true;
+}
+
+void ScreenProjector::DrawLine(const Vector3& start, const Vector3& end, uint32_t color) const
+{
+    Vector3 screenStart;
+    Vector3 screenEnd;
+    if (ProjectLine(start, end, screenStart, screenEnd)) {
+        Novice::DrawLine(int(screenStart.x), int(screenStart.y), int(screenEnd.x), int(screenEnd.y), color);
+    }
+}
+
+void ScreenProjector::DrawLines(std::span<const Vector3> points, std::span<const uint32_t> indices, uint32_t color) const
+{
+    bool isAllInFront = true;
+    for (const Vector3& point : points) {
+        if (NearDistance(point) < 0.0f) {
+            isAllInFront = false;
+            break;
+        }
+    }
+
+    // カメラの後ろにまたがる場合は線分ごとにクリッピング
+    if (!isAllInFront) {
+        for (size_t i = 0; i + 1 < indices.size(); i += 2) {
+            DrawLine(points[indices[i]], points[indices[i + 1]], color);
+        }
+        return;
+    }
+
+    DrawTransformedLines(points, indices, worldToScreenMatrix, color);
+}
+
+void ScreenProjector::DrawLinesUnclipped(std::span<const Vector3> localPoints, std::span<const uint32_t> indices, const Matrix4x4& worldMatrix, uint32_t color) const
+{
+    DrawTransformedLines(localPoints, indices, Multiply(worldMatrix, worldToScreenMatrix), color);
+}
+
+void ScreenProjector::DrawLineStrip(std::span<const Vector3> points, uint32_t color) const
+{
+    bool isAllInFront = true;
+    for (const Vector3& point : points) {
+        if (NearDistance(point) < 0.0f) {
+            isAllInFront = false;
+            break;
+        }
+    }
+
+    // カメラの後ろにまたがる場合は線分ごとにクリッピング
+    if (!isAllInFront) {
+        for (size_t i = 0; i + 1 < points.size(); ++i) {
+            DrawLine(points[i], points[i + 1], color);
+        }
+        return;
+    }
+
+    std::vector<Vector3>& screenPoints = GetScreenPointBuffer(points.size());
+    ProjectPoints(points, screenPoints);
+
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        const Vector3& start = screenPoints[i];
+        const Vector3& end = screenPoints[i + 1];
+        Novice::DrawLine(int(start.x), int(start.y), int(end.x), int(end.y), color);
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "MyMath.h"
+#include <cstdint>
+#include <span>
+
+// LODで許容する画面上の誤差の既定値(ピクセル)
+constexpr float kDefaultLodPixelError = 0.5f;
+
+/// <summary>
+/// ワールド座標からスクリーン座標への射影
+/// ビュープロジェクション行列とビューポート行列を1つにまとめ、1回の除算で射影する
+/// 線分はクリップ空間で近クリップ面に対してクリッピングする
+/// </summary>
+struct ScreenProjector {
+    Matrix4x4 worldToScreenMatrix; //!< ビュープロジェクション行列 × ビューポート行列
+    Plane nearPlane; //!< 近クリップ面(ワールド空間。正規化していないので値はクリップ空間のz)
+    Plane depthPlane; //!< クリップ空間のwを求める平面(透視投影ならカメラからの奥行き)
+    float pixelsPerUnit; //!< w = 1 の位置での1単位あたりのピクセル数
+    float maxPixelError = kDefaultLodPixelError; //!< LODで許容する画面上の誤差(ピクセル)
+
+    ScreenProjector() = default;
+
+    /// <summary>
+    /// フレームの行列から作成
+    /// </summary>
+    /// <param name="viewProjectionMatrix">ビュープロジェクション行列</param>
+    /// <param name="viewportMatrix">ビューポート行列(アフィン行列)</param>
+    ScreenProjector(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix);
+
+    /// <summary>
+    /// 近クリップ面からの符号付き距離(クリップ空間のz)。負ならカメラの後ろ側
+    /// </summary>
+    float NearDistance(const Vector3& point) const
+    {
+        return Dot(nearPlane.normal, point) - nearPlane.distance;
+    }
+
+    /// <summary>
+    /// 球全体が近クリップ面より手前にあるか(クリッピング不要か)
+    /// </summary>
+    bool IsInFrontOfNearPlane(const Sphere& sphere) const;
+
+    /// <summary>
+    /// 球の画面上の半径(ピクセル)。カメラの位置を含む場合は無限大
+    /// </summary>
+    float ScreenRadius(const Sphere& sphere) const;
+
+    /// <summary>
+    /// 画面上の半径から円の分割数を選ぶ(LOD)
+    /// 弦と弧の最大距離が maxPixelError 以下になる最小の分割数
+    /// </summary>
+    /// <param name="screenRadius">画面上の半径(ピクセル)</param>
+    /// <param name="minCount">最小の分割数</param>
+    /// <param name="maxCount">最大の分割数</param>
+    uint32_t SelectCircleSegmentCount(float screenRadius, uint32_t minCount, uint32_t maxCount) const;
+
+    /// <summary>
+    /// 2次ベジェ曲線の分割数を選ぶ(LOD)
+    /// 制御点を射影し、折れ線と曲線の画面上の距離が maxPixelError 以下になる最小の分割数
+    /// </summary>
+    /// <param name="maxCount">最大の分割数(制御点が近クリップ面をまたぐ場合もこの値)</param>
+    uint32_t SelectBezierSegmentCount(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPoint2, uint32_t maxCount) const;
+
+    /// <summary>
+    /// 点をスクリーン座標に射影(近クリップ面より手前にある点のみ有効)
+    /// </summary>
+    Vector3 Project(const Vector3& point) const;
+
+    /// <summary>
+    /// 点をまとめてスクリーン座標に射影(近クリップ面より手前にある点のみ有効)
+    /// </summary>
+    void ProjectPoints(std::span<const Vector3> points, std::span<Vector3> screenPoints) const;
+
+    /// <summary>
+    /// 線分を近クリップ面でクリッピングしてスクリーン座標に射影
+    /// </summary>
+    /// <param name="start">始点(ワールド座標)</param>
+    /// <param name="end">終点(ワールド座標)</param>
+    /// <param name="screenStart">始点(スクリーン座標)</param>
+    /// <param name="screenEnd">終点(スクリーン座標)</param>
+    /// <returns>線分が完全にカメラの後ろにあれば false</returns>
+    bool ProjectLine(const Vector3& start, const Vector3& end, Vector3& screenStart, Vector3& screenEnd) const;
+
+    /// <summary>
+    /// 線分をクリッピングして描画
+    /// </summary>
+    void DrawLine(const Vector3& start, const Vector3& end, uint32_t color) const;
+
+    /// <summary>
+    /// 線分をまとめて描画
+    /// 全頂点が近クリップ面より手前なら各頂点を1回だけ射影し、そうでなければ線分ごとにクリッピングする
+    /// </summary>
+    /// <param name="points">頂点(ワールド座標)</param>
+    /// <param name="indices">線分の頂点番号(2つで1本)</param>
+    /// <param name="color">色</param>
+    void DrawLines(std::span<const Vector3> points, std::span<const uint32_t> indices, uint32_t color) const;
+
+    /// <summary>
+    /// ローカル座標の線分をまとめて描画(クリッピングなし)
+    /// ワールド行列と射影を1つの行列にまとめ、各頂点を1回だけ変換する
+    /// 全頂点が近クリップ面より手前にあると呼び出し側で分かっている場合に使う
+    /// </summary>
+    /// <param name="localPoints">頂点(ローカル座標)</param>
+    /// <param name="indices">線分の頂点番号(2つで1本)</param>
+    /// <param name="worldMatrix">ワールド行列</param>
+    /// <param name="color">色</param>
+    void DrawLinesUnclipped(std::span<const Vector3> localPoints, std::span<const uint32_t> indices, const Matrix4x4& worldMatrix, uint32_t color) const;
+
+    /// <summary>
+    /// 頂点を順につないだ折れ線を描画
+    /// </summary>
+    /// <param name="points">頂点(ワールド座標)</param>
+    /// <param name="color">色</param>
+    void DrawLineStrip(std::span<const Vector3> points, uint32_t color) const;
+};
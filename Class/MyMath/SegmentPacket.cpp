@@ -0,0 +1,166 @@
+#include "SegmentPacket.h"
+#include <assert.h>
+#include <bit>
+#include <limits>
+
+namespace {
+
+float InverseDiff(float diff)
+{
+    return diff != 0.0f ? 1.0f / diff : 0.0f;
+}
+
+// 有効なレーンのビット
+unsigned int ValidLaneBits(size_t count)
+{
+    return (1u << count) - 1u;
+}
+
+// 1軸分のスラブで t の範囲を絞り込む(分岐なし)
+// 軸に平行なレーンは、始点が範囲内なら制限なし、範囲外なら空の範囲にする
+inline void ClipSlab(FloatLane origin, FloatLane invDiff, FloatLane min, FloatLane max, FloatLane& tmin, FloatLane& tmax)
+{
+    FloatLane t1 = LaneMul(LaneSub(min, origin), invDiff);
+    FloatLane t2 = LaneMul(LaneSub(max, origin), invDiff);
+
+    FloatLane infinity = LaneSet(std::numeric_limits<float>::infinity());
+    FloatLane negativeInfinity = LaneSet(-std::numeric_limits<float>::infinity());
+    LaneMask parallel = LaneEqual(invDiff, LaneSet(0.0f));
+    LaneMask inside = LaneAnd(LaneLessEqual(min, origin), LaneLessEqual(origin, max));
+
+    FloatLane nearT = LaneSelect(parallel, LaneSelect(inside, negativeInfinity, infinity), LaneMin(t1, t2));
+    FloatLane farT = LaneSelect(parallel, LaneSelect(inside, infinity, negativeInfinity), LaneMax(t1, t2));
+    tmin = LaneMax(tmin, nearT);
+    tmax = LaneMin(tmax, farT);
+}
+
+// スラブ法(分岐なし)。各軸で入る t の最大と出る t の最小を求め、線分の範囲(0 ~ 1)と比べる
+inline unsigned int SlabTest(
+    FloatLane originX, FloatLane originY, FloatLane originZ,
+    FloatLane invDiffX, FloatLane invDiffY, FloatLane invDiffZ,
+    FloatLane minX, FloatLane minY, FloatLane minZ,
+    FloatLane maxX, FloatLane maxY, FloatLane maxZ,
+    float* entryT)
+{
+    FloatLane tmin = LaneSet(-std::numeric_limits<float>::infinity());
+    FloatLane tmax = LaneSet(std::numeric_limits<float>::infinity());
+    ClipSlab(originX, invDiffX, minX, maxX, tmin, tmax);
+    ClipSlab(originY, invDiffY, minY, maxY, tmin, tmax);
+    ClipSlab(originZ, invDiffZ, minZ, maxZ, tmin, tmax);
+
+    FloatLane zero = LaneSet(0.0f);
+    LaneMask hit = LaneAnd(LaneAnd(LaneLessEqual(tmin, tmax), LaneLessEqual(zero, tmax)), LaneLessEqual(tmin, LaneSet(1.0f)));
+
+    LaneStore(entryT, LaneMax(tmin, zero));
+    return LaneMaskBits(hit);
+}
+
+} // namespace
+
+PreparedSegment MakePreparedSegment(const Segment& segment)
+{
+    return {
+        segment.origin,
+        { InverseDiff(segment.diff.x), InverseDiff(segment.diff.y), InverseDiff(segment.diff.z) },
+    };
+}
+
+SegmentPacket MakeSegmentPacket(std::span<const Segment> segments)
+{
+    assert(!segments.empty());
+
+    SegmentPacket packet;
+    packet.count = std::min(segments.size(), kPacketWidth);
+    for (size_t i = 0; i < kPacketWidth; ++i) {
+        PreparedSegment segment = MakePreparedSegment(segments[i < packet.count ? i : 0]);
+        packet.originX[i] = segment.origin.x;
+        packet.originY[i] = segment.origin.y;
+        packet.originZ[i] = segment.origin.z;
+        packet.invDiffX[i] = segment.invDiff.x;
+        packet.invDiffY[i] = segment.invDiff.y;
+        packet.invDiffZ[i] = segment.invDiff.z;
+    }
+    return packet;
+}
+
+AABBPacket MakeAABBPacket(std::span<const AABB> aabbs)
+{
+    assert(!aabbs.empty());
+
+    AABBPacket packet;
+    packet.count = std::min(aabbs.size(), kPacketWidth);
+    for (size_t i = 0; i < kPacketWidth; ++i) {
+        const AABB& aabb = aabbs[i < packet.count ? i : 0];
+        packet.minX[i] = aabb.min.x;
+        packet.minY[i] = aabb.min.y;
+        packet.minZ[i] = aabb.min.z;
+        packet.maxX[i] = aabb.max.x;
+        packet.maxY[i] = aabb.max.y;
+        packet.maxZ[i] = aabb.max.z;
+    }
+    return packet;
+}
+
+unsigned int IntersectSegmentPacket(const SegmentPacket& packet, const AABB& aabb, float* entryT)
+{
+    unsigned int hitBits = SlabTest(
+        LaneLoad(packet.originX), LaneLoad(packet.originY), LaneLoad(packet.originZ),
+        LaneLoad(packet.invDiffX), LaneLoad(packet.invDiffY), LaneLoad(packet.invDiffZ),
+        LaneSet(aabb.min.x), LaneSet(aabb.min.y), LaneSet(aabb.min.z),
+        LaneSet(aabb.max.x), LaneSet(aabb.max.y), LaneSet(aabb.max.z),
+        entryT);
+    return hitBits & ValidLaneBits(packet.count);
+}
+
+unsigned int IntersectAABBPacket(const PreparedSegment& segment, const AABBPacket& packet, float* entryT)
+{
+    unsigned int hitBits = SlabTest(
+        LaneSet(segment.origin.x), LaneSet(segment.origin.y), LaneSet(segment.origin.z),
+        LaneSet(segment.invDiff.x), LaneSet(segment.invDiff.y), LaneSet(segment.invDiff.z),
+        LaneLoad(packet.minX), LaneLoad(packet.minY), LaneLoad(packet.minZ),
+        LaneLoad(packet.maxX), LaneLoad(packet.maxY), LaneLoad(packet.maxZ),
+        entryT);
+    return hitBits & ValidLaneBits(packet.count);
+}
+
+size_t IntersectAABBs(const Segment& segment, std::span<const AABB> aabbs, std::span<uint8_t> hitMask, std::span<float> entryT)
+{
+    assert(hitMask.size() >= aabbs.size());
+    assert(entryT.size() >= aabbs.size());
+
+    PreparedSegment preparedSegment = MakePreparedSegment(segment);
+
+    size_t hitCount = 0;
+    float packetEntryT[kPacketWidth];
+    for (size_t first = 0; first < aabbs.size(); first += kPacketWidth) {
+        AABBPacket packet = MakeAABBPacket(aabbs.subspan(first));
+        unsigned int hitBits = IntersectAABBPacket(preparedSegment, packet, packetEntryT);
+        hitCount += static_cast<size_t>(std::popcount(hitBits));
+
+        for (size_t i = 0; i < packet.count; ++i) {
+            hitMask[first + i] = static_cast<uint8_t>((hitBits >> i) & 1u);
+            entryT[first + i] = packetEntryT[i];
+        }
+    }
+    return hitCount;
+}
+
+size_t IntersectSegments(std::span<const Segment> segments, const AABB& aabb, std::span<uint8_t> hitMask, std::span<float> entryT)
+{
+    assert(hitMask.size() >= segments.size());
+    assert(entryT.size() >= segments.size());
+
+    size_t hitCount = 0;
+    float packetEntryT[kPacketWidth];
+    for (size_t first = 0; first < segments.size(); first += kPacketWidth) {
+        SegmentPacket packet = MakeSegmentPacket(segments.subspan(first));
+        unsigned int hitBits = IntersectSegmentPacket(packet, aabb, packetEntryT);
+        hitCount += static_cast<size_t>(std::popcount(hitBits));
+
+        for (size_t i = 0; i < packet.count; ++i) {
+            hitMask[first + i] = static_cast<uint8_t>((hitBits >> i) & 1u);
+            entryT[first + i] = packetEntryT[i];
+        }
+    }
+    return hitCount;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "MyMath.h"
+#include "SimdLane.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+/// <summary>
+/// AABBとの判定用に前計算した線分(方向の逆数を持つ)
+/// </summary>
+struct PreparedSegment {
+    Vector3 origin;
+    Vector3 invDiff; //!< 1 / diff(diff が 0 の成分は 0 にして、軸に平行なことを表す)
+};
+
+/// <summary>
+/// 線分のパケット(SIMDのレーン数分の線分を成分ごとに並べたもの)
+/// </summary>
+struct SegmentPacket {
+    float originX[kFloatLaneWidth];
+    float originY[kFloatLaneWidth];
+    float originZ[kFloatLaneWidth];
+    float invDiffX[kFloatLaneWidth];
+    float invDiffY[kFloatLaneWidth];
+    float invDiffZ[kFloatLaneWidth];
+    size_t count; //!< 有効な線分の数(残りのレーンは0番の線分で埋める)
+};
+
+/// <summary>
+/// AABBのパケット(SIMDのレーン数分のAABBを成分ごとに並べたもの)
+/// </summary>
+struct AABBPacket {
+    float minX[kFloatLaneWidth];
+    float minY[kFloatLaneWidth];
+    float minZ[kFloatLaneWidth];
+    float maxX[kFloatLaneWidth];
+    float maxY[kFloatLaneWidth];
+    float maxZ[kFloatLaneWidth];
+    size_t count; //!< 有効なAABBの数(残りのレーンは0番のAABBで埋める)
+};
+
+// パケットに入る要素数(AVXなら8、SSEなら4)
+constexpr size_t kPacketWidth = kFloatLaneWidth;
+
+// 線分を前計算する
+PreparedSegment MakePreparedSegment(const Segment& segment);
+
+/// <summary>
+/// 前計算した線分が AABB の各軸の範囲にある t の区間(スカラー版)
+/// IsCollision(const AABB&, const Segment&) と同じく、軸に平行な成分は始点が範囲内なら制限しない
+/// </summary>
+/// <param name="segment">前計算した線分</param>
+/// <param name="min">AABBの最小点</param>
+/// <param name="max">AABBの最大点</param>
+/// <param name="tmin">出力先(入る t。交わらなければ tmax より大きくなる)</param>
+/// <param name="tmax">出力先(出る t)</param>
+inline void SlabRange(const PreparedSegment& segment, const Vector3& min, const Vector3& max, float& tmin, float& tmax)
+{
+    constexpr float kInfinity = std::numeric_limits<float>::infinity();
+    tmin = -kInfinity;
+    tmax = kInfinity;
+
+    auto clipAxis = [&](float origin, float invDiff, float boxMin, float boxMax) {
+        if (invDiff == 0.0f) {
+            if (origin < boxMin || boxMax < origin) {
+                tmin = kInfinity;
+                tmax = -kInfinity;
+            }
+            return;
+        }
+        float t1 = (boxMin - origin) * invDiff;
+        float t2 = (boxMax - origin) * invDiff;
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+    };
+
+    clipAxis(segment.origin.x, segment.invDiff.x, min.x, max.x);
+    clipAxis(segment.origin.y, segment.invDiff.y, min.y, max.y);
+    clipAxis(segment.origin.z, segment.invDiff.z, min.z, max.z);
+}
+
+/// <summary>
+/// 前計算した線分(t が 0 ~ maxT の範囲)が AABB に入る t(木の走査でノードを近い順に調べるのに使う)
+/// </summary>
+/// <param name="segment">前計算した線分</param>
+/// <param name="min">AABBの最小点</param>
+/// <param name="max">AABBの最大点</param>
+/// <param name="maxT">t の上限</param>
+/// <returns>入る t(始点が中にあれば0)。交わらなければ無限大</returns>
+inline float SegmentEnterT(const PreparedSegment& segment, const Vector3& min, const Vector3& max, float maxT)
+{
+    float tmin;
+    float tmax;
+    SlabRange(segment, min, max, tmin, tmax);
+
+    if (tmin <= tmax && tmax >= 0.0f && tmin <= maxT) {
+        return std::max(tmin, 0.0f);
+    }
+    return std::numeric_limits<float>::infinity();
+}
+
+// 線分をパケットにまとめる(先頭の kPacketWidth 個まで)
+SegmentPacket MakeSegmentPacket(std::span<const Segment> segments);
+
+// AABBをパケットにまとめる(先頭の kPacketWidth 個まで)
+AABBPacket MakeAABBPacket(std::span<const AABB> aabbs);
+
+/// <summary>
+/// パケットの各線分と1つのAABBの判定(分岐なし)
+/// IsCollision(const AABB&, const Segment&) と同じ判定をレーン数分まとめて行う
+/// </summary>
+/// <param name="packet">線分のパケット</param>
+/// <param name="aabb">AABB</param>
+/// <param name="entryT">出力先(各線分がAABBに入る t。始点が中にあれば0。要素数は kPacketWidth)</param>
+/// <returns>当たった線分のビットマスク(i 番目の線分が当たれば i ビット目が1)</returns>
+unsigned int IntersectSegmentPacket(const SegmentPacket& packet, const AABB& aabb, float* entryT);
+
+/// <summary>
+/// 1つの線分とパケットの各AABBの判定(分岐なし)
+/// </summary>
+/// <param name="segment">前計算した線分</param>
+/// <param name="packet">AABBのパケット</param>
+/// <param name="entryT">出力先(各AABBに入る t。始点が中にあれば0。要素数は kPacketWidth)</param>
+/// <returns>当たったAABBのビットマスク(i 番目のAABBに当たれば i ビット目が1)</returns>
+unsigned int IntersectAABBPacket(const PreparedSegment& segment, const AABBPacket& packet, float* entryT);
+
+/// <summary>
+/// 1つの線分と複数のAABBの判定(一括。内部でパケットにまとめる)
+/// </summary>
+/// <param name="segment">線分</param>
+/// <param name="aabbs">AABBの配列</param>
+/// <param name="hitMask">出力先(当たれば1、当たらなければ0。要素数は aabbs 以上)</param>
+/// <param name="entryT">出力先(AABBに入る t。当たらなかった要素の値は不定。要素数は aabbs 以上)</param>
+/// <returns>当たったAABBの数</returns>
+size_t IntersectAABBs(const Segment& segment, std::span<const AABB> aabbs, std::span<uint8_t> hitMask, std::span<float> entryT);
+
+/// <summary>
+/// 複数の線分と1つのAABBの判定(一括。内部でパケットにまとめる)
+/// </summary>
+/// <param name="segments">線分の配列</param>
+/// <param name="aabb">AABB</param>
+/// <param name="hitMask">出力先(当たれば1、当たらなければ0。要素数は segments 以上)</param>
+/// <param name="entryT">出力先(AABBに入る t。当たらなかった要素の値は不定。要素数は segments 以上)</param>
+/// <returns>当たった線分の数</returns>
+size_t IntersectSegments(std::span<const Segment> segments, const AABB& aabb, std::span<uint8_t> hitMask, std::span<float> entryT);
@@ -0,0 +1,28 @@
+#pragma once
+
+//================================================
+// 　SIMDバックエンドの選択(コンパイル時)
+//
+// MYMATH_SIMD_LEVEL
+//   0 : スカラー実装
+//   1 : SSE2 (x64では常に利用可能)
+//   2 : AVX  (/arch:AVX 以上でビルドした場合)
+//
+// MYMATH_DISABLE_SIMD を定義するとスカラー実装に固定される
+//================================================
+
+#if !defined(MYMATH_SIMD_LEVEL)
+#if defined(MYMATH_DISABLE_SIMD)
+#define MYMATH_SIMD_LEVEL 0
+#elif defined(__AVX__)
+#define MYMATH_SIMD_LEVEL 2
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MYMATH_SIMD_LEVEL 1
+#else
+#define MYMATH_SIMD_LEVEL 0
+#endif
+#endif
+
+#if MYMATH_SIMD_LEVEL >= 1
+#include <immintrin.h>
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "SimdConfig.h"
+#include <cmath>
+#include <cstddef>
+
+//================================================
+// 　SIMDレーン
+//
+// MYMATH_SIMD_LEVEL に応じて AVX(8要素) / SSE(4要素) / スカラー(1要素) を切り替える
+// 配列を一括処理するカーネルはこの関数群で1度だけ書き、端数はスカラーで処理する
+// スカラーで書き直すと長くなるカーネルは、端数をレーン幅の一時配列に詰めて同じレーンの計算をしてもよい
+// (その場合、詰めた余りのレーンは有効な要素で埋め、結果は有効なレーンの分だけ書き戻す)
+//================================================
+
+#if MYMATH_SIMD_LEVEL >= 2
+
+using FloatLane = __m256;
+using LaneMask = __m256;
+constexpr size_t kFloatLaneWidth = 8;
+
+inline FloatLane LaneLoad(const float* p) { return _mm256_loadu_ps(p); }
+inline void LaneStore(float* p, FloatLane v) { _mm256_storeu_ps(p, v); }
+inline FloatLane LaneSet(float value) { return _mm256_set1_ps(value); }
+inline FloatLane LaneAdd(FloatLane a, FloatLane b) { return _mm256_add_ps(a, b); }
+inline FloatLane LaneSub(FloatLane a, FloatLane b) { return _mm256_sub_ps(a, b); }
+inline FloatLane LaneMul(FloatLane a, FloatLane b) { return _mm256_mul_ps(a, b); }
+inline FloatLane LaneDiv(FloatLane a, FloatLane b) { return _mm256_div_ps(a, b); }
+inline FloatLane LaneSqrt(FloatLane a) { return _mm256_sqrt_ps(a); }
+inline FloatLane LaneMin(FloatLane a, FloatLane b) { return _mm256_min_ps(a, b); }
+inline FloatLane LaneMax(FloatLane a, FloatLane b) { return _mm256_max_ps(a, b); }
+inline FloatLane LaneAbs(FloatLane a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+inline LaneMask LaneLess(FloatLane a, FloatLane b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline LaneMask LaneLessEqual(FloatLane a, FloatLane b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline LaneMask LaneGreater(FloatLane a, FloatLane b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+inline LaneMask LaneEqual(FloatLane a, FloatLane b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+inline LaneMask LaneNotEqual(FloatLane a, FloatLane b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+inline LaneMask LaneAnd(LaneMask a, LaneMask b) { return _mm256_and_ps(a, b); }
+inline LaneMask LaneOr(LaneMask a, LaneMask b) { return _mm256_or_ps(a, b); }
+inline FloatLane LaneSelect(LaneMask mask, FloatLane ifTrue, FloatLane ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+inline unsigned int LaneMaskBits(LaneMask mask) { return static_cast<unsigned int>(_mm256_movemask_ps(mask)); }
+
+#elif MYMATH_SIMD_LEVEL >= 1
+
+using FloatLane = __m128;
+using LaneMask = __m128;
+constexpr size_t kFloatLaneWidth = 4;
+
+inline FloatLane LaneLoad(const float* p) { return _mm_loadu_ps(p); }
+inline void LaneStore(float* p, FloatLane v) { _mm_storeu_ps(p, v); }
+inline FloatLane LaneSet(float value) { return _mm_set1_ps(value); }
+inline FloatLane LaneAdd(FloatLane a, FloatLane b) { return _mm_add_ps(a, b); }
+inline FloatLane LaneSub(FloatLane a, FloatLane b) { return _mm_sub_ps(a, b); }
+inline FloatLane LaneMul(FloatLane a, FloatLane b) { return _mm_mul_ps(a, b); }
+inline FloatLane LaneDiv(FloatLane a, FloatLane b) { return _mm_div_ps(a, b); }
+inline FloatLane LaneSqrt(FloatLane a) { return _mm_sqrt_ps(a); }
+inline FloatLane LaneMin(FloatLane a, FloatLane b) { return _mm_min_ps(a, b); }
+inline FloatLane LaneMax(FloatLane a, FloatLane b) { return _mm_max_ps(a, b); }
+inline FloatLane LaneAbs(FloatLane a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline LaneMask LaneLess(FloatLane a, FloatLane b) { return _mm_cmplt_ps(a, b); }
+inline LaneMask LaneLessEqual(FloatLane a, FloatLane b) { return _mm_cmple_ps(a, b); }
+inline LaneMask LaneGreater(FloatLane a, FloatLane b) { return _mm_cmpgt_ps(a, b); }
+inline LaneMask LaneEqual(FloatLane a, FloatLane b) { return _mm_cmpeq_ps(a, b); }
+inline LaneMask LaneNotEqual(FloatLane a, FloatLane b) { return _mm_cmpneq_ps(a, b); }
+inline LaneMask LaneAnd(LaneMask a, LaneMask b) { return _mm_and_ps(a, b); }
+inline LaneMask LaneOr(LaneMask a, LaneMask b) { return _mm_or_ps(a, b); }
+inline FloatLane LaneSelect(LaneMask mask, FloatLane ifTrue, FloatLane ifFalse) { return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse)); }
+inline unsigned int LaneMaskBits(LaneMask mask) { return static_cast<unsigned int>(_mm_movemask_ps(mask)); }
+
+#else
+
+using FloatLane = float;
+using LaneMask = bool;
+constexpr size_t kFloatLaneWidth = 1;
+
+inline FloatLane LaneLoad(const float* p) { return *p; }
+inline void LaneStore(float* p, FloatLane v) { *p = v; }
+inline FloatLane LaneSet(float value) { return value; }
+inline FloatLane LaneAdd(FloatLane a, FloatLane b) { return a + b; }
+inline FloatLane LaneSub(FloatLane a, FloatLane b) { return a - b; }
+inline FloatLane LaneMul(FloatLane a, FloatLane b) { return a * b; }
+inline FloatLane LaneDiv(FloatLane a, FloatLane b) { return a / b; }
+inline FloatLane LaneSqrt(FloatLane a) { return std::sqrt(a); }
+inline FloatLane LaneMin(FloatLane a, FloatLane b) { return b < a ? b : a; }
+inline FloatLane LaneMax(FloatLane a, FloatLane b) { return a < b ? b : a; }
+inline FloatLane LaneAbs(FloatLane a) { return std::fabs(a); }
+inline LaneMask LaneLess(FloatLane a, FloatLane b) { return a < b; }
+inline LaneMask LaneLessEqual(FloatLane a, FloatLane b) { return a <= b; }
+inline LaneMask LaneGreater(FloatLane a, FloatLane b) { return a > b; }
+inline LaneMask LaneEqual(FloatLane a, FloatLane b) { return a == b; }
+inline LaneMask LaneNotEqual(FloatLane a, FloatLane b) { return a != b; }
+inline LaneMask LaneAnd(LaneMask a, LaneMask b) { return a && b; }
+inline LaneMask LaneOr(LaneMask a, LaneMask b) { return a || b; }
+inline FloatLane LaneSelect(LaneMask mask, FloatLane ifTrue, FloatLane ifFalse) { return mask ? ifTrue : ifFalse; }
+inline unsigned int LaneMaskBits(LaneMask mask) { return mask ? 1u : 0u; }
+
+#endif
+
+#if MYMATH_SIMD_LEVEL >= 1
+
+//================================================
+// 　AoS <-> SoA 変換(4要素)
+//================================================
+
+/// <summary>
+/// x,y,z が連続した4要素(12個のfloat)を成分ごとのレジスタに並び替えて読み込む
+/// </summary>
+inline void LoadAoS4(const float* src, __m128& x, __m128& y, __m128& z)
+{
+    __m128 v0 = _mm_loadu_ps(src); // x0 y0 z0 x1
+    __m128 v1 = _mm_loadu_ps(src + 4); // y1 z1 x2 y2
+    __m128 v2 = _mm_loadu_ps(src + 8); // z2 x3 y3 z3
+
+    x = _mm_shuffle_ps(v0, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2)), v2, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+/// <summary>
+/// 成分ごとのレジスタを x,y,z が連続した4要素に並び替えて書き込む
+/// </summary>
+inline void StoreAoS4(float* dst, __m128 x, __m128 y, __m128 z)
+{
+    __m128 xy01 = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+    __m128 xy23 = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+    __m128 v0 = _mm_shuffle_ps(xy01, _mm_shuffle_ps(z, xy01, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+    __m128 v1 = _mm_shuffle_ps(_mm_shuffle_ps(xy01, z, _MM_SHUFFLE(1, 1, 3, 3)), xy23, _MM_SHUFFLE(1, 0, 2, 0));
+    __m128 v2 = _mm_shuffle_ps(_mm_shuffle_ps(z, xy23, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(xy23, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+    _mm_storeu_ps(dst, v0);
+    _mm_storeu_ps(dst + 4, v1);
+    _mm_storeu_ps(dst + 8, v2);
+}
+
+#endif
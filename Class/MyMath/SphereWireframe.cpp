@@ -0,0 +1,89 @@
+#include "SphereWireframe.h"
+#include <assert.h>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <unordered_map>
+
+namespace {
+
+// ワイヤーフレームの作成
+std::unique_ptr<SphereWireframe> CreateSphereWireframe(uint32_t subdivision)
+{
+    auto wireframe = std::make_unique<SphereWireframe>();
+    wireframe->subdivision = subdivision;
+
+    // 経度分割１つ分の角度
+    const float kLongEvery = 2.0f * std::numbers::pi_v<float> / static_cast<float>(subdivision);
+
+    // 緯度分割１つ分の角度
+    const float kLatEvery = std::numbers::pi_v<float> / static_cast<float>(subdivision);
+
+    // 頂点 : 南極, 緯度1 ~ subdivision-1 の各リング, 北極
+    const uint32_t kRingCount = subdivision - 1;
+    const uint32_t kSouthPole = 0;
+    const uint32_t kNorthPole = 1 + kRingCount * subdivision;
+
+    wireframe->vertices.reserve(kNorthPole + 1);
+    wireframe->vertices.push_back({ 0.0f, -1.0f, 0.0f });
+
+    for (uint32_t latIndex = 1; latIndex < subdivision; ++latIndex) {
+
+        // 現在の緯度
+        float lat = -std::numbers::pi_v<float> / 2.0f + kLatEvery * latIndex;
+
+        for (uint32_t lonIndex = 0; lonIndex < subdivision; ++lonIndex) {
+
+            // 現在の経度
+            float lon = kLongEvery * lonIndex;
+
+            wireframe->vertices.push_back({ std::cos(lat) * std::cos(lon), std::sin(lat), std::cos(lat) * std::sin(lon) });
+        }
+    }
+
+    wireframe->vertices.push_back({ 0.0f, 1.0f, 0.0f });
+
+    // 緯度 latIndex, 経度 lonIndex の頂点番号
+    auto vertexIndex = [&](uint32_t latIndex, uint32_t lonIndex) {
+        if (latIndex == 0) {
+            return kSouthPole;
+        }
+        if (latIndex == subdivision) {
+            return kNorthPole;
+        }
+        return 1 + (latIndex - 1) * subdivision + lonIndex % subdivision;
+    };
+
+    // 経線(南極から北極まで) + 緯線(各リング)
+    wireframe->indices.reserve((subdivision * subdivision + kRingCount * subdivision) * 2);
+
+    for (uint32_t latIndex = 0; latIndex < subdivision; ++latIndex) {
+        for (uint32_t lonIndex = 0; lonIndex < subdivision; ++lonIndex) {
+            wireframe->indices.push_back(vertexIndex(latIndex, lonIndex));
+            wireframe->indices.push_back(vertexIndex(latIndex + 1, lonIndex));
+
+            // 南極のリングは長さ0なので描かない
+            if (latIndex != 0) {
+                wireframe->indices.push_back(vertexIndex(latIndex, lonIndex));
+                wireframe->indices.push_back(vertexIndex(latIndex, lonIndex + 1));
+            }
+        }
+    }
+
+    return wireframe;
+}
+
+} // namespace
+
+const SphereWireframe& GetSphereWireframe(uint32_t subdivision)
+{
+    assert(subdivision >= 2);
+
+    static std::unordered_map<uint32_t, std::unique_ptr<SphereWireframe>> cache;
+
+    std::unique_ptr<SphereWireframe>& wireframe = cache[subdivision];
+    if (!wireframe) {
+        wireframe = CreateSphereWireframe(subdivision);
+    }
+    return *wireframe;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "MyMath.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 単位球のワイヤーフレーム(頂点と線分)
+/// 緯度・経度で分割した頂点を共有し、極は1頂点にまとめる
+/// </summary>
+struct SphereWireframe {
+    uint32_t subdivision; //!< 緯度・経度の分割数
+    std::vector<Vector3> vertices; //!< 頂点(半径1、中心は原点)
+    std::vector<uint32_t> indices; //!< 線分の頂点番号(2つで1本)
+};
+
+/// <summary>
+/// 単位球のワイヤーフレームを取得
+/// 分割数ごとに初回だけ作成し、以降はキャッシュを返す(描画スレッドからのみ呼ぶこと)
+/// </summary>
+/// <param name="subdivision">緯度・経度の分割数(2以上)</param>
+const SphereWireframe& GetSphereWireframe(uint32_t subdivision);
@@ -0,0 +1,154 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t workerCount)
+{
+    workerCount_ = workerCount > 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency());
+    queues_ = std::make_unique<WorkQueue[]>(workerCount_);
+
+    threads_.reserve(workerCount_ - 1);
+    for (uint32_t i = 1; i < workerCount_; ++i) {
+        threads_.emplace_back(&ThreadPool::WorkerMain, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex_);
+        isStopping_ = true;
+    }
+    jobCondition_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t chunkSize, const ChunkFunction& function)
+{
+    size_t chunkCount = GetChunkCount(count, chunkSize);
+    if (chunkCount == 0) {
+        return;
+    }
+
+    // ワーカーが1つか、チャンクが1つならそのまま処理する
+    if (workerCount_ == 1 || chunkCount == 1) {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            function(chunk, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize), 0);
+        }
+        return;
+    }
+
+    function_ = &function;
+    count_ = count;
+    chunkSize_ = chunkSize;
+    remainingChunkCount_.store(chunkCount);
+
+    // チャンクを連続した範囲で均等に割り当てる
+    for (uint32_t i = 0; i < workerCount_; ++i) {
+        std::lock_guard<std::mutex> lock(queues_[i].mutex);
+        queues_[i].beginChunk = chunkCount * i / workerCount_;
+        queues_[i].endChunk = chunkCount * (i + 1) / workerCount_;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex_);
+        busyWorkerCount_.store(workerCount_ - 1);
+        ++jobGeneration_;
+    }
+    jobCondition_.notify_all();
+
+    RunChunks(0);
+
+    // 他のワーカーが処理中のチャンクと、ワーカーが待機に戻るのを待つ
+    while (remainingChunkCount_.load() > 0 || busyWorkerCount_.load() > 0) {
+        std::this_thread::yield();
+    }
+    function_ = nullptr;
+}
+
+void ThreadPool::WorkerMain(uint32_t workerIndex)
+{
+    uint64_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(jobMutex_);
+            jobCondition_.wait(lock, [&]() { return isStopping_ || jobGeneration_ != generation; });
+            if (isStopping_) {
+                return;
+            }
+            generation = jobGeneration_;
+        }
+
+        RunChunks(workerIndex);
+        busyWorkerCount_.fetch_sub(1);
+    }
+}
+
+void ThreadPool::RunChunks(uint32_t workerIndex)
+{
+    while (remainingChunkCount_.load() > 0) {
+        size_t chunk;
+        if (!PopChunk(workerIndex, chunk)) {
+            if (!StealChunks(workerIndex)) {
+                // 残りはすべて他のワーカーが処理中
+                return;
+            }
+            continue;
+        }
+
+        (*function_)(chunk, chunk * chunkSize_, std::min(count_, (chunk + 1) * chunkSize_), workerIndex);
+        remainingChunkCount_.fetch_sub(1);
+    }
+}
+
+bool ThreadPool::PopChunk(uint32_t workerIndex, size_t& chunkIndex)
+{
+    WorkQueue& queue = queues_[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.beginChunk == queue.endChunk) {
+        return false;
+    }
+    chunkIndex = queue.beginChunk++;
+    return true;
+}
+
+bool ThreadPool::StealChunks(uint32_t workerIndex)
+{
+    // 隣のワーカーから順に、残りが最も多いワーカーを探す
+    uint32_t victimIndex = workerIndex;
+    size_t victimChunkCount = 0;
+    for (uint32_t offset = 1; offset < workerCount_; ++offset) {
+        uint32_t index = (workerIndex + offset) % workerCount_;
+        std::lock_guard<std::mutex> lock(queues_[index].mutex);
+        size_t chunkCount = queues_[index].endChunk - queues_[index].beginChunk;
+        if (chunkCount > victimChunkCount) {
+            victimIndex = index;
+            victimChunkCount = chunkCount;
+        }
+    }
+    if (victimChunkCount == 0) {
+        return false;
+    }
+
+    // 後ろ半分(1つなら1つ)を自分の範囲にする。探してから減っていれば探し直す
+    size_t beginChunk;
+    size_t endChunk;
+    {
+        WorkQueue& victim = queues_[victimIndex];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        size_t chunkCount = victim.endChunk - victim.beginChunk;
+        if (chunkCount == 0) {
+            return true;
+        }
+        endChunk = victim.endChunk;
+        beginChunk = endChunk - (chunkCount + 1) / 2;
+        victim.endChunk = beginChunk;
+    }
+
+    WorkQueue& queue = queues_[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.beginChunk = beginChunk;
+    queue.endChunk = endChunk;
+    return true;
+}
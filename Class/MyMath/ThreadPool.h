@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ワークスティーリング方式のスレッドプール
+/// ParallelFor の範囲をチャンクに分けて各ワーカーに均等に割り当て、
+/// 自分の分が無くなったワーカーは他のワーカーの残りの後ろ半分を盗んで処理する
+/// (判定の重さがチャンクごとに偏っても、先に終わったワーカーが遊ばない)
+/// 呼び出したスレッドもワーカー0として処理に加わる
+/// </summary>
+class ThreadPool {
+public:
+    /// <summary>
+    /// チャンクを処理する関数
+    /// </summary>
+    /// <param name="chunkIndex">チャンクの番号(0 ~ チャンク数 - 1)</param>
+    /// <param name="begin">チャンクの最初の添字</param>
+    /// <param name="end">チャンクの最後の次の添字</param>
+    /// <param name="workerIndex">処理しているワーカーの番号(0 ~ GetWorkerCount() - 1)</param>
+    using ChunkFunction = std::function<void(size_t chunkIndex, size_t begin, size_t end, uint32_t workerIndex)>;
+
+    /// <summary>
+    /// ワーカーのスレッドを起動する
+    /// </summary>
+    /// <param name="workerCount">呼び出し元を含むワーカーの数(0ならハードウェアのスレッド数)</param>
+    explicit ThreadPool(uint32_t workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// <summary>
+    /// [0, count) を chunkSize ずつのチャンクに分けて並列に処理し、すべて終わるまで待つ
+    /// </summary>
+    /// <param name="count">要素数</param>
+    /// <param name="chunkSize">1チャンクの要素数</param>
+    /// <param name="function">チャンクを処理する関数(複数のスレッドから同時に呼ばれる)</param>
+    void ParallelFor(size_t count, size_t chunkSize, const ChunkFunction& function);
+
+    // 呼び出し元を含むワーカーの数
+    uint32_t GetWorkerCount() const { return workerCount_; }
+
+    // count 個を chunkSize ずつに分けたときのチャンク数
+    static size_t GetChunkCount(size_t count, size_t chunkSize) { return (count + chunkSize - 1) / chunkSize; }
+
+private:
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4324) // alignas で詰め物が入ったことの警告
+#endif
+    // ワーカーごとの未処理のチャンクの範囲(前から自分で取り、後ろから盗まれる)
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        size_t beginChunk = 0;
+        size_t endChunk = 0;
+    };
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+    void WorkerMain(uint32_t workerIndex);
+    // 自分の分と盗んだ分を、残りのチャンクが無くなるまで処理する
+    void RunChunks(uint32_t workerIndex);
+    bool PopChunk(uint32_t workerIndex, size_t& chunkIndex);
+    bool StealChunks(uint32_t workerIndex);
+
+    uint32_t workerCount_ = 1;
+    std::vector<std::thread> threads_;
+    std::unique_ptr<WorkQueue[]> queues_;
+
+    std::mutex jobMutex_;
+    std::condition_variable jobCondition_;
+    uint64_t jobGeneration_ = 0; //!< ParallelFor のたびに増やして、待機中のワーカーを起こす
+    bool isStopping_ = false;
+
+    // 実行中の処理
+    const ChunkFunction* function_ = nullptr;
+    size_t count_ = 0;
+    size_t chunkSize_ = 1;
+    std::atomic<size_t> remainingChunkCount_ = 0;
+    std::atomic<uint32_t> busyWorkerCount_ = 0; //!< 呼び出し元以外で処理中のワーカーの数
+};
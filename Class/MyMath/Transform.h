@@ -0,0 +1,79 @@
+#pragma once
+
+#include "MyMath.h"
+
+/// <summary>
+/// 拡大縮小・回転・平行移動(この順に適用する)
+/// 4x4行列を作らずに合成・補間できる。回転は長さ1のクォータニオン
+/// </summary>
+struct Transform {
+    Vector3 scale; //!< 拡大縮小
+    Quaternion rotate; //!< 回転
+    Vector3 translate; //!< 平行移動
+};
+
+// 変換なし
+constexpr Transform IdentityTransform()
+{
+    return { { 1.0f, 1.0f, 1.0f }, IdentityQuaternion(), { 0.0f, 0.0f, 0.0f } };
+}
+
+// オイラー角から作成(makeAffineMatrix と同じ回転順)
+inline Transform MakeTransform(const Vector3& scale, const Vector3& rotate, const Vector3& translate)
+{
+    return { scale, MakeRotateQuaternion(rotate), translate };
+}
+
+// 座標変換
+constexpr Vector3 TransformCoord(const Vector3& vector, const Transform& transform)
+{
+    Vector3 scaled = { vector.x * transform.scale.x, vector.y * transform.scale.y, vector.z * transform.scale.z };
+    return RotateVector(scaled, transform.rotate) + transform.translate;
+}
+
+/// <summary>
+/// 合成(local を適用したあとに parent を適用する。行列の Multiply(local, parent) と同じ順)
+/// 親の拡大縮小が均一でない場合、子の回転と組み合わさったせん断は表現できない
+/// </summary>
+constexpr Transform Multiply(const Transform& local, const Transform& parent)
+{
+    return {
+        { local.scale.x * parent.scale.x, local.scale.y * parent.scale.y, local.scale.z * parent.scale.z },
+        parent.rotate * local.rotate,
+        TransformCoord(local.translate, parent)
+    };
+}
+
+/// <summary>
+/// 逆変換(拡大縮小が均一な場合に正確)
+/// </summary>
+inline Transform Inverse(const Transform& transform)
+{
+    assert(transform.scale.x != 0.0f && transform.scale.y != 0.0f && transform.scale.z != 0.0f);
+
+    Vector3 inverseScale = { 1.0f / transform.scale.x, 1.0f / transform.scale.y, 1.0f / transform.scale.z };
+    Quaternion inverseRotate = Conjugate(transform.rotate);
+    Vector3 rotated = RotateVector(transform.translate, inverseRotate);
+
+    return {
+        inverseScale,
+        inverseRotate,
+        { -rotated.x * inverseScale.x, -rotated.y * inverseScale.y, -rotated.z * inverseScale.z }
+    };
+}
+
+// 補間(拡大縮小と平行移動は線形補間、回転は球面線形補間)
+inline Transform Lerp(const Transform& transform1, const Transform& transform2, float t)
+{
+    return {
+        Lerp(transform1.scale, transform2.scale, t),
+        Slerp(transform1.rotate, transform2.rotate, t),
+        Lerp(transform1.translate, transform2.translate, t)
+    };
+}
+
+// 行列への変換(描画など行列が必要な場所で1回だけ作る)
+constexpr Matrix4x4 MakeAffineMatrix(const Transform& transform)
+{
+    return MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+}
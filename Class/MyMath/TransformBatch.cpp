@@ -0,0 +1,149 @@
+#include "TransformBatch.h"
+#include "SimdLane.h"
+#include <assert.h>
+
+namespace {
+
+// 1点分の変換(端数処理用)
+template <bool kIsAffine>
+inline void TransformPoint(float x, float y, float z, const Matrix4x4& matrix, float& outX, float& outY, float& outZ)
+{
+    float rx = x * matrix.m[0][0] + y * matrix.m[1][0] + z * matrix.m[2][0] + matrix.m[3][0];
+    float ry = x * matrix.m[0][1] + y * matrix.m[1][1] + z * matrix.m[2][1] + matrix.m[3][1];
+    float rz = x * matrix.m[0][2] + y * matrix.m[1][2] + z * matrix.m[2][2] + matrix.m[3][2];
+
+    if constexpr (!kIsAffine) {
+        float w = x * matrix.m[0][3] + y * matrix.m[1][3] + z * matrix.m[2][3] + matrix.m[3][3];
+        float invW = 1.0f / w;
+        rx *= invW;
+        ry *= invW;
+        rz *= invW;
+    }
+
+    outX = rx;
+    outY = ry;
+    outZ = rz;
+}
+
+#if MYMATH_SIMD_LEVEL >= 1
+
+// 行列の各要素を4レーンに展開したもの
+struct MatrixLanes {
+    __m128 m[4][4];
+
+    explicit MatrixLanes(const Matrix4x4& matrix)
+    {
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                m[row][column] = _mm_set1_ps(matrix.m[row][column]);
+            }
+        }
+    }
+};
+
+// 4点分の変換(SoA形式のレジスタ)
+template <bool kIsAffine>
+inline void TransformPoint4(__m128& x, __m128& y, __m128& z, const MatrixLanes& lanes)
+{
+    // TransformCoord と同じ順序で加算する
+    __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, lanes.m[0][0]), _mm_mul_ps(y, lanes.m[1][0])), _mm_mul_ps(z, lanes.m[2][0])), lanes.m[3][0]);
+    __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, lanes.m[0][1]), _mm_mul_ps(y, lanes.m[1][1])), _mm_mul_ps(z, lanes.m[2][1])), lanes.m[3][1]);
+    __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, lanes.m[0][2]), _mm_mul_ps(y, lanes.m[1][2])), _mm_mul_ps(z, lanes.m[2][2])), lanes.m[3][2]);
+
+    if constexpr (!kIsAffine) {
+        __m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, lanes.m[0][3]), _mm_mul_ps(y, lanes.m[1][3])), _mm_mul_ps(z, lanes.m[2][3])), lanes.m[3][3]);
+        __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), w);
+        rx = _mm_mul_ps(rx, invW);
+        ry = _mm_mul_ps(ry, invW);
+        rz = _mm_mul_ps(rz, invW);
+    }
+
+    x = rx;
+    y = ry;
+    z = rz;
+}
+
+#endif
+
+template <bool kIsAffine>
+void TransformCoordsImpl(const Vector3* input, Vector3* output, size_t count, const Matrix4x4& matrix)
+{
+    size_t i = 0;
+
+#if MYMATH_SIMD_LEVEL >= 1
+    MatrixLanes lanes(matrix);
+
+    // 4点(12要素)ずつ読み込んで SoA に並び替える
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        LoadAoS4(&input[i].x, x, y, z);
+
+        TransformPoint4<kIsAffine>(x, y, z, lanes);
+
+        // AoS に戻して書き込む
+        StoreAoS4(&output[i].x, x, y, z);
+    }
+#endif
+
+    // 端数
+    for (; i < count; ++i) {
+        Vector3 v = input[i];
+        TransformPoint<kIsAffine>(v.x, v.y, v.z, matrix, output[i].x, output[i].y, output[i].z);
+    }
+}
+
+template <bool kIsAffine>
+void TransformCoordsSoAImpl(const float* inX, const float* inY, const float* inZ,
+    float* outX, float* outY, float* outZ, size_t count, const Matrix4x4& matrix)
+{
+    size_t i = 0;
+
+#if MYMATH_SIMD_LEVEL >= 1
+    MatrixLanes lanes(matrix);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(inX + i);
+        __m128 y = _mm_loadu_ps(inY + i);
+        __m128 z = _mm_loadu_ps(inZ + i);
+
+        TransformPoint4<kIsAffine>(x, y, z, lanes);
+
+        _mm_storeu_ps(outX + i, x);
+        _mm_storeu_ps(outY + i, y);
+        _mm_storeu_ps(outZ + i, z);
+    }
+#endif
+
+    // 端数
+    for (; i < count; ++i) {
+        TransformPoint<kIsAffine>(inX[i], inY[i], inZ[i], matrix, outX[i], outY[i], outZ[i]);
+    }
+}
+
+} // namespace
+
+bool IsAffineMatrix(const Matrix4x4& matrix)
+{
+    return IsAffineMatrixSimd(matrix.m);
+}
+
+void TransformCoords(std::span<const Vector3> input, std::span<Vector3> output, const Matrix4x4& matrix)
+{
+    assert(output.size() >= input.size());
+
+    if (IsAffineMatrix(matrix)) {
+        TransformCoordsImpl<true>(input.data(), output.data(), input.size(), matrix);
+    } else {
+        TransformCoordsImpl<false>(input.data(), output.data(), input.size(), matrix);
+    }
+}
+
+void TransformCoordsSoA(const float* inX, const float* inY, const float* inZ,
+    float* outX, float* outY, float* outZ, size_t count, const Matrix4x4& matrix)
+{
+    if (IsAffineMatrix(matrix)) {
+        TransformCoordsSoAImpl<true>(inX, inY, inZ, outX, outY, outZ, count, matrix);
+    } else {
+        TransformCoordsSoAImpl<false>(inX, inY, inZ, outX, outY, outZ, count, matrix);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "MyMath.h"
+#include <cstddef>
+#include <span>
+
+/// <summary>
+/// アフィン行列か(4列目が (0, 0, 0, 1) で w による除算が不要)
+/// </summary>
+/// <param name="matrix">判定する行列</param>
+/// <returns>アフィン行列なら true</returns>
+bool IsAffineMatrix(const Matrix4x4& matrix);
+
+/// <summary>
+/// 座標変換(一括)
+/// TransformCoord と同じ変換を配列全体に行う
+/// アフィン行列なら除算を省略し、射影行列なら1点につき1回の逆数計算で済ませる
+/// </summary>
+/// <param name="input">変換する座標の配列</param>
+/// <param name="output">出力先(input と同じ配列でも良い。要素数は input 以上)</param>
+/// <param name="matrix">変換行列</param>
+void TransformCoords(std::span<const Vector3> input, std::span<Vector3> output, const Matrix4x4& matrix);
+
+/// <summary>
+/// 座標変換(一括・SoA形式)
+/// x, y, z を別々の配列で持つバッファ用
+/// </summary>
+/// <param name="inX">入力のx成分</param>
+/// <param name="inY">入力のy成分</param>
+/// <param name="inZ">入力のz成分</param>
+/// <param name="outX">出力のx成分(入力と同じ配列でも良い)</param>
+/// <param name="outY">出力のy成分(入力と同じ配列でも良い)</param>
+/// <param name="outZ">出力のz成分(入力と同じ配列でも良い)</param>
+/// <param name="count">要素数</param>
+/// <param name="matrix">変換行列</param>
+void TransformCoordsSoA(const float* inX, const float* inY, const float* inZ,
+    float* outX, float* outY, float* outZ, size_t count, const Matrix4x4& matrix);
@@ -0,0 +1,252 @@
+#include "TriangleBVH.h"
+#include "SegmentPacket.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// SAH で試す分割位置の数(重心の範囲を等分する)
+const int kBinCount = 16;
+// これ以下の数なら、分割しても得にならない場合に葉にする
+const uint32_t kMaxLeafTriangleCount = 8;
+// ノードを1つたどるコスト(三角形1つの判定を1とした比)
+const float kTraversalCost = 1.0f;
+// 走査スタックの深さ(これより深くは分割しない)
+const int kMaxDepth = 64;
+
+const float kInfinity = std::numeric_limits<float>::infinity();
+
+// 三角形の3頂点で広げる(判定と同じく前計算した辺から頂点を求める)
+void GrowTriangle(AABB& aabb, const PreparedTriangle& triangle)
+{
+    aabb = Combine(aabb, triangle.vertex0);
+    aabb = Combine(aabb, triangle.vertex0 + triangle.edge1);
+    aabb = Combine(aabb, triangle.vertex0 + triangle.edge2);
+}
+
+} // namespace
+
+void TriangleBVH::Build(std::span<const Triangle> triangles)
+{
+    triangles_.resize(triangles.size());
+    MakePreparedTriangles(triangles, triangles_);
+    triangleIndices_.resize(triangles.size());
+    std::vector<Vector3> centroids(triangles.size());
+    for (uint32_t i = 0; i < triangles.size(); ++i) {
+        triangleIndices_[i] = i;
+        centroids[i] = (triangles[i].vertices[0] + triangles[i].vertices[1] + triangles[i].vertices[2]) * (1.0f / 3.0f);
+    }
+
+    // ノードは最大で 2n - 1 個(子を2つずつ確保するので途中で配列が伸びないようにしておく)
+    nodes_.clear();
+    if (triangles.empty()) {
+        return;
+    }
+    nodes_.reserve(triangles.size() * 2);
+
+    nodes_.push_back({});
+    nodes_[0].firstIndex = 0;
+    nodes_[0].triangleCount = static_cast<uint32_t>(triangles.size());
+    UpdateNodeBounds(0);
+    Subdivide(0, centroids, 1);
+}
+
+bool TriangleBVH::FindFirstHit(const Segment& segment, TriangleHit& hit) const
+{
+    return Traverse<false>(segment, hit);
+}
+
+bool TriangleBVH::FindAnyHit(const Segment& segment, TriangleHit& hit) const
+{
+    return Traverse<true>(segment, hit);
+}
+
+template <bool kAnyHit>
+bool TriangleBVH::Traverse(const Segment& segment, TriangleHit& hit) const
+{
+    if (nodes_.empty()) {
+        return false;
+    }
+
+    PreparedSegment preparedSegment = MakePreparedSegment(segment);
+    float maxT = 1.0f;
+    bool found = false;
+
+    if (SegmentEnterT(preparedSegment, nodes_[0].min, nodes_[0].max, maxT) == kInfinity) {
+        return false;
+    }
+
+    // 遠い方の子と、そこに入る t
+    std::pair<uint32_t, float> stack[kMaxDepth];
+    int stackSize = 0;
+    uint32_t nodeIndex = 0;
+
+    while (true) {
+        const Node& node = nodes_[nodeIndex];
+
+        if (node.triangleCount > 0) {
+            for (uint32_t i = node.firstIndex; i < node.firstIndex + node.triangleCount; ++i) {
+                TriangleIntersection intersection;
+                if (IntersectSegment(triangles_[i], segment, intersection, maxT)) {
+                    hit = { triangleIndices_[i], intersection.t };
+                    found = true;
+                    if constexpr (kAnyHit) {
+                        return true;
+                    }
+                    maxT = intersection.t;
+                }
+            }
+        } else {
+            // 近い方の子から調べる
+            uint32_t nearIndex = node.firstIndex;
+            uint32_t farIndex = node.firstIndex + 1;
+            float nearT = SegmentEnterT(preparedSegment, nodes_[nearIndex].min, nodes_[nearIndex].max, maxT);
+            float farT = SegmentEnterT(preparedSegment, nodes_[farIndex].min, nodes_[farIndex].max, maxT);
+            if (farT < nearT) {
+                std::swap(nearIndex, farIndex);
+                std::swap(nearT, farT);
+            }
+
+            if (nearT != kInfinity) {
+                if (farT != kInfinity) {
+                    stack[stackSize++] = { farIndex, farT };
+                }
+                nodeIndex = nearIndex;
+                continue;
+            }
+        }
+
+        // 残っているノードのうち、今の最近点より手前に入るもの
+        do {
+            if (stackSize == 0) {
+                return found;
+            }
+            --stackSize;
+        } while (stack[stackSize].second > maxT);
+        nodeIndex = stack[stackSize].first;
+    }
+}
+
+void TriangleBVH::UpdateNodeBounds(uint32_t nodeIndex)
+{
+    Node& node = nodes_[nodeIndex];
+    AABB bounds = MakeEmptyAABB();
+    for (uint32_t i = node.firstIndex; i < node.firstIndex + node.triangleCount; ++i) {
+        GrowTriangle(bounds, triangles_[i]);
+    }
+    node.min = bounds.min;
+    node.max = bounds.max;
+}
+
+void TriangleBVH::Subdivide(uint32_t nodeIndex, std::vector<Vector3>& centroids, int depth)
+{
+    uint32_t first = nodes_[nodeIndex].firstIndex;
+    uint32_t count = nodes_[nodeIndex].triangleCount;
+    if (count <= 1 || depth >= kMaxDepth) {
+        return;
+    }
+
+    // 重心の範囲
+    AABB centroidBounds = MakeEmptyAABB();
+    for (uint32_t i = first; i < first + count; ++i) {
+        centroidBounds = Combine(centroidBounds, centroids[i]);
+    }
+
+    // 各軸で等分した位置を試し、SAH のコストが最小になる分割を探す
+    float bestCost = kInfinity;
+    int bestAxis = -1;
+    int bestSplit = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        float boundsMin = AxisValue(centroidBounds.min, axis);
+        float extent = AxisValue(centroidBounds.max, axis) - boundsMin;
+        if (extent <= 0.0f) {
+            continue;
+        }
+
+        AABB binBounds[kBinCount];
+        uint32_t binCounts[kBinCount] = {};
+        for (AABB& bounds : binBounds) {
+            bounds = MakeEmptyAABB();
+        }
+
+        float scale = static_cast<float>(kBinCount) / extent;
+        for (uint32_t i = first; i < first + count; ++i) {
+            int bin = std::min(kBinCount - 1, static_cast<int>((AxisValue(centroids[i], axis) - boundsMin) * scale));
+            ++binCounts[bin];
+            GrowTriangle(binBounds[bin], triangles_[i]);
+        }
+
+        // 左から・右から累積した表面積と数
+        float leftAreas[kBinCount - 1];
+        uint32_t leftCounts[kBinCount - 1];
+        AABB leftBounds = MakeEmptyAABB();
+        uint32_t leftCount = 0;
+        for (int i = 0; i < kBinCount - 1; ++i) {
+            leftBounds = Combine(leftBounds, binBounds[i]);
+            leftCount += binCounts[i];
+            leftAreas[i] = HalfSurfaceArea(leftBounds);
+            leftCounts[i] = leftCount;
+        }
+
+        AABB rightBounds = MakeEmptyAABB();
+        uint32_t rightCount = 0;
+        for (int i = kBinCount - 1; i > 0; --i) {
+            rightBounds = Combine(rightBounds, binBounds[i]);
+            rightCount += binCounts[i];
+            float cost = leftAreas[i - 1] * static_cast<float>(leftCounts[i - 1]) + HalfSurfaceArea(rightBounds) * static_cast<float>(rightCount);
+            if (leftCounts[i - 1] > 0 && rightCount > 0 && cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i;
+            }
+        }
+    }
+
+    Node& node = nodes_[nodeIndex];
+    AABB nodeBounds = { node.min, node.max };
+    float parentArea = HalfSurfaceArea(nodeBounds);
+    float splitCost = parentArea > 0.0f ? kTraversalCost + bestCost / parentArea : kInfinity;
+    float leafCost = static_cast<float>(count);
+
+    uint32_t leftCount;
+    if (bestAxis >= 0 && (splitCost < leafCost || count > kMaxLeafTriangleCount)) {
+        // 分割位置より左の三角形を前に集める
+        float boundsMin = AxisValue(centroidBounds.min, bestAxis);
+        float scale = static_cast<float>(kBinCount) / (AxisValue(centroidBounds.max, bestAxis) - boundsMin);
+        uint32_t i = first;
+        uint32_t j = first + count;
+        while (i < j) {
+            int bin = std::min(kBinCount - 1, static_cast<int>((AxisValue(centroids[i], bestAxis) - boundsMin) * scale));
+            if (bin < bestSplit) {
+                ++i;
+            } else {
+                --j;
+                std::swap(triangles_[i], triangles_[j]);
+                std::swap(triangleIndices_[i], triangleIndices_[j]);
+                std::swap(centroids[i], centroids[j]);
+            }
+        }
+        leftCount = i - first;
+    } else if (count > kMaxLeafTriangleCount) {
+        // 重心がすべて同じ位置にある場合は半分に分ける
+        leftCount = count / 2;
+    } else {
+        return;
+    }
+
+    uint32_t leftIndex = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({});
+    nodes_.push_back({});
+    nodes_[leftIndex].firstIndex = first;
+    nodes_[leftIndex].triangleCount = leftCount;
+    nodes_[leftIndex + 1].firstIndex = first + leftCount;
+    nodes_[leftIndex + 1].triangleCount = count - leftCount;
+    nodes_[nodeIndex].firstIndex = leftIndex;
+    nodes_[nodeIndex].triangleCount = 0;
+
+    UpdateNodeBounds(leftIndex);
+    UpdateNodeBounds(leftIndex + 1);
+    Subdivide(leftIndex, centroids, depth + 1);
+    Subdivide(leftIndex + 1, centroids, depth + 1);
+}
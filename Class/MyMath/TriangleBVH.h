@@ -0,0 +1,70 @@
+#pragma once
+
+#include "AlignedAllocator.h"
+#include "MyMath.h"
+#include "PreparedTriangle.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 線分と三角形の交差結果
+/// </summary>
+struct TriangleHit {
+    uint32_t triangleIndex; //!< Build に渡した配列での添字
+    float t; //!< 交点の線分上の位置(origin + diff * t)
+};
+
+/// <summary>
+/// 静的な三角形メッシュのBVH(線分の交差判定用)
+/// 表面積ヒューリスティック(SAH)で分割し、ノードは32バイトの配列に詰めて並べる
+/// 三角形は前計算した形(PreparedTriangle)で葉の順に並べ替えて持つので、葉の判定はメモリを連続して読む
+/// </summary>
+class TriangleBVH {
+public:
+    /// <summary>
+    /// 三角形の配列から構築する
+    /// </summary>
+    void Build(std::span<const Triangle> triangles);
+
+    /// <summary>
+    /// 線分と最初に交わる(t が最小の)三角形を求める
+    /// </summary>
+    /// <param name="segment">線分(t が 0 ~ 1 の範囲)</param>
+    /// <param name="hit">交わった三角形と t</param>
+    /// <returns>交わる三角形があれば true</returns>
+    bool FindFirstHit(const Segment& segment, TriangleHit& hit) const;
+
+    /// <summary>
+    /// 線分と交わる三角形があるか(見つかった時点で打ち切る。遮蔽判定用)
+    /// </summary>
+    /// <param name="segment">線分(t が 0 ~ 1 の範囲)</param>
+    /// <param name="hit">見つかった三角形と t(最初に交わるものとは限らない)</param>
+    /// <returns>交わる三角形があれば true</returns>
+    bool FindAnyHit(const Segment& segment, TriangleHit& hit) const;
+
+    // 三角形の数
+    size_t GetTriangleCount() const { return triangles_.size(); }
+
+    // ノードの数
+    size_t GetNodeCount() const { return nodes_.size(); }
+
+private:
+    // 32バイトのノード。内部ノードの子は firstIndex と firstIndex + 1 に並べる
+    struct Node {
+        Vector3 min;
+        uint32_t firstIndex; //!< 内部ノードなら左の子、葉なら最初の三角形
+        Vector3 max;
+        uint32_t triangleCount; //!< 葉の三角形の数(内部ノードなら0)
+    };
+
+    template <bool kAnyHit>
+    bool Traverse(const Segment& segment, TriangleHit& hit) const;
+
+    void UpdateNodeBounds(uint32_t nodeIndex);
+    void Subdivide(uint32_t nodeIndex, std::vector<Vector3>& centroids, int depth);
+
+    AlignedVector<Node> nodes_;
+    std::vector<PreparedTriangle> triangles_; //!< 葉の順に並べ替えた三角形
+    std::vector<uint32_t> triangleIndices_; //!< 並べ替え後の三角形の元の添字
+};
@@ -11,25 +11,25 @@ struct Vector3 {
     //========================================
 
     // ベクトル加算(Vector3 + Vector3)
-    Vector3 operator+(const Vector3& v) const
+    constexpr Vector3 operator+(const Vector3& v) const
     {
         return { x + v.x, y + v.y, z + v.z };
     }
 
     // ベクトル減算(Vector3 - Vector3)
-    Vector3 operator-(const Vector3& v) const
+    constexpr Vector3 operator-(const Vector3& v) const
     {
         return { x - v.x, y - v.y, z - v.z };
     }
 
     // スカラー乗算(Vector3 * float)
-    Vector3 operator*(float scalar) const
+    constexpr Vector3 operator*(float scalar) const
     {
         return { x * scalar, y * scalar, z * scalar };
     }
 
     // ベクトル除算(Vector3 / float)
-    Vector3 operator/(float scalar) const
+    constexpr Vector3 operator/(float scalar) const
     {
         return { x / scalar, y / scalar, z / scalar };
     }
@@ -39,7 +39,7 @@ struct Vector3 {
     //========================================
 
     // ベクトル加算(Vector3 += Vector3)
-    Vector3& operator+=(const Vector3& v)
+    constexpr Vector3& operator+=(const Vector3& v)
     {
         x += v.x;
         y += v.y;
@@ -48,7 +48,7 @@ struct Vector3 {
     }
 
     // ベクトル減算(Vector3 -= Vector3)
-    Vector3& operator-=(const Vector3& v)
+    constexpr Vector3& operator-=(const Vector3& v)
     {
         x -= v.x;
         y -= v.y;
@@ -57,7 +57,7 @@ struct Vector3 {
     }
 
     // スカラー乗算(Vector3 *= float)
-    Vector3& operator*=(float scalar)
+    constexpr Vector3& operator*=(float scalar)
     {
         x *= scalar;
         y *= scalar;
@@ -66,7 +66,7 @@ struct Vector3 {
     }
 
     // ベクトル除算
-    Vector3& operator/=(float scalar)
+    constexpr Vector3& operator/=(float scalar)
     {
         x /= scalar;
         y /= scalar;
@@ -76,7 +76,7 @@ struct Vector3 {
 };
 
 // スカラーとベクトルの乗算 (float * Vector3)
-inline Vector3 operator*(float scalar, const Vector3& v)
+constexpr Vector3 operator*(float scalar, const Vector3& v)
 {
     return { scalar * v.x, scalar * v.y, scalar * v.z };
 }
@@ -85,12 +85,12 @@ inline Vector3 operator*(float scalar, const Vector3& v)
 // 　単項演算子
 //========================================
 
-inline Vector3 operator-(const Vector3& v)
+constexpr Vector3 operator-(const Vector3& v)
 {
     return { -v.x, -v.y, -v.z };
 }
 
-inline Vector3 operator+(const Vector3& v)
+constexpr Vector3 operator+(const Vector3& v)
 {
     return v; // 単項プラスは値をそのまま返す
 }
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "Vector3SoA.h"
+#include "../SimdLane.h"
+#include <assert.h>
+#include <cmath>
+
+namespace {
+
+// 出力先の要素数を入力に合わせる(入力と同じ配列なら何もしない)
+void ResizeOutput(Vector3SoA& out, size_t count)
+{
+    if (out.Size() != count) {
+        out.Resize(count);
+    }
+}
+
+} // namespace
+
+void Vector3SoA::FromAoS(std::span<const Vector3> vectors)
+{
+    Resize(vectors.size());
+
+    size_t count = vectors.size();
+    size_t i = 0;
+
+#if MYMATH_SIMD_LEVEL >= 1
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx, vy, vz;
+        LoadAoS4(&vectors[i].x, vx, vy, vz);
+        _mm_storeu_ps(x.data() + i, vx);
+        _mm_storeu_ps(y.data() + i, vy);
+        _mm_storeu_ps(z.data() + i, vz);
+    }
+#endif
+
+    // 端数
+    for (; i < count; ++i) {
+        Set(i, vectors[i]);
+    }
+}
+
+void Vector3SoA::ToAoS(std::span<Vector3> vectors) const
+{
+    assert(vectors.size() >= Size());
+
+    size_t count = Size();
+    size_t i = 0;
+
+#if MYMATH_SIMD_LEVEL >= 1
+    for (; i + 4 <= count; i += 4) {
+        StoreAoS4(&vectors[i].x, _mm_loadu_ps(x.data() + i), _mm_loadu_ps(y.data() + i), _mm_loadu_ps(z.data() + i));
+    }
+#endif
+
+    // 端数
+    for (; i < count; ++i) {
+        vectors[i] = Get(i);
+    }
+}
+
+void Add(const Vector3SoA& v1, const Vector3SoA& v2, Vector3SoA& out)
+{
+    assert(v1.Size() == v2.Size());
+
+    size_t count = v1.Size();
+    ResizeOutput(out, count);
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        LaneStore(&out.x[i], LaneAdd(LaneLoad(&v1.x[i]), LaneLoad(&v2.x[i])));
+        LaneStore(&out.y[i], LaneAdd(LaneLoad(&v1.y[i]), LaneLoad(&v2.y[i])));
+        LaneStore(&out.z[i], LaneAdd(LaneLoad(&v1.z[i]), LaneLoad(&v2.z[i])));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        out.x[i] = v1.x[i] + v2.x[i];
+        out.y[i] = v1.y[i] + v2.y[i];
+        out.z[i] = v1.z[i] + v2.z[i];
+    }
+}
+
+void Subtract(const Vector3SoA& v1, const Vector3SoA& v2, Vector3SoA& out)
+{
+    assert(v1.Size() == v2.Size());
+
+    size_t count = v1.Size();
+    ResizeOutput(out, count);
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        LaneStore(&out.x[i], LaneSub(LaneLoad(&v1.x[i]), LaneLoad(&v2.x[i])));
+        LaneStore(&out.y[i], LaneSub(LaneLoad(&v1.y[i]), LaneLoad(&v2.y[i])));
+        LaneStore(&out.z[i], LaneSub(LaneLoad(&v1.z[i]), LaneLoad(&v2.z[i])));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        out.x[i] = v1.x[i] - v2.x[i];
+        out.y[i] = v1.y[i] - v2.y[i];
+        out.z[i] = v1.z[i] - v2.z[i];
+    }
+}
+
+void Multiply(float scalar, const Vector3SoA& v, Vector3SoA& out)
+{
+    size_t count = v.Size();
+    ResizeOutput(out, count);
+
+    FloatLane s = LaneSet(scalar);
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        LaneStore(&out.x[i], LaneMul(LaneLoad(&v.x[i]), s));
+        LaneStore(&out.y[i], LaneMul(LaneLoad(&v.y[i]), s));
+        LaneStore(&out.z[i], LaneMul(LaneLoad(&v.z[i]), s));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        out.x[i] = v.x[i] * scalar;
+        out.y[i] = v.y[i] * scalar;
+        out.z[i] = v.z[i] * scalar;
+    }
+}
+
+void Dot(const Vector3SoA& v1, const Vector3SoA& v2, std::span<float> out)
+{
+    assert(v1.Size() == v2.Size());
+    assert(out.size() >= v1.Size());
+
+    size_t count = v1.Size();
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        FloatLane xx = LaneMul(LaneLoad(&v1.x[i]), LaneLoad(&v2.x[i]));
+        FloatLane yy = LaneMul(LaneLoad(&v1.y[i]), LaneLoad(&v2.y[i]));
+        FloatLane zz = LaneMul(LaneLoad(&v1.z[i]), LaneLoad(&v2.z[i]));
+        LaneStore(&out[i], LaneAdd(LaneAdd(xx, yy), zz));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        out[i] = v1.x[i] * v2.x[i] + v1.y[i] * v2.y[i] + v1.z[i] * v2.z[i];
+    }
+}
+
+void Length(const Vector3SoA& v, std::span<float> out)
+{
+    assert(out.size() >= v.Size());
+
+    size_t count = v.Size();
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        FloatLane x = LaneLoad(&v.x[i]);
+        FloatLane y = LaneLoad(&v.y[i]);
+        FloatLane z = LaneLoad(&v.z[i]);
+        LaneStore(&out[i], LaneSqrt(LaneAdd(LaneAdd(LaneMul(x, x), LaneMul(y, y)), LaneMul(z, z))));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        out[i] = std::sqrt(v.x[i] * v.x[i] + v.y[i] * v.y[i] + v.z[i] * v.z[i]);
+    }
+}
+
+void Normalize(const Vector3SoA& v, Vector3SoA& out)
+{
+    size_t count = v.Size();
+    ResizeOutput(out, count);
+
+    FloatLane zero = LaneSet(0.0f);
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        FloatLane x = LaneLoad(&v.x[i]);
+        FloatLane y = LaneLoad(&v.y[i]);
+        FloatLane z = LaneLoad(&v.z[i]);
+        FloatLane length = LaneSqrt(LaneAdd(LaneAdd(LaneMul(x, x), LaneMul(y, y)), LaneMul(z, z)));
+
+        // 長さ0のレーンは除算結果を捨てて0にする
+        LaneMask isValid = LaneNotEqual(length, zero);
+        LaneStore(&out.x[i], LaneSelect(isValid, LaneDiv(x, length), zero));
+        LaneStore(&out.y[i], LaneSelect(isValid, LaneDiv(y, length), zero));
+        LaneStore(&out.z[i], LaneSelect(isValid, LaneDiv(z, length), zero));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        float x = v.x[i];
+        float y = v.y[i];
+        float z = v.z[i];
+        float length = std::sqrt(x * x + y * y + z * z);
+
+        if (length != 0.0f) {
+            out.x[i] = x / length;
+            out.y[i] = y / length;
+            out.z[i] = z / length;
+        } else {
+            out.x[i] = 0.0f;
+            out.y[i] = 0.0f;
+            out.z[i] = 0.0f;
+        }
+    }
+}
+
+void Cross(const Vector3SoA& v1, const Vector3SoA& v2, Vector3SoA& out)
+{
+    assert(v1.Size() == v2.Size());
+
+    size_t count = v1.Size();
+    ResizeOutput(out, count);
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        // out が入力と同じ配列でも良いように、全成分を読み込んでから書き込む
+        FloatLane ax = LaneLoad(&v1.x[i]);
+        FloatLane ay = LaneLoad(&v1.y[i]);
+        FloatLane az = LaneLoad(&v1.z[i]);
+        FloatLane bx = LaneLoad(&v2.x[i]);
+        FloatLane by = LaneLoad(&v2.y[i]);
+        FloatLane bz = LaneLoad(&v2.z[i]);
+
+        LaneStore(&out.x[i], LaneSub(LaneMul(ay, bz), LaneMul(az, by)));
+        LaneStore(&out.y[i], LaneSub(LaneMul(az, bx), LaneMul(ax, bz)));
+        LaneStore(&out.z[i], LaneSub(LaneMul(ax, by), LaneMul(ay, bx)));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        Vector3 a = v1.Get(i);
+        Vector3 b = v2.Get(i);
+        out.Set(i, { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x });
+    }
+}
+
+void Lerp(const Vector3SoA& v1, const Vector3SoA& v2, float t, Vector3SoA& out)
+{
+    assert(v1.Size() == v2.Size());
+
+    size_t count = v1.Size();
+    ResizeOutput(out, count);
+
+    FloatLane lt = LaneSet(t);
+
+    size_t i = 0;
+    for (; i + kFloatLaneWidth <= count; i += kFloatLaneWidth) {
+        FloatLane ax = LaneLoad(&v1.x[i]);
+        FloatLane ay = LaneLoad(&v1.y[i]);
+        FloatLane az = LaneLoad(&v1.z[i]);
+        LaneStore(&out.x[i], LaneAdd(ax, LaneMul(LaneSub(LaneLoad(&v2.x[i]), ax), lt)));
+        LaneStore(&out.y[i], LaneAdd(ay, LaneMul(LaneSub(LaneLoad(&v2.y[i]), ay), lt)));
+        LaneStore(&out.z[i], LaneAdd(az, LaneMul(LaneSub(LaneLoad(&v2.z[i]), az), lt)));
+    }
+
+    // 端数
+    for (; i < count; ++i) {
+        out.x[i] = v1.x[i] + (v2.x[i] - v1.x[i]) * t;
+        out.y[i] = v1.y[i] + (v2.y[i] - v1.y[i]) * t;
+        out.z[i] = v1.z[i] + (v2.z[i] - v1.z[i]) * t;
+    }
+}
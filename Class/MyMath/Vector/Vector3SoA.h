@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../AlignedAllocator.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <span>
+
+/// <summary>
+/// ベクトル配列(SoA形式)
+/// x, y, z を成分ごとの配列で持ち、一括処理をSIMDの全レーンで行えるようにする
+/// </summary>
+struct Vector3SoA {
+    AlignedVector<float> x;
+    AlignedVector<float> y;
+    AlignedVector<float> z;
+
+    Vector3SoA() = default;
+    explicit Vector3SoA(size_t count) { Resize(count); }
+    explicit Vector3SoA(std::span<const Vector3> vectors) { FromAoS(vectors); }
+
+    // 要素数
+    size_t Size() const { return x.size(); }
+    bool Empty() const { return x.empty(); }
+
+    // 要素数の変更
+    void Resize(size_t count)
+    {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+    }
+
+    // 容量の確保
+    void Reserve(size_t count)
+    {
+        x.reserve(count);
+        y.reserve(count);
+        z.reserve(count);
+    }
+
+    void Clear()
+    {
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+
+    // 末尾に追加
+    void PushBack(const Vector3& v)
+    {
+        x.push_back(v.x);
+        y.push_back(v.y);
+        z.push_back(v.z);
+    }
+
+    // 要素の取得・設定
+    Vector3 Get(size_t index) const { return { x[index], y[index], z[index] }; }
+    void Set(size_t index, const Vector3& v)
+    {
+        x[index] = v.x;
+        y[index] = v.y;
+        z[index] = v.z;
+    }
+
+    /// <summary>
+    /// AoS形式の配列から読み込む(要素数は vectors に合わせる)
+    /// </summary>
+    void FromAoS(std::span<const Vector3> vectors);
+
+    /// <summary>
+    /// AoS形式の配列へ書き出す
+    /// </summary>
+    /// <param name="vectors">出力先(要素数は Size() 以上)</param>
+    void ToAoS(std::span<Vector3> vectors) const;
+};
+
+//================================================
+// 　一括演算
+//
+// 出力先は入力と同じ配列でも良い(要素数は入力に合わせて変更される)
+//================================================
+
+/// <summary>
+/// ベクトル加算(一括)
+/// </summary>
+void Add(const Vector3SoA& v1, const Vector3SoA& v2, Vector3SoA& out);
+
+/// <summary>
+/// ベクトル減算(一括)
+/// </summary>
+void Subtract(const Vector3SoA& v1, const Vector3SoA& v2, Vector3SoA& out);
+
+/// <summary>
+/// スカラー倍(一括)
+/// </summary>
+void Multiply(float scalar, const Vector3SoA& v, Vector3SoA& out);
+
+/// <summary>
+/// 内積(一括)
+/// </summary>
+/// <param name="out">出力先(要素数は v1 以上)</param>
+void Dot(const Vector3SoA& v1, const Vector3SoA& v2, std::span<float> out);
+
+/// <summary>
+/// 長さ(一括)
+/// </summary>
+/// <param name="out">出力先(要素数は v 以上)</param>
+void Length(const Vector3SoA& v, std::span<float> out);
+
+/// <summary>
+/// 正規化(一括)
+/// 長さ0のベクトルは0ベクトルになる
+/// </summary>
+void Normalize(const Vector3SoA& v, Vector3SoA& out);
+
+/// <summary>
+/// クロス積(一括)
+/// </summary>
+void Cross(const Vector3SoA& v1, const Vector3SoA& v2, Vector3SoA& out);
+
+/// <summary>
+/// 線形補間(一括)
+/// </summary>
+void Lerp(const Vector3SoA& v1, const Vector3SoA& v2, float t, Vector3SoA& out);
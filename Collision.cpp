@@ -4,9 +4,10 @@ bool isCollision(const Sphere& s1, const Sphere& s2)
 {
 
     // 2つの球の中心間のベクトルを求める
-    float distance = Length(s2.center - s1.center);
-    // 2つの球の半径の合計より短ければ衝突
-    if (distance <= s1.radius + s2.radius) {
+    Vector3 diff = s2.center - s1.center;
+    float radiusSum = s1.radius + s2.radius;
+    // 2つの球の半径の合計より短ければ衝突(平方根を避けて2乗で比較する)
+    if (Dot(diff, diff) <= radiusSum * radiusSum) {
         return true;
     }
 
@@ -1,10 +1,16 @@
+#include "Class/Benchmark/MathBenchmark.h"
+#include "Class/MyMath/BallSystem.h"
 #include "Class/MyMath/MyCollision.h"
 #include "Class/MyMath/MyMath.h"
+#include "Class/MyMath/ScreenProjector.h"
 #include <Novice.h>
 #include <imgui.h>
 
 const char kWindowTitle[] = "LE2B_18_タナハラ_コア_タイトル";
 
+// 1フレームで跳ね返りを処理する最大回数
+const int kMaxBounceCount = 4;
+
 /// <summary>
 /// ばね構造体
 /// </summary>
@@ -16,18 +22,6 @@ struct Spring {
     float dampingCoefficient; // 減衰係数
 };
 
-/// <summary>
-/// ボール構造体
-/// </summary>
-struct Ball {
-    Vector3 position; // 位置
-    Vector3 velocity; // 速度
-    Vector3 acceleration; // 加速度
-    float mass; // 質量
-    float radius; // 半径
-    unsigned int color; // 色
-};
-
 struct Pendulum {
     Vector3 anchor; // アンカーポイント。固定された端の位置
     float length; // ひもの長さ
@@ -149,20 +143,17 @@ struct DebugCamera {
 Vector3 perpendicular(const Vector3& vector);
 
 // 平面の描画
-void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionmatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+void DrawPlane(const Plane& plane, const ScreenProjector& projector, uint32_t color);
 
 // 三角形の描画
-void DrawTriangle(const Triangle& triangle, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+void DrawTriangle(const Triangle& triangle, const ScreenProjector& projector, uint32_t color);
 
 // AABBの描画
-void DrawAABB(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
+void DrawAABB(const AABB& aabb, const ScreenProjector& projector, uint32_t color);
 
 // 2次ベジェ曲線の描画
 void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPosint2,
-    const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color);
-
-// 反射ベクトルを求める関数
-Vector3 Reflect(const Vector3& input, const Vector3& normal);
+    const ScreenProjector& projector, uint32_t color);
 
 // Windowsアプリでのエントリーポイント(main関数)
 int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
@@ -185,14 +176,18 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 
     // カメラのワールド行列
     Matrix4x4 cameraWorldMatrix = makeAffineMatrix({ 1.0, 1.0f, 1.0f }, { 0.26f, 0.0f, 0.0f }, { 0.0f, 1.9f, -6.49f });
-    Matrix4x4 viewMatrix = Inverse(cameraWorldMatrix);
-    Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, float(1280) / float(720), 0.1f, 100.0f);
-    Matrix4x4 viewPortMatrix = MakeViewportMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f);
+    Matrix4x4 viewMatrix = Inverse(cameraWorldMatrix, MatrixType::Rigid);
+    // 射影行列とビューポート行列は定数なのでコンパイル時に作成する
+    constexpr Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, float(1280) / float(720), 0.1f, 100.0f);
+    constexpr Matrix4x4 viewPortMatrix = MakeViewportMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f);
     Matrix4x4 viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
 
     // デバッグカメラの初期化
     DebugCamera debugCamera;
 
+    // デバッグ描画のLODで許容する画面上の誤差(ピクセル)
+    float lodPixelError = kDefaultLodPixelError;
+
 #pragma endregion
 
 #pragma region 平面衝突初期化
@@ -208,6 +203,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
     ball.acceleration = { 0.0f, -9.8f, 0.0f }; // 重力加速度
     ball.color = WHITE;
 
+    // ボールは BallSystem でまとめて動かす(ball は開始時の状態として残す)
+    BallSystem ballSystem;
+    ballSystem.Add(ball);
+
     float e = 0.8f; // 反発係数
 
     bool isStarted = false; // シミュレーション開始フラグ
@@ -233,15 +232,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 
         if (isStarted) {
 
-            ball.velocity += ball.acceleration * deltaTime; // 速度更新
-            ball.position += ball.velocity * deltaTime; // 位置更新
-            if (IsCollision(Sphere { ball.position, ball.radius }, plane)) {
-                Vector3 reflected = Reflect(ball.velocity, plane.normal);
-                Vector3 projectToNormal = Project(reflected, plane.normal);
-                Vector3 movingDirection = reflected - projectToNormal;
-                // 反発係数を考慮して速度を更新
-                ball.velocity = projectToNormal * e + movingDirection;
-            }
+            // 速度と位置の更新。移動中に平面と接触する時刻まで進めて跳ね返し、残りの時間を反射後の速度で進める
+            // (移動後の位置だけを調べると、速い球は平面をすり抜ける)
+            ballSystem.Integrate(deltaTime, plane, e, kMaxBounceCount);
         }
 
 #pragma endregion
@@ -254,6 +247,13 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
         viewMatrix = debugCamera.GetViewMatrix();
         viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
 
+        // ワールド→スクリーン変換はフレームに1回だけ合成する
+        ScreenProjector projector(viewProjectionMatrix, viewPortMatrix);
+        projector.maxPixelError = lodPixelError;
+
+        // 視錐台の外にある物体は描画しない
+        Frustum frustum = MakeFrustum(viewProjectionMatrix);
+
 #pragma endregion
 
         ///
@@ -274,9 +274,15 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
         ImGui::Text("Yaw: %.2f", debugCamera.yaw);
 
         // 平面のパラメータを調整
-        ImGui::SliderFloat3("Plane Normal", &plane.normal.x, -1.0f, 1.0f);
+        if (ImGui::SliderFloat3("Plane Normal", &plane.normal.x, -1.0f, 1.0f) && Dot(plane.normal, plane.normal) > 0.0f) {
+            // 衝突判定は正規化済みの法線を前提にするので、変更したときに1度だけ正規化する
+            plane.normal = Normalize(plane.normal);
+        }
         ImGui::SliderFloat("Plane Distance", &plane.distance, -5.0f, 5.0f);
 
+        // デバッグ描画のLOD(許容する画面上の誤差)
+        ImGui::SliderFloat("LOD Pixel Error", &lodPixelError, 0.1f, 8.0f);
+
         // カメラのリセットボタン
         if (ImGui::Button("Reset Camera")) {
             debugCamera.Reset();
@@ -286,24 +292,29 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
         if (ImGui::Button("Start Simulation")) {
             isStarted = true;
 
-            ball.position = { 0.8f, 1.2f, 0.3f }; // 初期位置に戻す
-            ball.velocity = { 0.0f, 0.0f, 0.0f }; // 初期速度に戻す
+            ballSystem.Set(0, ball); // 初期位置と初期速度に戻す
         }
 
         ImGui::End();
 
+        // 数学ライブラリのベンチマーク
+        DrawMathBenchmarkWindow();
+
 #pragma endregion
 
         // 平面の描画
-        DrawPlane(plane, viewProjectionMatrix, viewPortMatrix, WHITE);
+        DrawPlane(plane, projector, WHITE);
 
         // ボールの描画
-        DrawSphere(
-            Sphere { ball.position, ball.radius },
-            viewProjectionMatrix, viewPortMatrix, ball.color);
+        for (size_t i = 0; i < ballSystem.Size(); ++i) {
+            Sphere ballSphere = { ballSystem.GetPositions().Get(i), ballSystem.GetRadii()[i] };
+            if (IsCollision(ballSphere, frustum)) {
+                DrawSphere(ballSphere, projector, ballSystem.GetColors()[i]);
+            }
+        }
 
         // グリッド線
-        DrawGrid(viewProjectionMatrix, viewPortMatrix);
+        DrawGrid(projector);
 
         ///
         /// ↑描画処理ここまで
@@ -332,7 +343,7 @@ Vector3 perpendicular(const Vector3& vector)
     return { 0.0f, -vector.z, vector.y };
 }
 
-void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+void DrawPlane(const Plane& plane, const ScreenProjector& projector, uint32_t color)
 {
     Vector3 center = Multiply(plane.distance, plane.normal); // 1
     Vector3 perpendiculars[4];
@@ -346,39 +357,22 @@ void DrawPlane(const Plane& plane, const Matrix4x4& viewProjectionMatrix, const
     Vector3 points[4];
     for (int32_t index = 0; index < 4; ++index) {
         Vector3 extend = Multiply(2.0f, perpendiculars[index]);
-        Vector3 point = Add(center, extend);
-        points[index] = TransformCoord(TransformCoord(point, viewProjectionMatrix), viewportMatrix);
+        points[index] = Add(center, extend);
     }
 
-    Novice::DrawLine(
-        int(points[0].x), int(points[0].y), int(points[2].x), int(points[2].y), color);
-
-    Novice::DrawLine(
-        int(points[2].x), int(points[2].y), int(points[1].x), int(points[1].y), color);
-
-    Novice::DrawLine(
-        int(points[1].x), int(points[1].y), int(points[3].x), int(points[3].y), color);
-
-    Novice::DrawLine(
-        int(points[3].x), int(points[3].y), int(points[0].x), int(points[0].y), color);
+    static const uint32_t kIndices[] = { 0, 2, 2, 1, 1, 3, 3, 0 };
+    projector.DrawLines(points, kIndices, color);
 }
 
 // 三角形の描画
-void DrawTriangle(const Triangle& triangle, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+void DrawTriangle(const Triangle& triangle, const ScreenProjector& projector, uint32_t color)
 {
-    Vector3 points[3];
-
-    for (int i = 0; i < 3; ++i) {
-        points[i] = TransformCoord(TransformCoord(triangle.vertices[i], viewProjectionMatrix), viewportMatrix);
-    }
-
-    Novice::DrawLine((int)points[0].x, (int)points[0].y, (int)points[1].x, (int)points[1].y, color);
-    Novice::DrawLine((int)points[1].x, (int)points[1].y, (int)points[2].x, (int)points[2].y, color);
-    Novice::DrawLine((int)points[2].x, (int)points[2].y, (int)points[0].x, (int)points[0].y, color);
+    static const uint32_t kIndices[] = { 0, 1, 1, 2, 2, 0 };
+    projector.DrawLines(triangle.vertices, kIndices, color);
 }
 
 // AABBの描画
-void DrawAABB(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+void DrawAABB(const AABB& aabb, const ScreenProjector& projector, uint32_t color)
 {
     // 1) ８頂点を world 空間で用意
     Vector3 corners[8] = {
@@ -392,69 +386,34 @@ void DrawAABB(const AABB& aabb, const Matrix4x4& viewProjectionMatrix, const Mat
         { aabb.min.x, aabb.max.y, aabb.max.z } // 7
     };
 
-    // 2) 各頂点をクリップ→スクリーン座標に変換
-    Vector3 pts[8];
-    for (int i = 0; i < 8; ++i) {
-        // ビュー→プロジェクション→ビューポート の順で呼び出す
-        pts[i] = TransformCoord(
-            TransformCoord(corners[i], viewProjectionMatrix),
-            viewportMatrix);
-    }
-
-    // 3) 底面（0-1-2-3）
-    Novice::DrawLine((int)pts[0].x, (int)pts[0].y, (int)pts[1].x, (int)pts[1].y, color);
-    Novice::DrawLine((int)pts[1].x, (int)pts[1].y, (int)pts[2].x, (int)pts[2].y, color);
-    Novice::DrawLine((int)pts[2].x, (int)pts[2].y, (int)pts[3].x, (int)pts[3].y, color);
-    Novice::DrawLine((int)pts[3].x, (int)pts[3].y, (int)pts[0].x, (int)pts[0].y, color);
-
-    // 4) 上面（4-5-6-7）
-    Novice::DrawLine((int)pts[4].x, (int)pts[4].y, (int)pts[5].x, (int)pts[5].y, color);
-    Novice::DrawLine((int)pts[5].x, (int)pts[5].y, (int)pts[6].x, (int)pts[6].y, color);
-    Novice::DrawLine((int)pts[6].x, (int)pts[6].y, (int)pts[7].x, (int)pts[7].y, color);
-    Novice::DrawLine((int)pts[7].x, (int)pts[7].y, (int)pts[4].x, (int)pts[4].y, color);
-
-    // 5) 側面のエッジ（0-4, 1-5, 2-6, 3-7）
-    Novice::DrawLine((int)pts[0].x, (int)pts[0].y, (int)pts[4].x, (int)pts[4].y, color);
-    Novice::DrawLine((int)pts[1].x, (int)pts[1].y, (int)pts[5].x, (int)pts[5].y, color);
-    Novice::DrawLine((int)pts[2].x, (int)pts[2].y, (int)pts[6].x, (int)pts[6].y, color);
-    Novice::DrawLine((int)pts[3].x, (int)pts[3].y, (int)pts[7].x, (int)pts[7].y, color);
+    // 2) 12本の辺(頂点は1回ずつ射影し、カメラの後ろにまたがる辺はクリッピング)
+    static const uint32_t kIndices[] = {
+        0, 1, 1, 2, 2, 3, 3, 0, // 底面（0-1-2-3）
+        4, 5, 5, 6, 6, 7, 7, 4, // 上面（4-5-6-7）
+        0, 4, 1, 5, 2, 6, 3, 7 // 側面のエッジ
+    };
+    projector.DrawLines(corners, kIndices, color);
 }
 
 // 2次ベジェ曲線の描画
-void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPosint2, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, uint32_t color)
+void DrawBezier(const Vector3& controlPoint0, const Vector3& controlPoint1, const Vector3& controlPosint2, const ScreenProjector& projector, uint32_t color)
 {
-    const int kSegmentCount = 20; // 分割数
-
-    for (int i = 0; i < kSegmentCount; ++i) {
-        float t0 = static_cast<float>(i) / static_cast<float>(kSegmentCount);
-        float t1 = static_cast<float>(i + 1) / static_cast<float>(kSegmentCount);
-
-        // 線形補間を使ってベジェ曲線の2点を計算
-        Vector3 p0p1 = Lerp(controlPoint0, controlPoint1, t0);
-        Vector3 p1p2 = Lerp(controlPoint1, controlPosint2, t0);
-        Vector3 p = Lerp(p0p1, p1p2, t0);
-
-        Vector3 p0p1Next = Lerp(controlPoint0, controlPoint1, t1);
-        Vector3 p1p2Next = Lerp(controlPoint1, controlPosint2, t1);
-        Vector3 pNext = Lerp(p0p1Next, p1p2Next, t1);
-
-        // ベジェ曲線の2点をスクリーン座標に変換
-        Vector3 screeenP0 = TransformCoord(TransformCoord(p, viewProjectionMatrix), viewportMatrix);
-        Vector3 screeenP1 = TransformCoord(TransformCoord(pNext, viewProjectionMatrix), viewportMatrix);
-
-        // 線を描画
-        Novice::DrawLine(
-            static_cast<int>(screeenP0.x), static_cast<int>(screeenP0.y),
-            static_cast<int>(screeenP1.x), static_cast<int>(screeenP1.y),
-            color);
+    const uint32_t kMaxSegmentCount = 20; // 最大の分割数
+
+    // 画面上の曲がり具合から分割数を選ぶ
+    uint32_t segmentCount = projector.SelectBezierSegmentCount(controlPoint0, controlPoint1, controlPosint2, kMaxSegmentCount);
+
+    // 曲線上の点を先にまとめて計算し、各点を1回だけ射影する
+    Vector3 points[kMaxSegmentCount + 1];
+    for (uint32_t i = 0; i <= segmentCount; ++i) {
+        float t = static_cast<float>(i) / static_cast<float>(segmentCount);
+
+        // 線形補間を使ってベジェ曲線の点を計算
+        Vector3 p0p1 = Lerp(controlPoint0, controlPoint1, t);
+        Vector3 p1p2 = Lerp(controlPoint1, controlPosint2, t);
+        points[i] = Lerp(p0p1, p1p2, t);
     }
-}
 
-Vector3 Reflect(const Vector3& input, const Vector3& normal)
-{
-    // 入力ベクトルを正規化
-    Vector3 normalizedNormal = Normalize(normal);
-    // 入力ベクトルと法線ベクトルの内積を計算
-    float dotIn = Dot(input, normalizedNormal);
-    return Subtract(input, Multiply(2.0f * dotIn, normalizedNormal));
+    // 線を描画
+    projector.DrawLineStrip(std::span<const Vector3>(points, segmentCount + 1), color);
 }